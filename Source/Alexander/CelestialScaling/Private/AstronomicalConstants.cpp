@@ -130,6 +130,14 @@ float UAstronomicalConstantsLibrary::CalculateEscapeVelocity(double Mass, double
 	return static_cast<float>(Velocity);
 }
 
+FKeplerOrbitElements UAstronomicalConstantsLibrary::MakeCircularOrbitElements(const FCelestialBodyData& BodyData, double InitialMeanAnomaly)
+{
+	FKeplerOrbitElements Elements;
+	Elements.SemiMajorAxis = BodyData.OrbitalRadius * 100000.0; // km to cm
+	Elements.MeanAnomalyAtEpoch = InitialMeanAnomaly;
+	return Elements;
+}
+
 bool UAstronomicalConstantsLibrary::IsValidScaleFactor(float ScaleFactor)
 {
 	return ScaleFactor >= CelestialScalingConstants::MinScaleFactor && 
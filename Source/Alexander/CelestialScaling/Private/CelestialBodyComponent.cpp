@@ -6,14 +6,17 @@
 #include "DrawDebugHelpers.h"
 #include "Engine/World.h"
 #include "CelestialBodyRegistry.h"
+#include "GravitySimulator.h"
+#include "GravityDebugRenderer.h"
 
 UCelestialBodyComponent::UCelestialBodyComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
 	SetIsReplicatedByDefault(true);
 
-	Mass = 5.972e24f;
+	Mass = 5.972e24;
 	Radius = 6371.0f;
+	AtmosphereHeight = 0.0f;
 	CurrentScaleFactor = 1.0f;
 	TargetScaleFactor = 1.0f;
 	DistanceToPlayer = 0.0f;
@@ -26,6 +29,11 @@ UCelestialBodyComponent::UCelestialBodyComponent()
 	bEnableGravity = true;
 	GravityMultiplier = 1.0f;
 
+	bSimulateOrbit = false;
+	InitialVelocity = FVector::ZeroVector;
+	bOnRails = false;
+	OrbitParentID = NAME_None;
+
 	CurrentLODLevel = 0;
 	bShowDebugInfo = false;
 	bIsRegistered = false;
@@ -114,42 +122,42 @@ void UCelestialBodyComponent::SmoothScaleTransition(float DeltaTime)
 
 FVector UCelestialBodyComponent::CalculateGravitationalForce(const FVector& TargetPosition, float TargetMass) const
 {
-	if (!bEnableGravity || Mass <= 0.0f || TargetMass <= 0.0f) return FVector::ZeroVector;
+	if (!bEnableGravity || Mass <= 0.0 || TargetMass <= 0.0f) return FVector::ZeroVector;
 
 	AActor* Owner = GetOwner();
 	if (!Owner) return FVector::ZeroVector;
 
 	FVector Direction = Owner->GetActorLocation() - TargetPosition;
-	float DistanceCm = Direction.Size();
+	const double DistanceCm = Direction.Size();
 	if (DistanceCm < KINDA_SMALL_NUMBER) return FVector::ZeroVector;
 
 	Direction.Normalize();
-	float DistanceMeters = DistanceCm / 100.0f;
+	const double DistanceMeters = DistanceCm / 100.0;
 
 	double ForceMagnitude = (GravitationalConstant * Mass * TargetMass) / (DistanceMeters * DistanceMeters);
 	ForceMagnitude *= GravityMultiplier;
 
-	return Direction * static_cast<float>(ForceMagnitude);
+	return Direction * ForceMagnitude;
 }
 
 FVector UCelestialBodyComponent::CalculateGravitationalAcceleration(const FVector& Position) const
 {
-	if (!bEnableGravity || Mass <= 0.0f) return FVector::ZeroVector;
+	if (!bEnableGravity || Mass <= 0.0) return FVector::ZeroVector;
 
 	AActor* Owner = GetOwner();
 	if (!Owner) return FVector::ZeroVector;
 
 	FVector Direction = Owner->GetActorLocation() - Position;
-	float DistanceCm = Direction.Size();
+	const double DistanceCm = Direction.Size();
 	if (DistanceCm < KINDA_SMALL_NUMBER) return FVector::ZeroVector;
 
 	Direction.Normalize();
-	float DistanceMeters = DistanceCm / 100.0f;
+	const double DistanceMeters = DistanceCm / 100.0;
 
 	double AccelerationMagnitude = (GravitationalConstant * Mass) / (DistanceMeters * DistanceMeters);
 	AccelerationMagnitude *= GravityMultiplier;
 
-	return Direction * static_cast<float>(AccelerationMagnitude);
+	return Direction * AccelerationMagnitude;
 }
 
 void UCelestialBodyComponent::UpdateLODSystem()
@@ -183,12 +191,17 @@ void UCelestialBodyComponent::DrawDebugVisualization()
 	UWorld* World = GetWorld();
 	if (!World) return;
 
+	// Queue on the gravity simulator's budgeted renderer; it batches every body's lines into one submission
+	UGravitySimulator* Simulator = World->GetSubsystem<UGravitySimulator>();
+	FGravityDebugRenderer* DebugRenderer = Simulator ? Simulator->GetDebugRenderer() : nullptr;
+	if (!DebugRenderer) return;
+
 	FVector BodyPosition = Owner->GetActorLocation();
-	float DebugRadius = Radius * 100.0f * CurrentScaleFactor;
-	DrawDebugSphere(World, BodyPosition, DebugRadius, 16, FColor::Cyan, false, -1.0f, 0, 2.0f);
+	float DebugRadius = GetWorldRadius();
+	DebugRenderer->AddSphere(BodyPosition, DebugRadius, FColor::Cyan, 2.0f);
 
 	FString DebugText = FString::Printf(TEXT("%s\nScale: %.3f\nDist: %.0f km"), *BodyID.ToString(), CurrentScaleFactor, DistanceToPlayer);
-	DrawDebugString(World, BodyPosition + FVector(0, 0, DebugRadius + 100.0f), DebugText, nullptr, FColor::White, 0.0f, true);
+	DebugRenderer->AddLabel(BodyPosition + FVector(0, 0, DebugRadius + 100.0f), DebugText, FColor::White);
 }
 
 FString UCelestialBodyComponent::GetStatusInfo() const
@@ -0,0 +1,366 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CelestialBodyOctree.h"
+
+namespace
+{
+	/** Root cell size relative to the body bounds, so bodies can spread out before a rebuild is needed */
+	constexpr double RootHeadroom = 2.0;
+
+	/** Rebuild once empty leaves left behind by moving bodies outnumber bodies by this factor */
+	constexpr int32 MaxNodesPerBody = 16;
+
+	int32 GetOctant(const FVector& Center, const FVector& Position)
+	{
+		return (Position.X >= Center.X ? 1 : 0) | (Position.Y >= Center.Y ? 2 : 0) | (Position.Z >= Center.Z ? 4 : 0);
+	}
+
+	/** Node awaiting a visit in a nearest query */
+	struct FQueuedNode
+	{
+		double DistanceSquared;
+		int32 Node;
+	};
+
+	/** Candidate result of a nearest query */
+	struct FNearestCandidate
+	{
+		double DistanceSquared;
+		int32 Element;
+	};
+}
+
+void FCelestialBodyOctree::Add(UCelestialBodyComponent* Body, const FVector& Position)
+{
+	if (!Body || ElementIndices.Contains(Body))
+	{
+		return;
+	}
+
+	const int32 ElementIndex = Elements.Num();
+	FElement& Element = Elements.AddDefaulted_GetRef();
+	Element.Body = Body;
+	Element.Position = Position;
+	ElementIndices.Add(Body, ElementIndex);
+
+	if (Nodes.Num() == 0 || !IsInside(Nodes[0], Position, 1.0))
+	{
+		Rebuild();
+	}
+	else
+	{
+		Insert(ElementIndex);
+	}
+}
+
+void FCelestialBodyOctree::Remove(const UCelestialBodyComponent* Body)
+{
+	int32 ElementIndex;
+	if (!ElementIndices.RemoveAndCopyValue(Body, ElementIndex))
+	{
+		return;
+	}
+
+	Unlink(ElementIndex);
+	Elements.RemoveAtSwap(ElementIndex, 1, EAllowShrinking::No);
+
+	// Point the leaf and the lookup at the element swapped into the hole
+	if (Elements.IsValidIndex(ElementIndex))
+	{
+		const FElement& Moved = Elements[ElementIndex];
+		Nodes[Moved.Node].Elements[Moved.Slot] = ElementIndex;
+		ElementIndices.Add(Moved.Body, ElementIndex);
+	}
+
+	if (Elements.Num() == 0)
+	{
+		Nodes.Reset();
+	}
+}
+
+void FCelestialBodyOctree::Reset()
+{
+	Nodes.Reset();
+	Elements.Reset();
+	ElementIndices.Reset();
+}
+
+void FCelestialBodyOctree::Refit(TFunctionRef<bool(const UCelestialBodyComponent* Body, FVector& OutPosition)> GetPosition)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FCelestialBodyOctree::Refit);
+
+	if (Nodes.Num() == 0)
+	{
+		return;
+	}
+
+	bool bLeftRoot = false;
+	for (FElement& Element : Elements)
+	{
+		GetPosition(Element.Body, Element.Position);
+		bLeftRoot |= !IsInside(Nodes[0], Element.Position, 1.0);
+	}
+
+	if (bLeftRoot || Nodes.Num() > MaxNodesPerBody * Elements.Num())
+	{
+		Rebuild();
+		return;
+	}
+
+	// Only bodies that drifted out of their leaf's loose bounds move
+	for (int32 ElementIndex = 0; ElementIndex < Elements.Num(); ++ElementIndex)
+	{
+		if (!IsInside(Nodes[Elements[ElementIndex].Node], Elements[ElementIndex].Position, Looseness))
+		{
+			Unlink(ElementIndex);
+			Insert(ElementIndex);
+		}
+	}
+}
+
+void FCelestialBodyOctree::Translate(const FVector& Offset)
+{
+	for (FNode& Node : Nodes)
+	{
+		Node.Center += Offset;
+	}
+
+	for (FElement& Element : Elements)
+	{
+		Element.Position += Offset;
+	}
+}
+
+void FCelestialBodyOctree::FindInRange(const FVector& Point, double Radius, TArray<UCelestialBodyComponent*>& OutBodies) const
+{
+	if (Nodes.Num() == 0)
+	{
+		return;
+	}
+
+	const double RadiusSquared = Radius * Radius;
+
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Add(0);
+
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = Nodes[Stack.Pop(EAllowShrinking::No)];
+		if (GetLooseDistanceSquared(Node, Point) > RadiusSquared)
+		{
+			continue;
+		}
+
+		if (Node.FirstChild == INDEX_NONE)
+		{
+			for (const int32 ElementIndex : Node.Elements)
+			{
+				if (FVector::DistSquared(Elements[ElementIndex].Position, Point) <= RadiusSquared)
+				{
+					OutBodies.Add(Elements[ElementIndex].Body);
+				}
+			}
+			continue;
+		}
+
+		for (int32 Child = 0; Child < 8; ++Child)
+		{
+			Stack.Add(Node.FirstChild + Child);
+		}
+	}
+}
+
+void FCelestialBodyOctree::FindNearest(const FVector& Point, int32 Count, TFunctionRef<bool(const UCelestialBodyComponent* Body)> Filter,
+	TArray<UCelestialBodyComponent*>& OutBodies) const
+{
+	if (Nodes.Num() == 0 || Count <= 0)
+	{
+		return;
+	}
+
+	// Nodes closest first; results kept as a max-heap so the current k-th distance is at the top
+	auto NodeCloser = [](const FQueuedNode& A, const FQueuedNode& B) { return A.DistanceSquared < B.DistanceSquared; };
+	auto CandidateFarther = [](const FNearestCandidate& A, const FNearestCandidate& B) { return A.DistanceSquared > B.DistanceSquared; };
+
+	TArray<FQueuedNode, TInlineAllocator<64>> Queue;
+	TArray<FNearestCandidate, TInlineAllocator<16>> Best;
+	Queue.HeapPush({ GetLooseDistanceSquared(Nodes[0], Point), 0 }, NodeCloser);
+
+	while (Queue.Num() > 0)
+	{
+		FQueuedNode Next;
+		Queue.HeapPop(Next, NodeCloser, EAllowShrinking::No);
+
+		// No remaining node can hold anything closer than the k-th result
+		if (Best.Num() == Count && Next.DistanceSquared >= Best.HeapTop().DistanceSquared)
+		{
+			break;
+		}
+
+		const FNode& Node = Nodes[Next.Node];
+		if (Node.FirstChild == INDEX_NONE)
+		{
+			for (const int32 ElementIndex : Node.Elements)
+			{
+				const double DistanceSquared = FVector::DistSquared(Elements[ElementIndex].Position, Point);
+				if (Best.Num() == Count && DistanceSquared >= Best.HeapTop().DistanceSquared)
+				{
+					continue;
+				}
+
+				if (!Filter(Elements[ElementIndex].Body))
+				{
+					continue;
+				}
+
+				if (Best.Num() < Count)
+				{
+					Best.HeapPush({ DistanceSquared, ElementIndex }, CandidateFarther);
+				}
+				else
+				{
+					Best.HeapPopDiscard(CandidateFarther, EAllowShrinking::No);
+					Best.HeapPush({ DistanceSquared, ElementIndex }, CandidateFarther);
+				}
+			}
+			continue;
+		}
+
+		for (int32 Child = 0; Child < 8; ++Child)
+		{
+			const int32 ChildIndex = Node.FirstChild + Child;
+			const double DistanceSquared = GetLooseDistanceSquared(Nodes[ChildIndex], Point);
+
+			if (Best.Num() < Count || DistanceSquared < Best.HeapTop().DistanceSquared)
+			{
+				Queue.HeapPush({ DistanceSquared, ChildIndex }, NodeCloser);
+			}
+		}
+	}
+
+	Best.Sort([](const FNearestCandidate& A, const FNearestCandidate& B) { return A.DistanceSquared < B.DistanceSquared; });
+
+	OutBodies.Reserve(OutBodies.Num() + Best.Num());
+	for (const FNearestCandidate& Candidate : Best)
+	{
+		OutBodies.Add(Elements[Candidate.Element].Body);
+	}
+}
+
+void FCelestialBodyOctree::Rebuild()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FCelestialBodyOctree::Rebuild);
+
+	Nodes.Reset();
+	if (Elements.Num() == 0)
+	{
+		return;
+	}
+
+	FBox Bounds(ForceInit);
+	for (const FElement& Element : Elements)
+	{
+		Bounds += Element.Position;
+	}
+
+	FNode& Root = Nodes.AddDefaulted_GetRef();
+	Root.Center = Bounds.GetCenter();
+	Root.HalfSize = FMath::Max(Bounds.GetExtent().GetMax(), 1.0) * RootHeadroom;
+
+	for (int32 ElementIndex = 0; ElementIndex < Elements.Num(); ++ElementIndex)
+	{
+		Elements[ElementIndex].Node = INDEX_NONE;
+		Insert(ElementIndex);
+	}
+}
+
+void FCelestialBodyOctree::Insert(int32 ElementIndex)
+{
+	// Every element lies inside the root cell, so descending by octant always ends in a leaf whose cell contains it
+	const FVector& Position = Elements[ElementIndex].Position;
+
+	int32 NodeIndex = 0;
+	while (Nodes[NodeIndex].FirstChild != INDEX_NONE)
+	{
+		NodeIndex = Nodes[NodeIndex].FirstChild + GetOctant(Nodes[NodeIndex].Center, Position);
+	}
+
+	Link(ElementIndex, NodeIndex);
+
+	if (Nodes[NodeIndex].Elements.Num() > MaxLeafBodies && Nodes[NodeIndex].Depth < MaxDepth)
+	{
+		Split(NodeIndex);
+	}
+}
+
+void FCelestialBodyOctree::Link(int32 ElementIndex, int32 NodeIndex)
+{
+	Elements[ElementIndex].Node = NodeIndex;
+	Elements[ElementIndex].Slot = Nodes[NodeIndex].Elements.Add(ElementIndex);
+}
+
+void FCelestialBodyOctree::Unlink(int32 ElementIndex)
+{
+	FElement& Element = Elements[ElementIndex];
+	if (Element.Node == INDEX_NONE)
+	{
+		return;
+	}
+
+	TArray<int32>& LeafElements = Nodes[Element.Node].Elements;
+	LeafElements.RemoveAtSwap(Element.Slot, 1, EAllowShrinking::No);
+
+	if (LeafElements.IsValidIndex(Element.Slot))
+	{
+		Elements[LeafElements[Element.Slot]].Slot = Element.Slot;
+	}
+
+	Element.Node = INDEX_NONE;
+	Element.Slot = INDEX_NONE;
+}
+
+void FCelestialBodyOctree::Split(int32 NodeIndex)
+{
+	const int32 FirstChild = Nodes.Num();
+	const FVector Center = Nodes[NodeIndex].Center;
+	const double ChildHalfSize = Nodes[NodeIndex].HalfSize * 0.5;
+	const int32 ChildDepth = Nodes[NodeIndex].Depth + 1;
+
+	// Adding children may reallocate Nodes; no references are held across this loop
+	for (int32 Octant = 0; Octant < 8; ++Octant)
+	{
+		FNode& Child = Nodes.AddDefaulted_GetRef();
+		Child.Center = Center + FVector(Octant & 1 ? ChildHalfSize : -ChildHalfSize, Octant & 2 ? ChildHalfSize : -ChildHalfSize,
+			Octant & 4 ? ChildHalfSize : -ChildHalfSize);
+		Child.HalfSize = ChildHalfSize;
+		Child.Depth = ChildDepth;
+	}
+
+	TArray<int32> Moved = MoveTemp(Nodes[NodeIndex].Elements);
+	Nodes[NodeIndex].Elements.Reset();
+	Nodes[NodeIndex].FirstChild = FirstChild;
+
+	// Elements that had drifted outside this cell land in their proper leaf elsewhere
+	for (const int32 ElementIndex : Moved)
+	{
+		Elements[ElementIndex].Node = INDEX_NONE;
+		Insert(ElementIndex);
+	}
+}
+
+double FCelestialBodyOctree::GetLooseDistanceSquared(const FNode& Node, const FVector& Point)
+{
+	const double Extent = Node.HalfSize * Looseness;
+	const double DX = FMath::Max(FMath::Abs(Point.X - Node.Center.X) - Extent, 0.0);
+	const double DY = FMath::Max(FMath::Abs(Point.Y - Node.Center.Y) - Extent, 0.0);
+	const double DZ = FMath::Max(FMath::Abs(Point.Z - Node.Center.Z) - Extent, 0.0);
+	return DX * DX + DY * DY + DZ * DZ;
+}
+
+bool FCelestialBodyOctree::IsInside(const FNode& Node, const FVector& Position, double Scale)
+{
+	const double Extent = Node.HalfSize * Scale;
+	return FMath::Abs(Position.X - Node.Center.X) <= Extent
+		&& FMath::Abs(Position.Y - Node.Center.Y) <= Extent
+		&& FMath::Abs(Position.Z - Node.Center.Z) <= Extent;
+}
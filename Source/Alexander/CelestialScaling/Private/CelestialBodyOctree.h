@@ -0,0 +1,112 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+class UCelestialBodyComponent;
+
+/**
+ * Loose octree over registered body positions for range and nearest queries
+ * Bodies live in leaves; a leaf accepts bodies anywhere within its cell grown by Looseness, so a
+ * body that drifts a little past its cell stays where it is on refit and only bodies that leave
+ * the grown cell are reinserted. Range queries visit only nodes whose grown cell touches the
+ * sphere, and nearest queries walk nodes closest first and stop once no node can beat the
+ * current k-th result.
+ * Not thread-safe; the registry guards it with its lock.
+ */
+class FCelestialBodyOctree
+{
+public:
+	/** Bodies stored in a leaf before it is split */
+	static constexpr int32 MaxLeafBodies = 8;
+
+	/** Depth limit guarding against coincident bodies */
+	static constexpr int32 MaxDepth = 16;
+
+	/** Factor a leaf's cell is grown by when testing whether a body still belongs to it */
+	static constexpr double Looseness = 1.5;
+
+	/** Add a body at Position (no-op if already indexed) */
+	void Add(UCelestialBodyComponent* Body, const FVector& Position);
+
+	void Remove(const UCelestialBodyComponent* Body);
+
+	void Reset();
+
+	/**
+	 * Re-read every body's position and move the ones that left their leaf
+	 * Rebuilds from scratch when a body leaves the root cell
+	 * @param GetPosition - Current position of a body; return false to leave the body where it is
+	 */
+	void Refit(TFunctionRef<bool(const UCelestialBodyComponent* Body, FVector& OutPosition)> GetPosition);
+
+	/** Shift every body and cell by the same offset (origin rebasing) without restructuring */
+	void Translate(const FVector& Offset);
+
+	/** Bodies within Radius of Point, in no particular order */
+	void FindInRange(const FVector& Point, double Radius, TArray<UCelestialBodyComponent*>& OutBodies) const;
+
+	/**
+	 * Up to Count bodies nearest to Point, nearest first
+	 * @param Filter - Return false to skip a body; skipped bodies do not take up one of the Count results
+	 */
+	void FindNearest(const FVector& Point, int32 Count, TFunctionRef<bool(const UCelestialBodyComponent* Body)> Filter,
+		TArray<UCelestialBodyComponent*>& OutBodies) const;
+
+	int32 GetNumBodies() const { return Elements.Num(); }
+	int32 GetNumNodes() const { return Nodes.Num(); }
+
+private:
+	struct FElement
+	{
+		UCelestialBodyComponent* Body = nullptr;
+		FVector Position = FVector::ZeroVector;
+
+		/** Leaf holding the element and the element's slot in that leaf */
+		int32 Node = INDEX_NONE;
+		int32 Slot = INDEX_NONE;
+	};
+
+	struct FNode
+	{
+		FVector Center = FVector::ZeroVector;
+		double HalfSize = 0.0;
+
+		/** First of eight contiguous children, INDEX_NONE for leaves */
+		int32 FirstChild = INDEX_NONE;
+
+		/** Element indices stored in a leaf */
+		TArray<int32> Elements;
+
+		int32 Depth = 0;
+	};
+
+	/** Rebuild the tree around the current element positions */
+	void Rebuild();
+
+	/** Place an element into the leaf whose cell contains it, splitting full leaves */
+	void Insert(int32 ElementIndex);
+
+	/** Put an element into a leaf */
+	void Link(int32 ElementIndex, int32 NodeIndex);
+
+	/** Take an element out of its leaf */
+	void Unlink(int32 ElementIndex);
+
+	/** Turn a leaf into eight children and redistribute its elements */
+	void Split(int32 NodeIndex);
+
+	/** Squared distance from a point to a node's loose bounds (0 inside) */
+	static double GetLooseDistanceSquared(const FNode& Node, const FVector& Point);
+
+	/** Whether a position lies in a node's cell grown by Scale (1 for the cell itself, Looseness for the loose bounds) */
+	static bool IsInside(const FNode& Node, const FVector& Position, double Scale);
+
+	TArray<FNode> Nodes;
+	TArray<FElement> Elements;
+
+	/** Body to element index lookup */
+	TMap<const UCelestialBodyComponent*, int32> ElementIndices;
+};
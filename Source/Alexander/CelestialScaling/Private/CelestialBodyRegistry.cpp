@@ -2,21 +2,52 @@
 
 #include "CelestialBodyRegistry.h"
 #include "CelestialBodyComponent.h"
+#include "CelestialBodyOctree.h"
+#include "GravityStats.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
 #include "Engine/World.h"
 #include "DrawDebugHelpers.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+	/** Unreal units (cm) per kilometer */
+	constexpr double UnrealUnitsPerKilometer = 100000.0;
+
+	/** Apparent size ratio between neighbouring update priorities */
+	constexpr double PriorityApparentSizeStep = 0.1;
+}
 
 void UCelestialBodyRegistry::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
 
 	RegisteredBodies.Empty();
+	RegisteredBodySlots.Empty();
+	BodySlots.Empty();
+	FreeBodySlots.Empty();
+	BodySlotLookup.Empty();
 	BodyLookup.Empty();
+	RegistryGeneration = 0;
+	SpatialIndex = MakeShared<FCelestialBodyOctree>();
+	SpatialIndexFrame = 0;
 	bAutoUpdateEnabled = true;
 	AutoUpdateFrequency = 0.1f; // Update every 0.1 seconds
-	TimeSinceLastUpdate = 0.0f;
 	MaxBodiesPerFrame = 100;
+	ScaleUpdateBudgetMs = 0.25f;
+	ScaleUpdateIntervalGrowth = 4.0f; // High 0.1s, Medium 0.4s, Low 1.6s, Minimal 6.4s
+	CriticalApparentSize = 0.05f; // Within 20 radii
 	bEnableDebugLogging = false;
 
+	ScaleUpdateEntries.Reset();
+	for (int32 Priority = 0; Priority < NumUpdatePriorities; ++Priority)
+	{
+		ScaleUpdateBins[Priority].Reset();
+		ScaleUpdateCursors[Priority] = 0;
+	}
+	ScheduledBodyList.Reset();
+
 	UE_LOG(LogTemp, Log, TEXT("CelestialBodyRegistry: Initialized"));
 }
 
@@ -25,9 +56,21 @@ void UCelestialBodyRegistry::Deinitialize()
 	// Clear all registered bodies
 	{
 		FScopeLock Lock(&RegistryLock);
-		RegisteredBodies.Empty();
+		ReleaseAllBodySlots();
 		BodyLookup.Empty();
+		SpatialIndex.Reset();
+		++RegistryGeneration;
+
+		FScopeLock ListLock(&BodyListLock);
+		PublishedBodyList.Reset();
+	}
+
+	ScaleUpdateEntries.Empty();
+	for (TArray<int32>& Bin : ScaleUpdateBins)
+	{
+		Bin.Empty();
 	}
+	ScheduledBodyList.Reset();
 
 	UE_LOG(LogTemp, Log, TEXT("CelestialBodyRegistry: Deinitialized"));
 
@@ -47,6 +90,35 @@ void UCelestialBodyRegistry::OnWorldBeginPlay(UWorld& InWorld)
 		RegisteredBodies.Num());
 }
 
+void UCelestialBodyRegistry::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bAutoUpdateEnabled || RegisteredBodies.Num() == 0)
+	{
+		return;
+	}
+
+	// Scale against the local player's camera; without a player there is nobody to scale for
+	UWorld* World = GetWorld();
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	if (!PlayerController)
+	{
+		return;
+	}
+
+	FVector ViewOrigin;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewOrigin, ViewRotation);
+
+	UpdateBodyScales(ViewOrigin);
+}
+
+TStatId UCelestialBodyRegistry::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCelestialBodyRegistry, STATGROUP_Gravity);
+}
+
 // ========== Body Registration (Thread-Safe) ==========
 
 void UCelestialBodyRegistry::RegisterCelestialBody(UCelestialBodyComponent* Body)
@@ -60,7 +132,7 @@ void UCelestialBodyRegistry::RegisterCelestialBody(UCelestialBodyComponent* Body
 	FScopeLock Lock(&RegistryLock);
 
 	// Check if already registered
-	if (RegisteredBodies.Contains(Body))
+	if (BodySlotLookup.Contains(Body))
 	{
 		if (bEnableDebugLogging)
 		{
@@ -70,9 +142,22 @@ void UCelestialBodyRegistry::RegisterCelestialBody(UCelestialBodyComponent* Body
 		return;
 	}
 
-	// Add to array and lookup map
-	RegisteredBodies.Add(Body);
+	// Take a free slot (its generation already moved past any old handles) and append to the dense array
+	const int32 SlotIndex = FreeBodySlots.Num() > 0 ? FreeBodySlots.Pop(EAllowShrinking::No) : BodySlots.AddDefaulted();
+	FCelestialBodySlot& Slot = BodySlots[SlotIndex];
+	Slot.Body = Body;
+	Slot.DenseIndex = RegisteredBodies.Add(Body);
+	RegisteredBodySlots.Add(SlotIndex);
+	BodySlotLookup.Add(Body, SlotIndex);
+
 	BodyLookup.Add(Body->GetBodyName(), Body);
+	++RegistryGeneration;
+
+	if (SpatialIndex.IsValid())
+	{
+		const AActor* Owner = Body->GetOwner();
+		SpatialIndex->Add(Body, Owner ? Owner->GetActorLocation() : FVector::ZeroVector);
+	}
 
 	if (bEnableDebugLogging)
 	{
@@ -93,22 +178,98 @@ void UCelestialBodyRegistry::UnregisterCelestialBody(UCelestialBodyComponent* Bo
 	// Remove from lookup map
 	BodyLookup.Remove(Body->GetBodyName());
 
-	// Remove from array
-	int32 RemovedCount = RegisteredBodies.Remove(Body);
+	// Swap the last body into the hole and retire the slot
+	int32 SlotIndex;
+	const bool bRemoved = BodySlotLookup.RemoveAndCopyValue(Body, SlotIndex);
+	if (bRemoved)
+	{
+		FCelestialBodySlot& Slot = BodySlots[SlotIndex];
+		const int32 DenseIndex = Slot.DenseIndex;
+
+		RegisteredBodies.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+		RegisteredBodySlots.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+		if (RegisteredBodySlots.IsValidIndex(DenseIndex))
+		{
+			BodySlots[RegisteredBodySlots[DenseIndex]].DenseIndex = DenseIndex;
+		}
+
+		Slot.Body = nullptr;
+		Slot.DenseIndex = INDEX_NONE;
+		++Slot.Generation;
+		FreeBodySlots.Add(SlotIndex);
+
+		++RegistryGeneration;
+	}
 
-	if (bEnableDebugLogging && RemovedCount > 0)
+	if (SpatialIndex.IsValid())
+	{
+		SpatialIndex->Remove(Body);
+	}
+
+	if (bEnableDebugLogging && bRemoved)
 	{
 		UE_LOG(LogTemp, Log, TEXT("CelestialBodyRegistry: Unregistered body '%s' (Total: %d)"),
 			*Body->GetBodyName().ToString(), RegisteredBodies.Num());
 	}
 }
 
+// ========== Body Handles ==========
+
+FCelestialBodyHandle UCelestialBodyRegistry::GetBodyHandle(UCelestialBodyComponent* Body) const
+{
+	FScopeLock Lock(&RegistryLock);
+
+	const int32* SlotIndex = BodySlotLookup.Find(Body);
+	return SlotIndex ? FCelestialBodyHandle(*SlotIndex, BodySlots[*SlotIndex].Generation) : FCelestialBodyHandle();
+}
+
+UCelestialBodyComponent* UCelestialBodyRegistry::ResolveBodyHandle(const FCelestialBodyHandle& Handle) const
+{
+	FScopeLock Lock(&RegistryLock);
+
+	if (!BodySlots.IsValidIndex(Handle.Index) || BodySlots[Handle.Index].Generation != Handle.Generation)
+	{
+		return nullptr;
+	}
+
+	return BodySlots[Handle.Index].Body;
+}
+
 // ========== Body Lookup ==========
 
 TArray<UCelestialBodyComponent*> UCelestialBodyRegistry::GetAllCelestialBodies() const
 {
-	FScopeLock Lock(&RegistryLock);
-	return RegisteredBodies;
+	return GetBodyList()->Bodies;
+}
+
+TSharedRef<const FCelestialBodyList, ESPMode::ThreadSafe> UCelestialBodyRegistry::GetBodyList() const
+{
+	// Only the game thread publishes, and only after registration changed, so it reads its own pointer without locking
+	TSharedPtr<const FCelestialBodyList, ESPMode::ThreadSafe> Published;
+	if (IsInGameThread())
+	{
+		if (!PublishedBodyList.IsValid() || PublishedBodyList->Generation != GetRegistryGeneration())
+		{
+			FScopeLock Lock(&RegistryLock);
+			PublishBodyList();
+		}
+		Published = PublishedBodyList;
+	}
+	else
+	{
+		// Held only for the reference count bump; the copy keeps the list alive after the lock is released
+		FScopeLock Lock(&BodyListLock);
+		Published = PublishedBodyList;
+	}
+
+	if (Published.IsValid())
+	{
+		return Published.ToSharedRef();
+	}
+
+	// Queried from a worker before the game thread published anything
+	static const TSharedRef<const FCelestialBodyList, ESPMode::ThreadSafe> EmptyList = MakeShared<FCelestialBodyList, ESPMode::ThreadSafe>();
+	return EmptyList;
 }
 
 UCelestialBodyComponent* UCelestialBodyRegistry::FindBodyByName(FName BodyName) const
@@ -124,23 +285,18 @@ TArray<UCelestialBodyComponent*> UCelestialBodyRegistry::GetBodiesInRange(const
 	FScopeLock Lock(&RegistryLock);
 
 	TArray<UCelestialBodyComponent*> BodiesInRange;
-	float MaxDistanceSquared = MaxDistance * MaxDistance;
-
-	for (UCelestialBodyComponent* Body : RegisteredBodies)
+	if (!SpatialIndex.IsValid())
 	{
-		if (!IsValid(Body))
-		{
-			continue;
-		}
+		return BodiesInRange;
+	}
 
-		FVector BodyLocation = Body->GetOwner()->GetActorLocation();
-		float DistanceSquared = FVector::DistSquared(ReferencePoint, BodyLocation);
+	RefitSpatialIndex();
+	SpatialIndex->FindInRange(ReferencePoint, MaxDistance, BodiesInRange);
 
-		if (DistanceSquared <= MaxDistanceSquared)
-		{
-			BodiesInRange.Add(Body);
-		}
-	}
+	BodiesInRange.RemoveAllSwap([](const UCelestialBodyComponent* Body)
+	{
+		return !IsValid(Body);
+	});
 
 	return BodiesInRange;
 }
@@ -149,36 +305,19 @@ TArray<UCelestialBodyComponent*> UCelestialBodyRegistry::GetNearestBodies(const
 {
 	FScopeLock Lock(&RegistryLock);
 
-	// Create array with distance data
-	TArray<TPair<float, UCelestialBodyComponent*>> BodiesWithDistance;
-	BodiesWithDistance.Reserve(RegisteredBodies.Num());
-
-	for (UCelestialBodyComponent* Body : RegisteredBodies)
+	TArray<UCelestialBodyComponent*> NearestBodies;
+	if (!SpatialIndex.IsValid() || Count <= 0)
 	{
-		if (!IsValid(Body))
-		{
-			continue;
-		}
-
-		FVector BodyLocation = Body->GetOwner()->GetActorLocation();
-		float DistanceSquared = FVector::DistSquared(ReferencePoint, BodyLocation);
-		BodiesWithDistance.Add(TPair<float, UCelestialBodyComponent*>(DistanceSquared, Body));
+		return NearestBodies;
 	}
 
-	// Sort by distance
-	BodiesWithDistance.Sort([](const TPair<float, UCelestialBodyComponent*>& A, const TPair<float, UCelestialBodyComponent*>& B)
-	{
-		return A.Key < B.Key;
-	});
+	RefitSpatialIndex();
 
-	// Extract the nearest N bodies
-	TArray<UCelestialBodyComponent*> NearestBodies;
-	int32 NumToReturn = FMath::Min(Count, BodiesWithDistance.Num());
-
-	for (int32 i = 0; i < NumToReturn; ++i)
+	// Destroyed bodies are still indexed until they unregister; skip them before ranking so they cannot take a slot
+	SpatialIndex->FindNearest(ReferencePoint, Count, [](const UCelestialBodyComponent* Body)
 	{
-		NearestBodies.Add(BodiesWithDistance[i].Value);
-	}
+		return IsValid(Body);
+	}, NearestBodies);
 
 	return NearestBodies;
 }
@@ -209,6 +348,12 @@ void UCelestialBodyRegistry::UpdateAllBodyPositions(const FVector& OffsetDelta)
 		UpdatedCount++;
 	}
 
+	// Every body moved by the same amount: shift the index instead of reinserting
+	if (SpatialIndex.IsValid())
+	{
+		SpatialIndex->Translate(OffsetDelta);
+	}
+
 	if (bEnableDebugLogging)
 	{
 		UE_LOG(LogTemp, Log, TEXT("CelestialBodyRegistry: Updated %d body positions"), UpdatedCount);
@@ -240,9 +385,9 @@ void UCelestialBodyRegistry::UpdateAllBodyScales(const FVector& PlayerPosition)
 			continue;
 		}
 
-		// Calculate distance to player
+		// Calculate distance to player (bodies scale by distance in km)
 		FVector BodyLocation = Body->GetOwner()->GetActorLocation();
-		float Distance = FVector::Dist(PlayerPosition, BodyLocation);
+		float Distance = FVector::Dist(PlayerPosition, BodyLocation) / UnrealUnitsPerKilometer;
 
 		// Update body scale based on distance
 		Body->UpdateScaleForDistance(Distance);
@@ -255,6 +400,107 @@ void UCelestialBodyRegistry::UpdateAllBodyScales(const FVector& PlayerPosition)
 	}
 }
 
+void UCelestialBodyRegistry::UpdateBodyScales(const FVector& PlayerPosition)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CelestialScaleUpdate);
+	check(IsInGameThread());
+
+	const TSharedRef<const FCelestialBodyList, ESPMode::ThreadSafe> BodyList = GetBodyList();
+	if (ScheduledBodyList != BodyList)
+	{
+		SyncScaleSchedule(*BodyList);
+		ScheduledBodyList = BodyList;
+	}
+
+	UWorld* World = GetWorld();
+	const double Now = World ? World->GetTimeSeconds() : 0.0;
+	const double Deadline = FPlatformTime::Seconds() + ScaleUpdateBudgetMs * 0.001;
+	int32 NumUpdated = 0;
+	bool bBudgetSpent = false;
+
+	// Nearest priorities first, so a spent budget only ever delays distant bodies
+	for (int32 PriorityIndex = 0; PriorityIndex < NumUpdatePriorities && !bBudgetSpent; ++PriorityIndex)
+	{
+		const ECelestialUpdatePriority Priority = static_cast<ECelestialUpdatePriority>(PriorityIndex);
+		const double Interval = GetScaleUpdateInterval(Priority);
+		TArray<int32>& Bin = ScaleUpdateBins[PriorityIndex];
+		int32& Cursor = ScaleUpdateCursors[PriorityIndex];
+
+		// Visit each body at most once per frame, even those updated every frame
+		for (int32 Remaining = Bin.Num(); Remaining > 0 && Bin.Num() > 0; --Remaining)
+		{
+			if (NumUpdated >= MaxBodiesPerFrame || FPlatformTime::Seconds() >= Deadline)
+			{
+				bBudgetSpent = true;
+				break;
+			}
+
+			if (Cursor >= Bin.Num())
+			{
+				Cursor = 0;
+			}
+
+			// Swap-removal and bodies arriving from other bins leave the bin in no particular update order,
+			// so a body that is not due yet only skips itself
+			const int32 EntryIndex = Bin[Cursor];
+			FCelestialScaleUpdateEntry& Entry = ScaleUpdateEntries[EntryIndex];
+			if (Now - Entry.LastUpdateTime < Interval)
+			{
+				++Cursor;
+				continue;
+			}
+
+			const ECelestialUpdatePriority NewPriority = UpdateScheduledBodyScale(Entry, PlayerPosition, Now);
+			++NumUpdated;
+
+			if (NewPriority == Priority)
+			{
+				++Cursor;
+				continue;
+			}
+
+			// The bin's last entry is swapped into the cursor's slot and is visited next
+			UnlinkScaleUpdateEntry(EntryIndex);
+			LinkScaleUpdateEntry(EntryIndex, NewPriority);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_CelestialBodiesScaled, NumUpdated);
+
+	if (bEnableDebugLogging && bBudgetSpent)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("CelestialBodyRegistry: Scale budget spent after %d bodies"), NumUpdated);
+	}
+}
+
+float UCelestialBodyRegistry::GetScaleUpdateInterval(ECelestialUpdatePriority Priority) const
+{
+	const int32 PriorityIndex = static_cast<int32>(Priority);
+	if (PriorityIndex <= 0)
+	{
+		return 0.0f;
+	}
+
+	return AutoUpdateFrequency * FMath::Pow(FMath::Max(ScaleUpdateIntervalGrowth, 1.0f), static_cast<float>(PriorityIndex - 1));
+}
+
+ECelestialUpdatePriority UCelestialBodyRegistry::GetScaleUpdatePriority(double RadiusKm, double DistanceKm) const
+{
+	const double ApparentSize = RadiusKm / FMath::Max(DistanceKm, UE_DOUBLE_KINDA_SMALL_NUMBER);
+
+	double Threshold = CriticalApparentSize;
+	for (int32 PriorityIndex = 0; PriorityIndex < NumUpdatePriorities - 1; ++PriorityIndex)
+	{
+		if (ApparentSize >= Threshold)
+		{
+			return static_cast<ECelestialUpdatePriority>(PriorityIndex);
+		}
+		Threshold *= PriorityApparentSizeStep;
+	}
+
+	return ECelestialUpdatePriority::Minimal;
+}
+
 // ========== Optimization ==========
 
 void UCelestialBodyRegistry::SortBodiesByDistance(const FVector& ReferencePoint)
@@ -273,6 +519,15 @@ void UCelestialBodyRegistry::SortBodiesByDistance(const FVector& ReferencePoint)
 		return DistA < DistB;
 	});
 
+	// Slots and handles are unchanged; only their dense positions moved
+	for (int32 DenseIndex = 0; DenseIndex < RegisteredBodies.Num(); ++DenseIndex)
+	{
+		const int32 SlotIndex = BodySlotLookup.FindChecked(RegisteredBodies[DenseIndex]);
+		RegisteredBodySlots[DenseIndex] = SlotIndex;
+		BodySlots[SlotIndex].DenseIndex = DenseIndex;
+	}
+	++RegistryGeneration;
+
 	if (bEnableDebugLogging)
 	{
 		UE_LOG(LogTemp, Verbose, TEXT("CelestialBodyRegistry: Sorted %d bodies by distance from %s"),
@@ -285,8 +540,14 @@ void UCelestialBodyRegistry::ClearAllBodies()
 	FScopeLock Lock(&RegistryLock);
 
 	int32 ClearedCount = RegisteredBodies.Num();
-	RegisteredBodies.Empty();
+	ReleaseAllBodySlots();
 	BodyLookup.Empty();
+	++RegistryGeneration;
+
+	if (SpatialIndex.IsValid())
+	{
+		SpatialIndex->Reset();
+	}
 
 	UE_LOG(LogTemp, Warning, TEXT("CelestialBodyRegistry: Cleared %d bodies from registry"), ClearedCount);
 }
@@ -307,6 +568,11 @@ void UCelestialBodyRegistry::MulticastUpdateBodyPositions_Implementation(const F
 				Body->ApplyPositionOffset(OffsetDelta);
 			}
 		}
+
+		if (SpatialIndex.IsValid())
+		{
+			SpatialIndex->Translate(OffsetDelta);
+		}
 	}
 }
 
@@ -333,15 +599,160 @@ bool UCelestialBodyRegistry::IsValidBodyComponent(UCelestialBodyComponent* Body)
 	return true;
 }
 
+void UCelestialBodyRegistry::ReleaseAllBodySlots()
+{
+	for (const int32 SlotIndex : RegisteredBodySlots)
+	{
+		FCelestialBodySlot& Slot = BodySlots[SlotIndex];
+		Slot.Body = nullptr;
+		Slot.DenseIndex = INDEX_NONE;
+		++Slot.Generation;
+		FreeBodySlots.Add(SlotIndex);
+	}
+
+	RegisteredBodies.Empty();
+	RegisteredBodySlots.Empty();
+	BodySlotLookup.Empty();
+}
+
+void UCelestialBodyRegistry::RefitSpatialIndex() const
+{
+	// Bodies move at most once per frame in the common case; later queries in the frame reuse the refit
+	const uint64 Frame = GFrameCounter + 1;
+	if (SpatialIndexFrame.load(std::memory_order_relaxed) == Frame)
+	{
+		return;
+	}
+
+	SpatialIndex->Refit([](const UCelestialBodyComponent* Body, FVector& OutPosition)
+	{
+		const AActor* Owner = IsValid(Body) ? Body->GetOwner() : nullptr;
+		if (!Owner)
+		{
+			return false;
+		}
+
+		OutPosition = Owner->GetActorLocation();
+		return true;
+	});
+
+	SpatialIndexFrame.store(Frame, std::memory_order_relaxed);
+}
+
+void UCelestialBodyRegistry::PublishBodyList() const
+{
+	check(IsInGameThread());
+
+	TSharedRef<FCelestialBodyList, ESPMode::ThreadSafe> List = MakeShared<FCelestialBodyList, ESPMode::ThreadSafe>();
+	List->Bodies = RegisteredBodies;
+	List->Generation = GetRegistryGeneration();
+
+	List->Handles.Reserve(RegisteredBodySlots.Num());
+	List->SlotIndices.Init(INDEX_NONE, BodySlots.Num());
+	for (int32 DenseIndex = 0; DenseIndex < RegisteredBodySlots.Num(); ++DenseIndex)
+	{
+		const int32 SlotIndex = RegisteredBodySlots[DenseIndex];
+		List->Handles.Emplace(SlotIndex, BodySlots[SlotIndex].Generation);
+		List->SlotIndices[SlotIndex] = DenseIndex;
+	}
+
+	// Swap under the lock and let the previous list go after releasing it
+	TSharedPtr<const FCelestialBodyList, ESPMode::ThreadSafe> Previous = List;
+	{
+		FScopeLock Lock(&BodyListLock);
+		Swap(PublishedBodyList, Previous);
+	}
+}
+
+void UCelestialBodyRegistry::SyncScaleSchedule(const FCelestialBodyList& BodyList)
+{
+	TMap<FCelestialBodyHandle, FCelestialScaleUpdateEntry> PreviousEntries;
+	PreviousEntries.Reserve(ScaleUpdateEntries.Num());
+	for (const FCelestialScaleUpdateEntry& Entry : ScaleUpdateEntries)
+	{
+		PreviousEntries.Add(Entry.Handle, Entry);
+	}
+
+	ScaleUpdateEntries.Reset(BodyList.Bodies.Num());
+	for (int32 PriorityIndex = 0; PriorityIndex < NumUpdatePriorities; ++PriorityIndex)
+	{
+		ScaleUpdateBins[PriorityIndex].Reset();
+		ScaleUpdateCursors[PriorityIndex] = 0;
+	}
+
+	for (int32 BodyIndex = 0; BodyIndex < BodyList.Bodies.Num(); ++BodyIndex)
+	{
+		FCelestialScaleUpdateEntry Entry;
+
+		// New bodies start Critical and overdue, so their first update is next frame and finds their real priority
+		if (const FCelestialScaleUpdateEntry* Previous = PreviousEntries.Find(BodyList.Handles[BodyIndex]))
+		{
+			Entry = *Previous;
+		}
+		else
+		{
+			Entry.Body = BodyList.Bodies[BodyIndex];
+			Entry.Handle = BodyList.Handles[BodyIndex];
+			Entry.LastUpdateTime = -UE_DOUBLE_BIG_NUMBER;
+		}
+
+		const int32 EntryIndex = ScaleUpdateEntries.Add(Entry);
+		LinkScaleUpdateEntry(EntryIndex, Entry.Priority);
+	}
+}
+
+void UCelestialBodyRegistry::LinkScaleUpdateEntry(int32 EntryIndex, ECelestialUpdatePriority Priority)
+{
+	FCelestialScaleUpdateEntry& Entry = ScaleUpdateEntries[EntryIndex];
+	Entry.Priority = Priority;
+	Entry.Slot = ScaleUpdateBins[static_cast<int32>(Priority)].Add(EntryIndex);
+}
+
+void UCelestialBodyRegistry::UnlinkScaleUpdateEntry(int32 EntryIndex)
+{
+	FCelestialScaleUpdateEntry& Entry = ScaleUpdateEntries[EntryIndex];
+	TArray<int32>& Bin = ScaleUpdateBins[static_cast<int32>(Entry.Priority)];
+	Bin.RemoveAtSwap(Entry.Slot, 1, EAllowShrinking::No);
+
+	if (Bin.IsValidIndex(Entry.Slot))
+	{
+		ScaleUpdateEntries[Bin[Entry.Slot]].Slot = Entry.Slot;
+	}
+
+	Entry.Slot = INDEX_NONE;
+}
+
+ECelestialUpdatePriority UCelestialBodyRegistry::UpdateScheduledBodyScale(FCelestialScaleUpdateEntry& Entry, const FVector& PlayerPosition,
+	double Now) const
+{
+	Entry.LastUpdateTime = Now;
+
+	// Destroyed bodies linger until they unregister; park them where they cost least
+	const AActor* Owner = IsValid(Entry.Body) ? Entry.Body->GetOwner() : nullptr;
+	if (!Owner)
+	{
+		return ECelestialUpdatePriority::Minimal;
+	}
+
+	const double DistanceKm = FVector::Dist(PlayerPosition, Owner->GetActorLocation()) / UnrealUnitsPerKilometer;
+	Entry.Body->UpdateScaleForDistance(static_cast<float>(DistanceKm));
+
+	return GetScaleUpdatePriority(Entry.Body->GetRadius(), DistanceKm);
+}
+
 void UCelestialBodyRegistry::LogRegistryStatistics() const
 {
 	FScopeLock Lock(&RegistryLock);
 
 	UE_LOG(LogTemp, Log, TEXT("=== CelestialBodyRegistry Statistics ==="));
-	UE_LOG(LogTemp, Log, TEXT("Total Bodies: %d"), RegisteredBodies.Num());
+	UE_LOG(LogTemp, Log, TEXT("Total Bodies: %d (%d slots, %d free)"), RegisteredBodies.Num(), BodySlots.Num(), FreeBodySlots.Num());
+	UE_LOG(LogTemp, Log, TEXT("Spatial Index: %d bodies, %d nodes"),
+		SpatialIndex.IsValid() ? SpatialIndex->GetNumBodies() : 0, SpatialIndex.IsValid() ? SpatialIndex->GetNumNodes() : 0);
 	UE_LOG(LogTemp, Log, TEXT("Auto Update: %s"), bAutoUpdateEnabled ? TEXT("Enabled") : TEXT("Disabled"));
 	UE_LOG(LogTemp, Log, TEXT("Update Frequency: %.2f seconds"), AutoUpdateFrequency);
-	UE_LOG(LogTemp, Log, TEXT("Max Bodies Per Frame: %d"), MaxBodiesPerFrame);
+	UE_LOG(LogTemp, Log, TEXT("Max Bodies Per Frame: %d (%.2f ms budget)"), MaxBodiesPerFrame, ScaleUpdateBudgetMs);
+	UE_LOG(LogTemp, Log, TEXT("Scale Schedule: %d critical, %d high, %d medium, %d low, %d minimal"),
+		ScaleUpdateBins[0].Num(), ScaleUpdateBins[1].Num(), ScaleUpdateBins[2].Num(), ScaleUpdateBins[3].Num(), ScaleUpdateBins[4].Num());
 
 	// List all registered bodies
 	if (RegisteredBodies.Num() > 0)
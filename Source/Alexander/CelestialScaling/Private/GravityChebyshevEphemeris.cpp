@@ -0,0 +1,230 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityChebyshevEphemeris.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+FGravityChebyshevEphemeris::FGravityChebyshevEphemeris() = default;
+
+FGravityChebyshevEphemeris::~FGravityChebyshevEphemeris()
+{
+	// The region must be unmapped before its file handle closes
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+}
+
+bool FGravityChebyshevEphemeris::Cook(const FString& Filename, TConstArrayView<FName> BodyIDs, double InStartTime, int32 InNumSegments, double InSegmentDuration,
+	int32 InNumCoefficients, FSampleFunction SampleBodies)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityChebyshevEphemeris::Cook);
+
+	if (BodyIDs.Num() == 0 || InNumSegments <= 0 || InSegmentDuration <= 0.0 || InNumCoefficients < 2 || InNumCoefficients > MaxCoefficients)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Cannot cook ephemeris with %d bodies, %d segments of %.1f s and %d coefficients"),
+			BodyIDs.Num(), InNumSegments, InSegmentDuration, InNumCoefficients);
+		return false;
+	}
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Filename), true);
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Cannot write ephemeris %s"), *Filename);
+		return false;
+	}
+
+	const int32 NumBodyIDs = BodyIDs.Num();
+
+	FFileHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = FileMagic;
+	Header.Version = FileVersion;
+	Header.NumBodies = NumBodyIDs;
+	Header.NumSegments = InNumSegments;
+	Header.NumCoefficients = InNumCoefficients;
+	Header.StartTime = InStartTime;
+	Header.SegmentDuration = InSegmentDuration;
+	Writer->Serialize(&Header, sizeof(Header));
+
+	for (const FName BodyID : BodyIDs)
+	{
+		FFileBody Entry;
+		FMemory::Memzero(Entry);
+
+		const FString Name = BodyID.ToString();
+		if (Name.Len() >= MaxNameLength)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Ephemeris body ID '%s' is longer than %d characters and will not match at runtime"),
+				*Name, MaxNameLength - 1);
+		}
+
+		FCStringAnsi::Strncpy(Entry.Name, TCHAR_TO_ANSI(*Name), MaxNameLength);
+		Writer->Serialize(&Entry, sizeof(Entry));
+	}
+
+	// Chebyshev-Gauss nodes, sampled in increasing time order (node k sits at cos(pi (k + 1/2) / N))
+	TArray<FVector> Samples;
+	Samples.SetNumUninitialized(InNumCoefficients * NumBodyIDs);
+
+	TArray<double> SegmentCoefficients;
+	SegmentCoefficients.SetNumUninitialized(NumBodyIDs * 3 * InNumCoefficients);
+
+	const double HalfDuration = 0.5 * InSegmentDuration;
+
+	for (int32 Segment = 0; Segment < InNumSegments; ++Segment)
+	{
+		const double Midpoint = InStartTime + (Segment + 0.5) * InSegmentDuration;
+
+		for (int32 Node = InNumCoefficients - 1; Node >= 0; --Node)
+		{
+			const double X = FMath::Cos(UE_DOUBLE_PI * (Node + 0.5) / InNumCoefficients);
+			SampleBodies(Midpoint + HalfDuration * X, TArrayView<FVector>(Samples.GetData() + Node * NumBodyIDs, NumBodyIDs));
+		}
+
+		// c_j = 2/N sum_k f(x_k) T_j(x_k), with c_0 halved
+		for (int32 Body = 0; Body < NumBodyIDs; ++Body)
+		{
+			double* BodyCoefficients = SegmentCoefficients.GetData() + Body * 3 * InNumCoefficients;
+
+			for (int32 Term = 0; Term < InNumCoefficients; ++Term)
+			{
+				FVector Sum = FVector::ZeroVector;
+				for (int32 Node = 0; Node < InNumCoefficients; ++Node)
+				{
+					Sum += Samples[Node * NumBodyIDs + Body] * FMath::Cos(UE_DOUBLE_PI * Term * (Node + 0.5) / InNumCoefficients);
+				}
+
+				const double Scale = (Term == 0 ? 1.0 : 2.0) / InNumCoefficients;
+				BodyCoefficients[Term] = Sum.X * Scale;
+				BodyCoefficients[InNumCoefficients + Term] = Sum.Y * Scale;
+				BodyCoefficients[2 * InNumCoefficients + Term] = Sum.Z * Scale;
+			}
+		}
+
+		Writer->Serialize(SegmentCoefficients.GetData(), SegmentCoefficients.Num() * sizeof(double));
+	}
+
+	const bool bSuccess = Writer->Close();
+	UE_LOG(LogTemp, Log, TEXT("GravitySimulator: Cooked ephemeris %s (%d bodies, %d segments of %.1f s, %d coefficients)"),
+		*Filename, NumBodyIDs, InNumSegments, InSegmentDuration, InNumCoefficients);
+	return bSuccess;
+}
+
+bool FGravityChebyshevEphemeris::Load(const FString& Filename)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityChebyshevEphemeris::Load);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	FOpenMappedResult MappedResult = PlatformFile.OpenMappedEx(*Filename);
+
+	if (MappedResult.HasValue())
+	{
+		MappedHandle = MappedResult.StealValue();
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+
+		if (MappedRegion)
+		{
+			return Bind(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize(), Filename);
+		}
+
+		MappedHandle.Reset();
+	}
+
+	if (!FFileHelper::LoadFileToArray(FileData, *Filename))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Cannot open ephemeris %s"), *Filename);
+		return false;
+	}
+
+	return Bind(FileData.GetData(), FileData.Num(), Filename);
+}
+
+bool FGravityChebyshevEphemeris::Bind(const uint8* Data, int64 Size, const FString& Filename)
+{
+	if (Size < static_cast<int64>(sizeof(FFileHeader)))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Ephemeris %s is truncated"), *Filename);
+		return false;
+	}
+
+	const FFileHeader& Header = *reinterpret_cast<const FFileHeader*>(Data);
+	if (Header.Magic != FileMagic || Header.Version != FileVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: %s is not a version %u ephemeris"), *Filename, FileVersion);
+		return false;
+	}
+
+	const int64 BodiesSize = static_cast<int64>(Header.NumBodies) * sizeof(FFileBody);
+	const int64 CoefficientsSize = static_cast<int64>(Header.NumSegments) * Header.NumBodies * 3 * Header.NumCoefficients * sizeof(double);
+
+	if (Header.NumBodies <= 0 || Header.NumSegments <= 0 || Header.NumCoefficients < 2 || Header.NumCoefficients > MaxCoefficients
+		|| Header.SegmentDuration <= 0.0 || Size < static_cast<int64>(sizeof(FFileHeader)) + BodiesSize + CoefficientsSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Ephemeris %s has an invalid layout"), *Filename);
+		return false;
+	}
+
+	const FFileBody* Entries = reinterpret_cast<const FFileBody*>(Data + sizeof(FFileHeader));
+	BodyIndices.Reset();
+
+	for (int32 Body = 0; Body < Header.NumBodies; ++Body)
+	{
+		ANSICHAR Name[MaxNameLength];
+		FCStringAnsi::Strncpy(Name, Entries[Body].Name, MaxNameLength);
+		BodyIndices.Add(FName(ANSI_TO_TCHAR(Name)), Body);
+	}
+
+	Coefficients = reinterpret_cast<const double*>(Data + sizeof(FFileHeader) + BodiesSize);
+	NumBodies = Header.NumBodies;
+	NumSegments = Header.NumSegments;
+	NumCoefficients = Header.NumCoefficients;
+	StartTime = Header.StartTime;
+	SegmentDuration = Header.SegmentDuration;
+
+	UE_LOG(LogTemp, Log, TEXT("GravitySimulator: Loaded ephemeris %s (%d bodies, %.0f s to %.0f s%s)"),
+		*Filename, NumBodies, GetStartTime(), GetEndTime(), MappedRegion ? TEXT(", memory-mapped") : TEXT(""));
+	return true;
+}
+
+bool FGravityChebyshevEphemeris::Evaluate(int32 BodyIndex, double Time, FVector& OutPosition, FVector& OutVelocity) const
+{
+	const double Offset = (Time - StartTime) / SegmentDuration;
+	if (!Coefficients || Offset < 0.0 || Offset > NumSegments)
+	{
+		return false;
+	}
+
+	const int32 Segment = FMath::Min(FMath::FloorToInt32(Offset), NumSegments - 1);
+	const double X = 2.0 * (Offset - Segment) - 1.0;
+	const double* Series = Coefficients + (static_cast<int64>(Segment) * NumBodies + BodyIndex) * 3 * NumCoefficients;
+
+	// T_n and T_n' by recurrence, then one multiply-add per axis per term
+	double T0 = 1.0, T1 = X;
+	double D0 = 0.0, D1 = 1.0;
+
+	FVector Position(Series[0], Series[NumCoefficients], Series[2 * NumCoefficients]);
+	FVector Derivative = FVector::ZeroVector;
+
+	for (int32 Term = 1; Term < NumCoefficients; ++Term)
+	{
+		const FVector Coefficient(Series[Term], Series[NumCoefficients + Term], Series[2 * NumCoefficients + Term]);
+		Position += Coefficient * T1;
+		Derivative += Coefficient * D1;
+
+		const double T2 = 2.0 * X * T1 - T0;
+		const double D2 = 2.0 * T1 + 2.0 * X * D1 - D0;
+		T0 = T1;
+		T1 = T2;
+		D0 = D1;
+		D1 = D2;
+	}
+
+	// dx/dt = 2 / SegmentDuration
+	OutPosition = Position;
+	OutVelocity = Derivative * (2.0 / SegmentDuration);
+	return true;
+}
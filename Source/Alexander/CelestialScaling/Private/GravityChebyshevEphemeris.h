@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "Templates/UniquePtr.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Precomputed body positions as piecewise Chebyshev series over fixed time segments (JPL DE style)
+ * Positions are a pure function of time: a query picks the segment and sums one short series per
+ * axis, with no integration. Tables are cooked offline from the orbit integrator and memory-mapped
+ * at runtime, so only the pages actually queried are read.
+ *
+ * File layout (native endianness, all offsets 8-byte aligned):
+ *   FFileHeader
+ *   FFileBody[NumBodies]
+ *   double Coefficients[NumSegments][NumBodies][3][NumCoefficients]
+ * Segment-major order keeps every body's coefficients for one time span on the same pages.
+ * Positions are in Unreal units in the world frame the table was cooked in; times in simulation seconds.
+ */
+class FGravityChebyshevEphemeris
+{
+public:
+	/** Samples the positions of the cooked bodies at Time; called with non-decreasing times */
+	using FSampleFunction = TFunctionRef<void(double Time, TArrayView<FVector> OutPositions)>;
+
+	FGravityChebyshevEphemeris();
+	~FGravityChebyshevEphemeris();
+
+	/**
+	 * Fit and write a table
+	 * @param BodyIDs - Body identifiers, in the order SampleBodies writes positions
+	 * @param StartTime - Simulation time of the first segment
+	 * @param NumSegments - Segments to cook
+	 * @param SegmentDuration - Seconds per segment
+	 * @param NumCoefficients - Series length per axis and segment (higher fits faster-curving orbits)
+	 * @return False if the arguments are invalid or the file could not be written
+	 */
+	static bool Cook(const FString& Filename, TConstArrayView<FName> BodyIDs, double StartTime, int32 NumSegments, double SegmentDuration,
+		int32 NumCoefficients, FSampleFunction SampleBodies);
+
+	/** Map a cooked table; falls back to reading it into memory where mapping is unsupported */
+	bool Load(const FString& Filename);
+
+	/** Table index of a body, INDEX_NONE if the table does not contain it */
+	int32 FindBody(FName BodyID) const
+	{
+		const int32* Index = BodyIndices.Find(BodyID);
+		return Index ? *Index : INDEX_NONE;
+	}
+
+	/**
+	 * Position and velocity of a body at Time
+	 * @return False if Time lies outside the cooked span
+	 */
+	bool Evaluate(int32 BodyIndex, double Time, FVector& OutPosition, FVector& OutVelocity) const;
+
+	int32 GetNumBodies() const { return NumBodies; }
+	double GetStartTime() const { return StartTime; }
+	double GetEndTime() const { return StartTime + NumSegments * SegmentDuration; }
+
+private:
+	static constexpr uint32 FileMagic = 0x50454347; // 'GCEP'
+	static constexpr uint32 FileVersion = 1;
+	static constexpr int32 MaxCoefficients = 32;
+	static constexpr int32 MaxNameLength = 56;
+
+	struct FFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int32 NumBodies;
+		int32 NumSegments;
+		int32 NumCoefficients;
+		int32 Reserved;
+		double StartTime;
+		double SegmentDuration;
+	};
+
+	struct FFileBody
+	{
+		/** Null-terminated ANSI body ID */
+		ANSICHAR Name[MaxNameLength];
+		int64 Reserved;
+	};
+
+	/** Point the table at a validated file image */
+	bool Bind(const uint8* Data, int64 Size, const FString& Filename);
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** File contents when the platform cannot map files */
+	TArray64<uint8> FileData;
+
+	/** Coefficient block inside the mapped or loaded file */
+	const double* Coefficients = nullptr;
+
+	TMap<FName, int32> BodyIndices;
+	int32 NumBodies = 0;
+	int32 NumSegments = 0;
+	int32 NumCoefficients = 0;
+	double StartTime = 0.0;
+	double SegmentDuration = 0.0;
+};
@@ -0,0 +1,192 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityDebugRenderer.h"
+#include "GravityStats.h"
+#include "Components/LineBatchComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+
+namespace
+{
+	/** Great-circle segment range; a sphere filling the view gets the maximum */
+	constexpr int32 MinSphereSegments = 6;
+	constexpr int32 MaxSphereSegments = 32;
+
+	/** Circles drawn per sphere */
+	constexpr int32 SphereCircles = 3;
+
+	/** Lines per arrow: shaft and two head strokes */
+	constexpr int32 ArrowLines = 3;
+}
+
+void FGravityDebugRenderer::AddLine(const FVector& Start, const FVector& End, const FColor& Color, float Thickness, float Duration)
+{
+	Items.Add({ Start, End, 0.0, Color, Thickness, Duration, EItemType::Line, 0.0 });
+}
+
+void FGravityDebugRenderer::AddArrow(const FVector& Start, const FVector& End, float HeadSize, const FColor& Color, float Thickness, float Duration)
+{
+	Items.Add({ Start, End, HeadSize, Color, Thickness, Duration, EItemType::Arrow, 0.0 });
+}
+
+void FGravityDebugRenderer::AddSphere(const FVector& Center, double Radius, const FColor& Color, float Thickness, float Duration)
+{
+	Items.Add({ Center, Center, Radius, Color, Thickness, Duration, EItemType::Sphere, 0.0 });
+}
+
+void FGravityDebugRenderer::AddLabel(const FVector& Position, const FString& Text, const FColor& Color, float Duration)
+{
+	Labels.Add({ Position, Text, Color, Duration, 0.0 });
+}
+
+int32 FGravityDebugRenderer::GetSphereSegments(double Radius, double Distance)
+{
+	// Apparent size is 1 on or inside the sphere and falls off with distance; sqrt keeps mid-range spheres smooth
+	const double ApparentSize = Radius / FMath::Max(Distance, FMath::Max(Radius, UE_DOUBLE_KINDA_SMALL_NUMBER));
+	return FMath::Clamp(FMath::CeilToInt32(MaxSphereSegments * FMath::Sqrt(ApparentSize)), MinSphereSegments, MaxSphereSegments);
+}
+
+void FGravityDebugRenderer::Flush(UWorld* World, const FVector& ViewOrigin, int32 MaxLines, int32 MaxLabels)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityDebugDraw);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityDebugRenderer::Flush);
+
+	NumSubmittedLines = 0;
+	NumDroppedItems = 0;
+
+	if (!World)
+	{
+		Items.Reset();
+		Labels.Reset();
+		return;
+	}
+
+	for (FItem& Item : Items)
+	{
+		Item.Distance = Item.Type == EItemType::Sphere
+			? FMath::Max(FVector::Dist(ViewOrigin, Item.Start) - Item.Size, 0.0)
+			: FMath::PointDistToSegment(ViewOrigin, Item.Start, Item.End);
+	}
+
+	Items.Sort([](const FItem& A, const FItem& B)
+	{
+		return A.Distance < B.Distance;
+	});
+
+	TArray<FBatchedLine> FrameLines;
+	TArray<FBatchedLine> PersistentLines;
+	FrameLines.Reserve(FMath::Min(MaxLines, Items.Num() * ArrowLines));
+
+	for (const FItem& Item : Items)
+	{
+		const int32 NumSegments = Item.Type == EItemType::Sphere ? GetSphereSegments(Item.Size, Item.Distance + Item.Size) : 0;
+		const int32 Cost = Item.Type == EItemType::Sphere ? SphereCircles * NumSegments : Item.Type == EItemType::Arrow ? ArrowLines : 1;
+
+		// Everything after this is farther away; count what the budget drops
+		if (NumSubmittedLines + Cost > MaxLines)
+		{
+			++NumDroppedItems;
+			continue;
+		}
+
+		NumSubmittedLines += Cost;
+		TArray<FBatchedLine>& Lines = Item.Duration > 0.0f ? PersistentLines : FrameLines;
+		auto AddBatchedLine = [&Lines, &Item](const FVector& Start, const FVector& End)
+		{
+			Lines.Emplace(Start, End, FLinearColor(Item.Color), Item.Duration, Item.Thickness, SDPG_World);
+		};
+
+		switch (Item.Type)
+		{
+		case EItemType::Line:
+			AddBatchedLine(Item.Start, Item.End);
+			break;
+
+		case EItemType::Arrow:
+		{
+			AddBatchedLine(Item.Start, Item.End);
+
+			FVector Direction = (Item.End - Item.Start).GetSafeNormal();
+			if (!Direction.IsZero())
+			{
+				FVector Side, Up;
+				Direction.FindBestAxisVectors(Side, Up);
+				const FVector HeadBase = Item.End - Direction * Item.Size;
+				AddBatchedLine(Item.End, HeadBase + Side * (Item.Size * 0.5));
+				AddBatchedLine(Item.End, HeadBase - Side * (Item.Size * 0.5));
+			}
+			break;
+		}
+
+		case EItemType::Sphere:
+		{
+			const FVector Axes[SphereCircles][2] =
+			{
+				{ FVector::XAxisVector, FVector::YAxisVector },
+				{ FVector::XAxisVector, FVector::ZAxisVector },
+				{ FVector::YAxisVector, FVector::ZAxisVector }
+			};
+
+			for (int32 Circle = 0; Circle < SphereCircles; ++Circle)
+			{
+				FVector Previous = Item.Start + Axes[Circle][0] * Item.Size;
+				for (int32 Segment = 1; Segment <= NumSegments; ++Segment)
+				{
+					double Sin, Cos;
+					FMath::SinCos(&Sin, &Cos, UE_DOUBLE_TWO_PI * Segment / NumSegments);
+					const FVector Next = Item.Start + (Axes[Circle][0] * Cos + Axes[Circle][1] * Sin) * Item.Size;
+					AddBatchedLine(Previous, Next);
+					Previous = Next;
+				}
+			}
+			break;
+		}
+		}
+	}
+
+	// One submission per batcher instead of one per primitive
+	if (FrameLines.Num() > 0)
+	{
+		World->GetLineBatcher(UWorld::ELineBatcherType::World)->DrawLines(FrameLines);
+	}
+	if (PersistentLines.Num() > 0)
+	{
+		World->GetLineBatcher(UWorld::ELineBatcherType::WorldPersistent)->DrawLines(PersistentLines);
+	}
+
+	// Text is the most expensive primitive: only the nearest distinct labels
+	for (FLabel& Label : Labels)
+	{
+		Label.DistanceSquared = FVector::DistSquared(ViewOrigin, Label.Position);
+	}
+
+	Labels.Sort([](const FLabel& A, const FLabel& B)
+	{
+		return A.DistanceSquared < B.DistanceSquared;
+	});
+
+	TArray<const FLabel*, TInlineAllocator<16>> Drawn;
+	for (const FLabel& Label : Labels)
+	{
+		if (Drawn.Num() >= MaxLabels)
+		{
+			break;
+		}
+
+		const bool bDuplicate = Drawn.ContainsByPredicate([&Label](const FLabel* Other)
+		{
+			return Other->Position == Label.Position && Other->Text == Label.Text;
+		});
+
+		if (!bDuplicate)
+		{
+			DrawDebugString(World, Label.Position, Label.Text, nullptr, Label.Color, Label.Duration, true);
+			Drawn.Add(&Label);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_GravityDebugLines, NumSubmittedLines);
+
+	Items.Reset();
+	Labels.Reset();
+}
@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Frame queue for gravity and celestial body debug drawing
+ * Callers queue primitives at any point in the frame; the simulator flushes once per tick. Items
+ * are ranked by distance from the view and expanded into lines nearest first until the line
+ * budget runs out, so a large scene degrades by dropping its farthest shapes instead of its frame
+ * rate. Spheres get fewer segments the smaller they appear, lines go to the line batchers in one
+ * submission each, and only the nearest labels are drawn.
+ * Game thread only.
+ */
+class FGravityDebugRenderer
+{
+public:
+	void AddLine(const FVector& Start, const FVector& End, const FColor& Color, float Thickness, float Duration = 0.0f);
+
+	/** Line with a two-stroke head at End */
+	void AddArrow(const FVector& Start, const FVector& End, float HeadSize, const FColor& Color, float Thickness, float Duration = 0.0f);
+
+	/** Three orthogonal great circles, decimated by apparent size */
+	void AddSphere(const FVector& Center, double Radius, const FColor& Color, float Thickness, float Duration = 0.0f);
+
+	void AddLabel(const FVector& Position, const FString& Text, const FColor& Color, float Duration = 0.0f);
+
+	/** Whether anything is queued */
+	bool HasPendingDraws() const { return Items.Num() > 0 || Labels.Num() > 0; }
+
+	/**
+	 * Submit queued primitives nearest ViewOrigin first within the budgets, then clear the queue
+	 * @param MaxLines - Line budget for the frame
+	 * @param MaxLabels - Labels drawn for the frame (identical labels count once)
+	 */
+	void Flush(UWorld* World, const FVector& ViewOrigin, int32 MaxLines, int32 MaxLabels);
+
+	/** Lines submitted and items dropped by the latest flush */
+	int32 GetNumSubmittedLines() const { return NumSubmittedLines; }
+	int32 GetNumDroppedItems() const { return NumDroppedItems; }
+
+private:
+	enum class EItemType : uint8
+	{
+		Line,
+		Arrow,
+		Sphere
+	};
+
+	struct FItem
+	{
+		FVector Start;
+		FVector End;
+
+		/** Sphere radius or arrow head size */
+		double Size;
+
+		FColor Color;
+		float Thickness;
+		float Duration;
+		EItemType Type;
+
+		/** Distance from the view, filled in at flush */
+		double Distance;
+	};
+
+	struct FLabel
+	{
+		FVector Position;
+		FString Text;
+		FColor Color;
+		float Duration;
+		double DistanceSquared;
+	};
+
+	/** Great-circle segments for a sphere of Radius seen from Distance */
+	static int32 GetSphereSegments(double Radius, double Distance);
+
+	TArray<FItem> Items;
+	TArray<FLabel> Labels;
+
+	int32 NumSubmittedLines = 0;
+	int32 NumDroppedItems = 0;
+};
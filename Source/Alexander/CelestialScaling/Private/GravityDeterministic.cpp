@@ -0,0 +1,282 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityDeterministic.h"
+#include "GravityBodySnapshot.h"
+#include "Async/ParallelFor.h"
+#include "Hash/CityHash.h"
+#include "Math/RandomStream.h"
+
+namespace GravityDeterministic
+{
+	namespace
+	{
+		/** Bodies closer than this (Unreal units) are treated as coincident and skipped, as in the kernels */
+		constexpr double CoincidentDistance = 1.0e-3;
+
+		/** Largest double that converts to int64 without overflow */
+		constexpr double MaxFixed = 9.2e18;
+
+		/** Round onto the grid, saturating at +-Limit grid steps (Limit <= MaxFixed) */
+		int64 ToFixedLimited(double Value, int32 FractionBits, double Limit)
+		{
+			// Scaling by a power of two is exact; only the final rounding loses bits
+			const double Scaled = FMath::Clamp(FMath::RoundHalfFromZero(Value * static_cast<double>(1ll << FractionBits)), -Limit, Limit);
+			return static_cast<int64>(Scaled);
+		}
+
+		/** Integer add that saturates instead of overflowing (signed overflow is undefined) */
+		int64 AddSaturating(int64 A, int64 B)
+		{
+			if (B > 0 && A > TNumericLimits<int64>::Max() - B)
+			{
+				return TNumericLimits<int64>::Max();
+			}
+			if (B < 0 && A < TNumericLimits<int64>::Min() - B)
+			{
+				return TNumericLimits<int64>::Min();
+			}
+			return A + B;
+		}
+
+		/** One self-test run configuration */
+		struct FSelfTestRun
+		{
+			const TCHAR* Name;
+			int32 BatchSize;
+			EParallelForFlags Flags;
+			bool bReverseBodies;
+
+			/** Evaluate every body of every target as its own task and merge the partial sums in reverse */
+			bool bSplitBodies;
+		};
+	}
+
+	int64 ToFixed(double Value, int32 FractionBits)
+	{
+		return ToFixedLimited(Value, FractionBits, MaxFixed);
+	}
+
+	double FromFixed(int64 Value, int32 FractionBits)
+	{
+		return static_cast<double>(Value) / static_cast<double>(1ll << FractionBits);
+	}
+
+	FFixedVector ToFixed(const FVector& Value, int32 FractionBits)
+	{
+		FFixedVector Fixed;
+		Fixed.X = ToFixed(Value.X, FractionBits);
+		Fixed.Y = ToFixed(Value.Y, FractionBits);
+		Fixed.Z = ToFixed(Value.Z, FractionBits);
+		return Fixed;
+	}
+
+	FVector FromFixed(const FFixedVector& Value, int32 FractionBits)
+	{
+		return FVector(FromFixed(Value.X, FractionBits), FromFixed(Value.Y, FractionBits), FromFixed(Value.Z, FractionBits));
+	}
+
+	FVector ComputeAcceleration(const FGravityBodySnapshot& Snapshot, const GravityKernels::FGravityKernelParams& Params, const FVector& Position)
+	{
+		return FromFixed(ComputeAccelerationFixed(Snapshot, Params, Position, 0, Snapshot.Num()), AccelerationFractionBits);
+	}
+
+	FFixedVector ComputeAccelerationFixed(const FGravityBodySnapshot& Snapshot, const GravityKernels::FGravityKernelParams& Params, const FVector& Position,
+		int32 FirstBody, int32 NumBodies)
+	{
+		FFixedVector Sum;
+
+		// Each term saturates at MaxFixed / body count, so no order of additions can overflow the sum;
+		// the limit depends only on the total count, so every machine and every split clamps identically
+		const double TermLimit = MaxFixed / static_cast<double>(FMath::Max(Snapshot.Num(), 1));
+		const int32 EndBody = FMath::Min(FirstBody + NumBodies, Snapshot.Num());
+
+		for (int32 BodyIndex = FMath::Max(FirstBody, 0); BodyIndex < EndBody; ++BodyIndex)
+		{
+			if (!Snapshot.IsValidIndex(BodyIndex))
+			{
+				continue;
+			}
+
+			// Explicit operation order; no vector helpers whose internals could change
+			const double DX = Snapshot.PositionX[BodyIndex] - Position.X;
+			const double DY = Snapshot.PositionY[BodyIndex] - Position.Y;
+			const double DZ = Snapshot.PositionZ[BodyIndex] - Position.Z;
+			const double DX2 = DX * DX;
+			const double DY2 = DY * DY;
+			const double DZ2 = DZ * DZ;
+			const double DistanceSquared = (DX2 + DY2) + DZ2;
+
+			if (DistanceSquared < CoincidentDistance * CoincidentDistance)
+			{
+				continue;
+			}
+
+			const double Denominator = FMath::Max(DistanceSquared, Params.MinDistanceSquared) * FMath::Sqrt(DistanceSquared);
+			const double Scale = Snapshot.GM[BodyIndex] / Denominator;
+
+			// Integer sums are exact, so body order cannot change the result
+			Sum.X += ToFixedLimited(DX * Scale, AccelerationFractionBits, TermLimit);
+			Sum.Y += ToFixedLimited(DY * Scale, AccelerationFractionBits, TermLimit);
+			Sum.Z += ToFixedLimited(DZ * Scale, AccelerationFractionBits, TermLimit);
+		}
+
+		return Sum;
+	}
+
+	void Step(FFixedVector& Position, FFixedVector& Velocity, const FVector& Acceleration, double DeltaTime)
+	{
+		Velocity.X = AddSaturating(Velocity.X, ToFixed(Acceleration.X * DeltaTime, VelocityFractionBits));
+		Velocity.Y = AddSaturating(Velocity.Y, ToFixed(Acceleration.Y * DeltaTime, VelocityFractionBits));
+		Velocity.Z = AddSaturating(Velocity.Z, ToFixed(Acceleration.Z * DeltaTime, VelocityFractionBits));
+
+		Position.X = AddSaturating(Position.X, ToFixed(FromFixed(Velocity.X, VelocityFractionBits) * DeltaTime, PositionFractionBits));
+		Position.Y = AddSaturating(Position.Y, ToFixed(FromFixed(Velocity.Y, VelocityFractionBits) * DeltaTime, PositionFractionBits));
+		Position.Z = AddSaturating(Position.Z, ToFixed(FromFixed(Velocity.Z, VelocityFractionBits) * DeltaTime, PositionFractionBits));
+	}
+
+	uint64 HashState(TConstArrayView<FFixedVector> Positions, TConstArrayView<FFixedVector> Velocities)
+	{
+		const uint64 PositionHash = CityHash64(reinterpret_cast<const char*>(Positions.GetData()), Positions.Num() * sizeof(FFixedVector));
+		return CityHash64WithSeed(reinterpret_cast<const char*>(Velocities.GetData()), Velocities.Num() * sizeof(FFixedVector), PositionHash);
+	}
+
+	bool RunSelfTest(int32 NumSteps, int32 NumTargets)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(GravityDeterministic::RunSelfTest);
+
+		// Planet, moon and a distant star with GM chosen so targets feel a fraction of a G
+		constexpr double G = 6.674e-11;
+		const FVector BodyPositions[] = { FVector::ZeroVector, FVector(3.0e7, 0.0, 0.0), FVector(-4.0e9, 1.0e9, 0.0) };
+		const double BodyMasses[] = { 5.97e24, 7.35e22, 1.99e30 };
+		const double BodyRadii[] = { 60.0, 17.0, 7000.0 };
+
+		FGravityBodySnapshot Forward;
+		FGravityBodySnapshot Reversed;
+		Forward.Reset(UE_ARRAY_COUNT(BodyPositions));
+		Reversed.Reset(UE_ARRAY_COUNT(BodyPositions));
+
+		for (int32 Body = 0; Body < UE_ARRAY_COUNT(BodyPositions); ++Body)
+		{
+			const int32 Mirrored = UE_ARRAY_COUNT(BodyPositions) - 1 - Body;
+			Forward.Add(nullptr, BodyPositions[Body], BodyMasses[Body], BodyRadii[Body], G, true);
+			Reversed.Add(nullptr, BodyPositions[Mirrored], BodyMasses[Mirrored], BodyRadii[Mirrored], G, true);
+		}
+
+		GravityKernels::FGravityKernelParams Params;
+		Params.MinDistanceSquared = 100.0 * 100.0;
+
+		const double AccelerationScale = 100.0;
+		const double MaxAcceleration = 50.0 * 980.665;
+		const double DeltaTime = 1.0 / 60.0;
+
+		// Targets on roughly circular orbits around the planet
+		TArray<FFixedVector> InitialPositions;
+		TArray<FFixedVector> InitialVelocities;
+		FRandomStream Random(0x6772);
+
+		for (int32 Target = 0; Target < NumTargets; ++Target)
+		{
+			const FVector Direction = Random.GetUnitVector();
+			const double Radius = Random.FRandRange(8.0e6, 2.0e7);
+			const FVector Position = Direction * Radius;
+			const FVector Tangent = FVector::CrossProduct(Direction, Random.GetUnitVector()).GetSafeNormal();
+			const double Speed = FMath::Sqrt(G * BodyMasses[0] * AccelerationScale / Radius);
+
+			InitialPositions.Add(ToFixed(Position, PositionFractionBits));
+			InitialVelocities.Add(ToFixed(Tangent * Speed, VelocityFractionBits));
+		}
+
+		const FSelfTestRun Runs[] =
+		{
+			{ TEXT("single thread"), NumTargets, EParallelForFlags::ForceSingleThread, false, false },
+			{ TEXT("parallel, batch 1"), 1, EParallelForFlags::Unbalanced, false, false },
+			{ TEXT("parallel, batch 37"), 37, EParallelForFlags::None, false, false },
+			{ TEXT("parallel, reversed bodies"), 16, EParallelForFlags::None, true, false },
+			{ TEXT("parallel, split body sums"), 1, EParallelForFlags::Unbalanced, false, true }
+		};
+
+		const int32 NumBodies = Forward.Num();
+		TArray<FFixedVector> PartialSums;
+
+		uint64 ReferenceHash = 0;
+		bool bAllMatch = true;
+
+		for (int32 RunIndex = 0; RunIndex < UE_ARRAY_COUNT(Runs); ++RunIndex)
+		{
+			const FSelfTestRun& Run = Runs[RunIndex];
+			const FGravityBodySnapshot& Snapshot = Run.bReverseBodies ? Reversed : Forward;
+
+			TArray<FFixedVector> Positions = InitialPositions;
+			TArray<FFixedVector> Velocities = InitialVelocities;
+
+			const double StartSeconds = FPlatformTime::Seconds();
+			const int32 BatchSize = FMath::Max(Run.BatchSize, 1);
+			const int32 NumBatches = FMath::DivideAndRoundUp(NumTargets, BatchSize);
+
+			for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+			{
+				if (Run.bSplitBodies)
+				{
+					// Every (target, body) term on its own task, so sums are formed from partials computed on different threads
+					PartialSums.SetNum(NumTargets * NumBodies, EAllowShrinking::No);
+					ParallelFor(PartialSums.Num(), [&](int32 TermIndex)
+					{
+						const int32 Target = TermIndex / NumBodies;
+						const FVector Position = FromFixed(Positions[Target], PositionFractionBits);
+						PartialSums[TermIndex] = ComputeAccelerationFixed(Snapshot, Params, Position, TermIndex % NumBodies, 1);
+					}, Run.Flags);
+
+					for (int32 Target = 0; Target < NumTargets; ++Target)
+					{
+						FFixedVector Sum;
+						for (int32 Body = NumBodies - 1; Body >= 0; --Body)
+						{
+							const FFixedVector& Partial = PartialSums[Target * NumBodies + Body];
+							Sum.X += Partial.X;
+							Sum.Y += Partial.Y;
+							Sum.Z += Partial.Z;
+						}
+
+						const FVector Acceleration = (FromFixed(Sum, AccelerationFractionBits) * AccelerationScale).GetClampedToMaxSize(MaxAcceleration);
+						Step(Positions[Target], Velocities[Target], Acceleration, DeltaTime);
+					}
+					continue;
+				}
+
+				ParallelFor(NumBatches, [&](int32 BatchIndex)
+				{
+					const int32 End = FMath::Min((BatchIndex + 1) * BatchSize, NumTargets);
+					for (int32 Target = BatchIndex * BatchSize; Target < End; ++Target)
+					{
+						const FVector Position = FromFixed(Positions[Target], PositionFractionBits);
+						const FVector Acceleration = (ComputeAcceleration(Snapshot, Params, Position) * AccelerationScale).GetClampedToMaxSize(MaxAcceleration);
+						Step(Positions[Target], Velocities[Target], Acceleration, DeltaTime);
+					}
+				}, Run.Flags);
+			}
+
+			const uint64 Hash = HashState(Positions, Velocities);
+			if (RunIndex == 0)
+			{
+				ReferenceHash = Hash;
+			}
+
+			const bool bMatch = Hash == ReferenceHash;
+			bAllMatch &= bMatch;
+
+			UE_LOG(LogTemp, Log, TEXT("GravitySimulator: Determinism run '%s': %d steps x %d targets, hash %016llx %s (%.1f ms)"),
+				Run.Name, NumSteps, NumTargets, Hash, bMatch ? TEXT("matches") : TEXT("DIFFERS"), (FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+		}
+
+		if (bAllMatch)
+		{
+			UE_LOG(LogTemp, Log, TEXT("GravitySimulator: Determinism test passed"));
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("GravitySimulator: Determinism test FAILED; gravity diverges across thread counts or body orders"));
+		}
+
+		return bAllMatch;
+	}
+}
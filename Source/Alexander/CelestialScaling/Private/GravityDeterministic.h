@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GravityKernels.h"
+
+struct FGravityBodySnapshot;
+
+/**
+ * Reproducible gravity for lockstep simulation and replays
+ * Floating-point sums depend on their order, so the same bodies visited in a different order (another
+ * registration order, another thread split) give different low bits that grow into divergence.
+ * Here each body's contribution is evaluated in double with a fixed operation sequence and rounded
+ * to a fixed-point grid, and contributions are summed as integers, which is exact and associative.
+ * Ship states are stepped on fixed-point grids too, so client and server replays from the same inputs
+ * produce identical bits regardless of body order or thread count.
+ *
+ * Only IEEE basic operations and square roots are used (no transcendental functions, whose results
+ * differ between math libraries). Builds must not contract multiply-adds into FMA differently on
+ * the two ends; the fixed-point rounding absorbs most last-bit differences but cannot guarantee it.
+ */
+namespace GravityDeterministic
+{
+	/** Fractional bits of the fixed-point grids: 1/256 unit positions, 1/65536 unit/s velocities, 2^-40 kernel accelerations */
+	constexpr int32 PositionFractionBits = 8;
+	constexpr int32 VelocityFractionBits = 16;
+	constexpr int32 AccelerationFractionBits = 40;
+
+	/** Vector stored as integers scaled by 2^FractionBits */
+	struct FFixedVector
+	{
+		int64 X = 0;
+		int64 Y = 0;
+		int64 Z = 0;
+
+		bool operator==(const FFixedVector& Other) const { return X == Other.X && Y == Other.Y && Z == Other.Z; }
+	};
+
+	/** Round a value to the grid, saturating at the int64 range */
+	int64 ToFixed(double Value, int32 FractionBits);
+
+	/** Exact inverse of ToFixed for values within 2^53 grid steps */
+	double FromFixed(int64 Value, int32 FractionBits);
+
+	FFixedVector ToFixed(const FVector& Value, int32 FractionBits);
+	FVector FromFixed(const FFixedVector& Value, int32 FractionBits);
+
+	/** Round a vector onto a grid, returning it as a double vector */
+	inline FVector Snap(const FVector& Value, int32 FractionBits) { return FromFixed(ToFixed(Value, FractionBits), FractionBits); }
+
+	/**
+	 * Kernel acceleration (GM / r²) at Position from every valid body
+	 * Direct sum independent of body order; simulation modes that pick a subset of bodies are not applied
+	 */
+	FVector ComputeAcceleration(const FGravityBodySnapshot& Snapshot, const GravityKernels::FGravityKernelParams& Params, const FVector& Position);
+
+	/**
+	 * Fixed-point partial sum of ComputeAcceleration over bodies [FirstBody, FirstBody + NumBodies)
+	 * Partial sums over disjoint ranges add up exactly to the full sum, so the body loop can be split across tasks
+	 */
+	FFixedVector ComputeAccelerationFixed(const FGravityBodySnapshot& Snapshot, const GravityKernels::FGravityKernelParams& Params, const FVector& Position,
+		int32 FirstBody, int32 NumBodies);
+
+	/**
+	 * One semi-implicit Euler step on the fixed-point grids: v += a dt, then x += v dt
+	 * @param Acceleration - Applied acceleration in Unreal units per second²
+	 */
+	void Step(FFixedVector& Position, FFixedVector& Velocity, const FVector& Acceleration, double DeltaTime);
+
+	/** Hash of a set of fixed-point states */
+	uint64 HashState(TConstArrayView<FFixedVector> Positions, TConstArrayView<FFixedVector> Velocities);
+
+	/**
+	 * Step a synthetic system single-threaded, in parallel with two batch sizes, with the body order reversed,
+	 * and with each target's body sum split across tasks and merged in reverse, then compare state hashes
+	 * @return True if every run produced the same hash
+	 */
+	bool RunSelfTest(int32 NumSteps, int32 NumTargets);
+}
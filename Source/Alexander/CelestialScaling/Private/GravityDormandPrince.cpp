@@ -0,0 +1,208 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityDormandPrince.h"
+
+namespace
+{
+	/** Dormand-Prince 5(4) tableau; row 6 equals the fifth-order weights (first same as last) */
+	constexpr double StageTimes[7] = { 0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0 };
+
+	constexpr double StageWeights[7][6] =
+	{
+		{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+		{ 1.0 / 5.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+		{ 3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0, 0.0 },
+		{ 44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0, 0.0, 0.0, 0.0 },
+		{ 19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0, 0.0, 0.0 },
+		{ 9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0, 0.0 },
+		{ 35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0 }
+	};
+
+	/** Fifth-order minus fourth-order weights: the local error estimate */
+	constexpr double ErrorWeights[7] =
+	{
+		71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0
+	};
+
+	/** Step controller: safety margin on the optimal step, and limits on how fast it may change */
+	constexpr double StepSafety = 0.9;
+	constexpr double MinStepScale = 0.2;
+	constexpr double MaxStepScale = 10.0;
+
+	double GetComponentScale(double Current, double Next, const FGravityAdaptiveStepParams& Params)
+	{
+		return Params.AbsoluteTolerance + Params.RelativeTolerance * FMath::Max(FMath::Abs(Current), FMath::Abs(Next));
+	}
+}
+
+void FGravityDormandPrince::Begin(double InTime, TConstArrayView<FVector> InPositions, TConstArrayView<FVector> InVelocities, FAccelerationFunction Acceleration)
+{
+	const int32 NumBodies = InPositions.Num();
+	check(InVelocities.Num() == NumBodies);
+
+	Positions = InPositions;
+	Velocities = InVelocities;
+	Accelerations.SetNumUninitialized(NumBodies);
+	StagePositions.SetNumUninitialized(NumBodies);
+
+	for (int32 Stage = 0; Stage < NumStages; ++Stage)
+	{
+		StageVelocities[Stage].SetNumUninitialized(NumBodies);
+		StageAccelerations[Stage].SetNumUninitialized(NumBodies);
+	}
+
+	Time = InTime;
+	PreviousTime = InTime;
+	NumEvaluations = 1;
+	NumRejected = 0;
+
+	Acceleration(Time, Positions, Velocities, Accelerations);
+
+	PreviousPositions = Positions;
+	PreviousVelocities = Velocities;
+	PreviousAccelerations = Accelerations;
+}
+
+bool FGravityDormandPrince::TryStep(double& InOutStep, double EndTime, const FGravityAdaptiveStepParams& Params, FAccelerationFunction Acceleration)
+{
+	const int32 NumBodies = Positions.Num();
+	const double RequestedStep = FMath::Clamp(InOutStep, Params.MinStep, Params.MaxStep);
+	const bool bClipped = Time + RequestedStep >= EndTime;
+	const double Step = bClipped ? EndTime - Time : RequestedStep;
+
+	if (Step <= 0.0)
+	{
+		InOutStep = RequestedStep;
+		return false;
+	}
+
+	// Stage 0 reuses the accelerations of the current state
+	FMemory::Memcpy(StageVelocities[0].GetData(), Velocities.GetData(), NumBodies * sizeof(FVector));
+	FMemory::Memcpy(StageAccelerations[0].GetData(), Accelerations.GetData(), NumBodies * sizeof(FVector));
+
+	for (int32 Stage = 1; Stage < NumStages; ++Stage)
+	{
+		for (int32 Body = 0; Body < NumBodies; ++Body)
+		{
+			FVector PositionDelta = FVector::ZeroVector;
+			FVector VelocityDelta = FVector::ZeroVector;
+
+			for (int32 Previous = 0; Previous < Stage; ++Previous)
+			{
+				const double Weight = StageWeights[Stage][Previous];
+				PositionDelta += StageVelocities[Previous][Body] * Weight;
+				VelocityDelta += StageAccelerations[Previous][Body] * Weight;
+			}
+
+			StagePositions[Body] = Positions[Body] + PositionDelta * Step;
+			StageVelocities[Stage][Body] = Velocities[Body] + VelocityDelta * Step;
+		}
+
+		Acceleration(Time + StageTimes[Stage] * Step, StagePositions, StageVelocities[Stage], StageAccelerations[Stage]);
+	}
+
+	NumEvaluations += NumStages - 1;
+
+	// Last stage holds the fifth-order solution; compare it with the embedded fourth-order one
+	double ErrorSum = 0.0;
+	for (int32 Body = 0; Body < NumBodies; ++Body)
+	{
+		FVector PositionError = FVector::ZeroVector;
+		FVector VelocityError = FVector::ZeroVector;
+
+		for (int32 Stage = 0; Stage < NumStages; ++Stage)
+		{
+			PositionError += StageVelocities[Stage][Body] * ErrorWeights[Stage];
+			VelocityError += StageAccelerations[Stage][Body] * ErrorWeights[Stage];
+		}
+
+		const FVector& NextPosition = StagePositions[Body];
+		const FVector& NextVelocity = StageVelocities[NumStages - 1][Body];
+
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			ErrorSum += FMath::Square(PositionError[Axis] * Step / GetComponentScale(Positions[Body][Axis], NextPosition[Axis], Params));
+			ErrorSum += FMath::Square(VelocityError[Axis] * Step / GetComponentScale(Velocities[Body][Axis], NextVelocity[Axis], Params));
+		}
+	}
+
+	const double Error = NumBodies > 0 ? FMath::Sqrt(ErrorSum / (6.0 * NumBodies)) : 0.0;
+	const double Scale = Error > 0.0 ? FMath::Clamp(StepSafety * FMath::Pow(Error, -0.2), MinStepScale, MaxStepScale) : MaxStepScale;
+
+	// Nothing shorter is allowed, so a failing step at the floor is taken anyway
+	const bool bAccepted = Error <= 1.0 || Step <= Params.MinStep;
+
+	if (!bAccepted)
+	{
+		++NumRejected;
+		InOutStep = FMath::Clamp(Step * FMath::Min(Scale, 1.0), Params.MinStep, Params.MaxStep);
+		return false;
+	}
+
+	Swap(PreviousPositions, Positions);
+	Swap(PreviousVelocities, Velocities);
+	Swap(PreviousAccelerations, Accelerations);
+
+	Positions = StagePositions;
+	Velocities = StageVelocities[NumStages - 1];
+	Accelerations = StageAccelerations[NumStages - 1];
+
+	PreviousTime = Time;
+	Time = bClipped ? EndTime : Time + Step;
+
+	// A step cut short by EndTime says nothing about how long the next one may be
+	const double NextStep = Step * Scale;
+	InOutStep = FMath::Clamp(bClipped ? FMath::Max(NextStep, RequestedStep) : NextStep, Params.MinStep, Params.MaxStep);
+	return true;
+}
+
+void FGravityDormandPrince::Integrate(double EndTime, double& InOutStep, const FGravityAdaptiveStepParams& Params, FAccelerationFunction Acceleration)
+{
+	while (Time < EndTime)
+	{
+		TryStep(InOutStep, EndTime, Params, Acceleration);
+	}
+}
+
+void FGravityDormandPrince::Interpolate(int32 Index, double InTime, FVector& OutPosition, FVector& OutVelocity) const
+{
+	const double Step = Time - PreviousTime;
+	if (Step <= 0.0)
+	{
+		OutPosition = Positions[Index];
+		OutVelocity = Velocities[Index];
+		return;
+	}
+
+	const double S = FMath::Clamp((InTime - PreviousTime) / Step, 0.0, 1.0);
+	const double S2 = S * S;
+	const double S3 = S2 * S;
+	const double S4 = S3 * S;
+	const double S5 = S4 * S;
+
+	// Quintic Hermite basis matching position, velocity and acceleration at both ends
+	const double H0 = 1.0 - 10.0 * S3 + 15.0 * S4 - 6.0 * S5;
+	const double H1 = S - 6.0 * S3 + 8.0 * S4 - 3.0 * S5;
+	const double H2 = 0.5 * S2 - 1.5 * S3 + 1.5 * S4 - 0.5 * S5;
+	const double H3 = 0.5 * S3 - S4 + 0.5 * S5;
+	const double H4 = -4.0 * S3 + 7.0 * S4 - 3.0 * S5;
+	const double H5 = 10.0 * S3 - 15.0 * S4 + 6.0 * S5;
+
+	const double D0 = -30.0 * S2 + 60.0 * S3 - 30.0 * S4;
+	const double D1 = 1.0 - 18.0 * S2 + 32.0 * S3 - 15.0 * S4;
+	const double D2 = S - 4.5 * S2 + 6.0 * S3 - 2.5 * S4;
+	const double D3 = 1.5 * S2 - 4.0 * S3 + 2.5 * S4;
+	const double D4 = -12.0 * S2 + 28.0 * S3 - 15.0 * S4;
+
+	const FVector& P0 = PreviousPositions[Index];
+	const FVector& V0 = PreviousVelocities[Index];
+	const FVector& A0 = PreviousAccelerations[Index];
+	const FVector& P1 = Positions[Index];
+	const FVector& V1 = Velocities[Index];
+	const FVector& A1 = Accelerations[Index];
+
+	const double Step2 = Step * Step;
+
+	OutPosition = P0 * H0 + V0 * (H1 * Step) + A0 * (H2 * Step2) + A1 * (H3 * Step2) + V1 * (H4 * Step) + P1 * H5;
+	OutVelocity = (P1 - P0) * (-D0 / Step) + V0 * D1 + A0 * (D2 * Step) + A1 * (D3 * Step) + V1 * D4;
+}
@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+/**
+ * Error control for adaptive integration
+ * A step is accepted when every position and velocity component's error estimate is below
+ * AbsoluteTolerance + RelativeTolerance * |component| (RMS over components)
+ */
+struct FGravityAdaptiveStepParams
+{
+	/** Absolute error allowed per step (Unreal units, and Unreal units per second for velocities) */
+	double AbsoluteTolerance = 1.0;
+
+	/** Error allowed per step relative to the magnitude of each component */
+	double RelativeTolerance = 1.0e-8;
+
+	/** Steps never shrink below this; a step at the floor is accepted whatever its error (seconds) */
+	double MinStep = 1.0e-4;
+
+	/** Steps never grow beyond this (seconds) */
+	double MaxStep = 600.0;
+};
+
+/**
+ * Embedded Runge-Kutta 4(5) integrator (Dormand-Prince) for second-order gravity problems
+ * Each step takes six new force evaluations (the seventh is reused as the first of the next step)
+ * and compares the fifth- and fourth-order solutions to estimate its own error. Steps that miss
+ * the tolerance are retried shorter; accurate steps let the next one grow, so step length follows
+ * the local dynamics: long in cruise, short through periapsis.
+ * The state is a set of bodies with positions and velocities; the caller supplies accelerations.
+ */
+class FGravityDormandPrince
+{
+public:
+	/**
+	 * Computes accelerations for a trial state
+	 * Velocities are provided for callers whose force model depends on them (e.g. bodies placed relative to a moving parent)
+	 */
+	using FAccelerationFunction = TFunctionRef<void(double Time, TConstArrayView<FVector> Positions, TConstArrayView<FVector> Velocities, TArrayView<FVector> OutAccelerations)>;
+
+	/** Set the state to integrate from and evaluate its accelerations */
+	void Begin(double InTime, TConstArrayView<FVector> Positions, TConstArrayView<FVector> Velocities, FAccelerationFunction Acceleration);
+
+	/**
+	 * Attempt one step, clipped so it does not pass EndTime
+	 * @param InOutStep - Step to attempt; receives the step to attempt next
+	 * @return True if the step was accepted and the state advanced
+	 */
+	bool TryStep(double& InOutStep, double EndTime, const FGravityAdaptiveStepParams& Params, FAccelerationFunction Acceleration);
+
+	/**
+	 * Advance to EndTime with as many accepted steps as the tolerance requires
+	 * @param InOutStep - First step to attempt; receives the step to attempt next time
+	 */
+	void Integrate(double EndTime, double& InOutStep, const FGravityAdaptiveStepParams& Params, FAccelerationFunction Acceleration);
+
+	/**
+	 * Quintic Hermite interpolation inside the last accepted step
+	 * Uses positions, velocities and accelerations at both ends, so it is as accurate as the step itself
+	 */
+	void Interpolate(int32 Index, double InTime, FVector& OutPosition, FVector& OutVelocity) const;
+
+	double GetTime() const { return Time; }
+	TConstArrayView<FVector> GetPositions() const { return Positions; }
+	TConstArrayView<FVector> GetVelocities() const { return Velocities; }
+
+	/** Force evaluations since Begin */
+	int32 GetNumEvaluations() const { return NumEvaluations; }
+
+	/** Rejected steps since Begin */
+	int32 GetNumRejected() const { return NumRejected; }
+
+private:
+	static constexpr int32 NumStages = 7;
+
+	/** Current state and its accelerations */
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<FVector> Accelerations;
+
+	/** State at the start of the last accepted step, for interpolation */
+	TArray<FVector> PreviousPositions;
+	TArray<FVector> PreviousVelocities;
+	TArray<FVector> PreviousAccelerations;
+
+	/** Stage velocities and accelerations; stage 0 is the current state, stage 6 the proposed end state */
+	TArray<FVector> StageVelocities[NumStages];
+	TArray<FVector> StageAccelerations[NumStages];
+
+	/** Trial positions of the stage being evaluated */
+	TArray<FVector> StagePositions;
+
+	double Time = 0.0;
+	double PreviousTime = 0.0;
+	int32 NumEvaluations = 0;
+	int32 NumRejected = 0;
+};
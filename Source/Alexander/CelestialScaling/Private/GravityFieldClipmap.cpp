@@ -0,0 +1,269 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityFieldClipmap.h"
+#include "GravityBodySnapshot.h"
+#include "GravityStats.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	/** Nodes evaluated per worker task */
+	constexpr int32 FieldBatchSize = 256;
+
+	int32 WrapIndex(int32 Value, int32 Size)
+	{
+		const int32 Wrapped = Value % Size;
+		return Wrapped < 0 ? Wrapped + Size : Wrapped;
+	}
+
+	bool IsInWindow(const FIntVector& Node, const FIntVector& Origin, int32 Size)
+	{
+		return Node.X >= Origin.X && Node.X < Origin.X + Size
+			&& Node.Y >= Origin.Y && Node.Y < Origin.Y + Size
+			&& Node.Z >= Origin.Z && Node.Z < Origin.Z + Size;
+	}
+}
+
+void FGravityFieldClipmap::Configure(int32 InNumLevels, int32 InResolution, double InFinestCellSize)
+{
+	Resolution = FMath::Max(InResolution, 2);
+	Levels.SetNum(FMath::Max(InNumLevels, 1));
+
+	const int32 NumNodes = Resolution * Resolution * Resolution;
+	double CellSize = FMath::Max(InFinestCellSize, 1.0);
+
+	for (FLevel& Level : Levels)
+	{
+		Level.CellSize = CellSize;
+		Level.Origin = FIntVector::ZeroValue;
+		Level.bValid = false;
+		Level.Accelerations.SetNumZeroed(NumNodes);
+		Level.BodyPositions.Reset();
+		CellSize *= 2.0;
+	}
+
+	RefreshLevel = 0;
+	RefreshCursor = 0;
+}
+
+bool FGravityFieldClipmap::IsConfiguredFor(int32 InNumLevels, int32 InResolution, double InFinestCellSize) const
+{
+	return Levels.Num() == FMath::Max(InNumLevels, 1)
+		&& Resolution == FMath::Max(InResolution, 2)
+		&& Levels[0].CellSize == FMath::Max(InFinestCellSize, 1.0);
+}
+
+void FGravityFieldClipmap::Invalidate()
+{
+	for (FLevel& Level : Levels)
+	{
+		Level.bValid = false;
+	}
+}
+
+int32 FGravityFieldClipmap::Update(const FGravityBodySnapshot& Snapshot, const GravityKernels::FGravityKernelParams& Params,
+	const FVector& Center, int32 RefreshBudget)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityFieldClipmap::Update);
+
+	if (Levels.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Body set or model changed: nothing cached is meaningful any more
+	if (Snapshot.Params.Mode != BuiltMode || Snapshot.RegistryGeneration != BuiltRegistryGeneration)
+	{
+		Invalidate();
+		BuiltMode = Snapshot.Params.Mode;
+		BuiltRegistryGeneration = Snapshot.RegistryGeneration;
+	}
+
+	PendingPositions.Reset();
+	PendingLevels.Reset();
+	PendingSlots.Reset();
+
+	const int32 HalfResolution = Resolution / 2;
+
+	for (int32 LevelIndex = 0; LevelIndex < Levels.Num(); ++LevelIndex)
+	{
+		FLevel& Level = Levels[LevelIndex];
+
+		// Orbiting bodies and origin shifts move the sources under the cached nodes
+		if (Level.bValid && HaveBodiesMoved(Level, Snapshot))
+		{
+			Level.bValid = false;
+		}
+
+		const FIntVector NewOrigin(
+			FMath::FloorToInt32(Center.X / Level.CellSize) - HalfResolution,
+			FMath::FloorToInt32(Center.Y / Level.CellSize) - HalfResolution,
+			FMath::FloorToInt32(Center.Z / Level.CellSize) - HalfResolution);
+
+		if (Level.bValid && NewOrigin == Level.Origin)
+		{
+			continue;
+		}
+
+		// Only nodes that were outside the previous window need evaluating
+		const bool bFullRebuild = !Level.bValid;
+		const FIntVector OldOrigin = Level.Origin;
+
+		for (int32 Z = 0; Z < Resolution; ++Z)
+		{
+			for (int32 Y = 0; Y < Resolution; ++Y)
+			{
+				for (int32 X = 0; X < Resolution; ++X)
+				{
+					const FIntVector Node = NewOrigin + FIntVector(X, Y, Z);
+					if (bFullRebuild || !IsInWindow(Node, OldOrigin, Resolution))
+					{
+						QueueNode(LevelIndex, Node);
+					}
+				}
+			}
+		}
+
+		if (bFullRebuild)
+		{
+			Level.BodyPositions.Reset(Snapshot.Num());
+			for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+			{
+				Level.BodyPositions.Add(Snapshot.GetPosition(BodyIndex));
+			}
+		}
+
+		Level.Origin = NewOrigin;
+		Level.bValid = true;
+	}
+
+	// Spend the remaining budget refreshing the oldest nodes so the field follows moving bodies
+	const int32 NumNodesPerLevel = Resolution * Resolution * Resolution;
+	for (int32 Refreshed = 0; Refreshed < RefreshBudget; ++Refreshed)
+	{
+		QueueNode(RefreshLevel, GetNodeForStorageIndex(Levels[RefreshLevel], RefreshCursor));
+
+		if (++RefreshCursor == NumNodesPerLevel)
+		{
+			RefreshCursor = 0;
+			RefreshLevel = (RefreshLevel + 1) % Levels.Num();
+		}
+	}
+
+	const int32 NumEvaluated = PendingPositions.Num();
+	FlushPending(Snapshot.Params.Mode, Snapshot, Params);
+
+	return NumEvaluated;
+}
+
+bool FGravityFieldClipmap::Sample(const FVector& Position, FVector& OutAcceleration) const
+{
+	for (const FLevel& Level : Levels)
+	{
+		if (!Level.bValid)
+		{
+			continue;
+		}
+
+		const FVector Scaled = Position / Level.CellSize;
+		const FIntVector Base(FMath::FloorToInt32(Scaled.X), FMath::FloorToInt32(Scaled.Y), FMath::FloorToInt32(Scaled.Z));
+
+		// Both corners of the interpolation cell must be inside the window
+		if (!IsInWindow(Base, Level.Origin, Resolution - 1))
+		{
+			continue;
+		}
+
+		const FVector Alpha = Scaled - FVector(Base);
+		const TArray<FVector>& Field = Level.Accelerations;
+
+		const FVector C00 = FMath::Lerp(Field[GetStorageIndex(Base)], Field[GetStorageIndex(Base + FIntVector(1, 0, 0))], Alpha.X);
+		const FVector C10 = FMath::Lerp(Field[GetStorageIndex(Base + FIntVector(0, 1, 0))], Field[GetStorageIndex(Base + FIntVector(1, 1, 0))], Alpha.X);
+		const FVector C01 = FMath::Lerp(Field[GetStorageIndex(Base + FIntVector(0, 0, 1))], Field[GetStorageIndex(Base + FIntVector(1, 0, 1))], Alpha.X);
+		const FVector C11 = FMath::Lerp(Field[GetStorageIndex(Base + FIntVector(0, 1, 1))], Field[GetStorageIndex(Base + FIntVector(1, 1, 1))], Alpha.X);
+
+		OutAcceleration = FMath::Lerp(FMath::Lerp(C00, C10, Alpha.Y), FMath::Lerp(C01, C11, Alpha.Y), Alpha.Z);
+		return true;
+	}
+
+	return false;
+}
+
+bool FGravityFieldClipmap::HaveBodiesMoved(const FLevel& Level, const FGravityBodySnapshot& Snapshot) const
+{
+	if (Level.BodyPositions.Num() != Snapshot.Num())
+	{
+		return true;
+	}
+
+	const FBox Bounds(FVector(Level.Origin) * Level.CellSize, FVector(Level.Origin + FIntVector(Resolution - 1)) * Level.CellSize);
+
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+	{
+		if (!Snapshot.IsValidIndex(BodyIndex))
+		{
+			continue;
+		}
+
+		// Relative acceleration error grows with displacement over distance; nodes inside a cell of the body are softened anyway
+		const FVector Position = Snapshot.GetPosition(BodyIndex);
+		const double Distance = FMath::Max(FMath::Sqrt(Bounds.ComputeSquaredDistanceToPoint(Position)), Level.CellSize);
+		if (FVector::DistSquared(Position, Level.BodyPositions[BodyIndex]) > FMath::Square(BodyMoveTolerance * Distance))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32 FGravityFieldClipmap::GetStorageIndex(const FIntVector& Node) const
+{
+	return (WrapIndex(Node.Z, Resolution) * Resolution + WrapIndex(Node.Y, Resolution)) * Resolution + WrapIndex(Node.X, Resolution);
+}
+
+FIntVector FGravityFieldClipmap::GetNodeForStorageIndex(const FLevel& Level, int32 StorageIndex) const
+{
+	const int32 SlotX = StorageIndex % Resolution;
+	const int32 SlotY = (StorageIndex / Resolution) % Resolution;
+	const int32 SlotZ = StorageIndex / (Resolution * Resolution);
+
+	return FIntVector(
+		Level.Origin.X + WrapIndex(SlotX - Level.Origin.X, Resolution),
+		Level.Origin.Y + WrapIndex(SlotY - Level.Origin.Y, Resolution),
+		Level.Origin.Z + WrapIndex(SlotZ - Level.Origin.Z, Resolution));
+}
+
+void FGravityFieldClipmap::QueueNode(int32 LevelIndex, const FIntVector& Node)
+{
+	PendingPositions.Add(FVector(Node) * Levels[LevelIndex].CellSize);
+	PendingLevels.Add(LevelIndex);
+	PendingSlots.Add(GetStorageIndex(Node));
+}
+
+void FGravityFieldClipmap::FlushPending(EGravitySimulationMode Mode, const FGravityBodySnapshot& Snapshot, const GravityKernels::FGravityKernelParams& Params)
+{
+	const int32 NumPending = PendingPositions.Num();
+	if (NumPending == 0)
+	{
+		return;
+	}
+
+	PendingAccelerations.SetNumUninitialized(NumPending, EAllowShrinking::No);
+
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumPending, FieldBatchSize);
+	ParallelFor(NumBatches, [this, Mode, &Snapshot, &Params, NumPending](int32 BatchIndex)
+	{
+		const int32 Start = BatchIndex * FieldBatchSize;
+		const int32 Count = FMath::Min(FieldBatchSize, NumPending - Start);
+
+		GravityKernels::ComputeAccelerations(Mode, Snapshot, Params,
+			TArrayView<const FVector>(PendingPositions.GetData() + Start, Count),
+			TArrayView<FVector>(PendingAccelerations.GetData() + Start, Count));
+	});
+
+	for (int32 Index = 0; Index < NumPending; ++Index)
+	{
+		Levels[PendingLevels[Index]].Accelerations[PendingSlots[Index]] = PendingAccelerations[Index];
+	}
+}
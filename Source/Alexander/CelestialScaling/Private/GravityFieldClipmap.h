@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GravityKernels.h"
+
+struct FGravityBodySnapshot;
+
+/**
+ * Nested 3D acceleration grids centred on a point (the local player)
+ * Each level doubles the cell size of the one inside it. Levels are stored toroidally, so when the
+ * centre moves only the slabs of nodes that scroll into range are recomputed; a small per-update
+ * budget refreshes the rest round-robin to follow slow body motion. Each level remembers the body
+ * positions it was built from and is rebuilt once a body has moved far enough, relative to its
+ * distance from the level, to matter (orbits, origin shifts).
+ * Sampling is a trilinear read from the finest level that contains the position.
+ */
+class FGravityFieldClipmap
+{
+public:
+	/**
+	 * Set the clipmap layout; discards all cached accelerations
+	 * @param InNumLevels - Number of nested levels
+	 * @param InResolution - Nodes per axis per level
+	 * @param InFinestCellSize - Node spacing of the innermost level (Unreal units)
+	 */
+	void Configure(int32 InNumLevels, int32 InResolution, double InFinestCellSize);
+
+	/** Whether the layout matches and the clipmap can be updated without reconfiguring */
+	bool IsConfiguredFor(int32 InNumLevels, int32 InResolution, double InFinestCellSize) const;
+
+	/** Force every level to be recomputed on the next update */
+	void Invalidate();
+
+	/** Fraction of a body's distance from a level it may move before the level is rebuilt */
+	static constexpr double BodyMoveTolerance = 0.01;
+
+	/**
+	 * Recentre the levels and recompute the nodes that scrolled in, plus up to RefreshBudget stale nodes
+	 * A change of simulation mode or registry generation invalidates the whole clipmap; a body that
+	 * moved past BodyMoveTolerance invalidates the levels it affects
+	 * @return Number of nodes recomputed
+	 */
+	int32 Update(const FGravityBodySnapshot& Snapshot, const GravityKernels::FGravityKernelParams& Params, const FVector& Center, int32 RefreshBudget);
+
+	/**
+	 * Trilinearly interpolated acceleration (GM / r², same units as the kernels)
+	 * Safe to call from worker threads while no update is running
+	 * @return False if no level covers the position
+	 */
+	bool Sample(const FVector& Position, FVector& OutAcceleration) const;
+
+	/** Total number of nodes across all levels */
+	int32 GetNumNodes() const { return Levels.Num() * Resolution * Resolution * Resolution; }
+
+private:
+	struct FLevel
+	{
+		/** Node spacing (Unreal units) */
+		double CellSize = 0.0;
+
+		/** Node coordinates of the minimum corner of the level */
+		FIntVector Origin = FIntVector::ZeroValue;
+
+		/** Whether Origin and every node are up to date */
+		bool bValid = false;
+
+		/** Accelerations indexed toroidally by node coordinates */
+		TArray<FVector> Accelerations;
+
+		/** Snapshot body positions the level was last fully built from */
+		TArray<FVector> BodyPositions;
+	};
+
+	/** Whether any body moved far enough since the level was built to make its accelerations stale */
+	bool HaveBodiesMoved(const FLevel& Level, const FGravityBodySnapshot& Snapshot) const;
+
+	/** Storage slot of a node (coordinates wrap modulo Resolution) */
+	int32 GetStorageIndex(const FIntVector& Node) const;
+
+	/** Node inside a level's window that maps to a storage slot */
+	FIntVector GetNodeForStorageIndex(const FLevel& Level, int32 StorageIndex) const;
+
+	/** Queue a node for recomputation */
+	void QueueNode(int32 LevelIndex, const FIntVector& Node);
+
+	/** Evaluate all queued nodes in parallel and write them back */
+	void FlushPending(EGravitySimulationMode Mode, const FGravityBodySnapshot& Snapshot, const GravityKernels::FGravityKernelParams& Params);
+
+	TArray<FLevel> Levels;
+	int32 Resolution = 0;
+
+	/** Settings the cached accelerations were computed with */
+	EGravitySimulationMode BuiltMode{};
+	uint32 BuiltRegistryGeneration = 0;
+
+	/** Round-robin refresh position */
+	int32 RefreshLevel = 0;
+	int32 RefreshCursor = 0;
+
+	/** Nodes awaiting evaluation, reused between updates */
+	TArray<FVector> PendingPositions;
+	TArray<FVector> PendingAccelerations;
+	TArray<int32> PendingLevels;
+	TArray<int32> PendingSlots;
+};
@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityKepler.h"
+#include "CelestialScalingTypes.h"
+
+namespace GravityKepler
+{
+	namespace
+	{
+		constexpr int32 MaxNewtonIterations = 16;
+		constexpr double NewtonTolerance = 1.0e-12;
+
+		/** Below this eccentricity the periapsis direction is undefined and the current position is used instead */
+		constexpr double CircularEccentricity = 1.0e-8;
+	}
+
+	bool MakeOrbit(const FKeplerOrbitElements& Elements, double Mu, double Epoch, FOrbit& OutOrbit)
+	{
+		if (Elements.SemiMajorAxis <= 0.0 || Elements.Eccentricity < 0.0 || Elements.Eccentricity >= MaxEccentricity || Mu <= 0.0)
+		{
+			return false;
+		}
+
+		double SinNode, CosNode, SinInclination, CosInclination, SinPeriapsis, CosPeriapsis;
+		FMath::SinCos(&SinNode, &CosNode, FMath::DegreesToRadians(Elements.LongitudeOfAscendingNode));
+		FMath::SinCos(&SinInclination, &CosInclination, FMath::DegreesToRadians(Elements.Inclination));
+		FMath::SinCos(&SinPeriapsis, &CosPeriapsis, FMath::DegreesToRadians(Elements.ArgumentOfPeriapsis));
+
+		// Perifocal axes rotated by node, inclination and argument of periapsis
+		OutOrbit.P = FVector(
+			CosNode * CosPeriapsis - SinNode * SinPeriapsis * CosInclination,
+			SinNode * CosPeriapsis + CosNode * SinPeriapsis * CosInclination,
+			SinPeriapsis * SinInclination);
+		OutOrbit.Q = FVector(
+			-CosNode * SinPeriapsis - SinNode * CosPeriapsis * CosInclination,
+			-SinNode * SinPeriapsis + CosNode * CosPeriapsis * CosInclination,
+			CosPeriapsis * SinInclination);
+
+		OutOrbit.SemiMajorAxis = Elements.SemiMajorAxis;
+		OutOrbit.Eccentricity = Elements.Eccentricity;
+		OutOrbit.MeanMotion = FMath::Sqrt(Mu / (Elements.SemiMajorAxis * Elements.SemiMajorAxis * Elements.SemiMajorAxis));
+		OutOrbit.MeanAnomalyAtEpoch = FMath::DegreesToRadians(Elements.MeanAnomalyAtEpoch);
+		OutOrbit.Epoch = Epoch;
+		OutOrbit.CachedEccentricAnomaly = SolveKepler(OutOrbit.MeanAnomalyAtEpoch, OutOrbit.Eccentricity, OutOrbit.MeanAnomalyAtEpoch);
+		return true;
+	}
+
+	bool FitOrbit(const FVector& RelativePosition, const FVector& RelativeVelocity, double Mu, double Epoch, FOrbit& OutOrbit)
+	{
+		const double Radius = RelativePosition.Size();
+		const FVector AngularMomentum = FVector::CrossProduct(RelativePosition, RelativeVelocity);
+
+		if (Mu <= 0.0 || Radius <= UE_DOUBLE_SMALL_NUMBER || AngularMomentum.IsNearlyZero(UE_DOUBLE_SMALL_NUMBER))
+		{
+			return false;
+		}
+
+		// Unbound orbits have no semi-major axis to put on rails
+		const double SpeedSquared = RelativeVelocity.SizeSquared();
+		const double SpecificEnergy = 0.5 * SpeedSquared - Mu / Radius;
+		if (SpecificEnergy >= 0.0)
+		{
+			return false;
+		}
+
+		const FVector EccentricityVector = ((SpeedSquared - Mu / Radius) * RelativePosition - FVector::DotProduct(RelativePosition, RelativeVelocity) * RelativeVelocity) / Mu;
+		const double Eccentricity = EccentricityVector.Size();
+		if (Eccentricity >= MaxEccentricity)
+		{
+			return false;
+		}
+
+		const double SemiMajorAxis = -Mu / (2.0 * SpecificEnergy);
+		const FVector Normal = AngularMomentum.GetUnsafeNormal();
+
+		OutOrbit.P = Eccentricity > CircularEccentricity ? EccentricityVector / Eccentricity : RelativePosition / Radius;
+		OutOrbit.Q = FVector::CrossProduct(Normal, OutOrbit.P);
+
+		// Eccentric anomaly from the position in the perifocal frame
+		const double SemiMinorAxis = SemiMajorAxis * FMath::Sqrt(1.0 - Eccentricity * Eccentricity);
+		const double EccentricAnomaly = FMath::Atan2(
+			FVector::DotProduct(RelativePosition, OutOrbit.Q) / SemiMinorAxis,
+			FVector::DotProduct(RelativePosition, OutOrbit.P) / SemiMajorAxis + Eccentricity);
+
+		OutOrbit.SemiMajorAxis = SemiMajorAxis;
+		OutOrbit.Eccentricity = Eccentricity;
+		OutOrbit.MeanMotion = FMath::Sqrt(Mu / (SemiMajorAxis * SemiMajorAxis * SemiMajorAxis));
+		OutOrbit.MeanAnomalyAtEpoch = EccentricAnomaly - Eccentricity * FMath::Sin(EccentricAnomaly);
+		OutOrbit.Epoch = Epoch;
+		OutOrbit.CachedEccentricAnomaly = EccentricAnomaly;
+		return true;
+	}
+
+	double SolveKepler(double MeanAnomaly, double Eccentricity, double Guess)
+	{
+		const double M = FMath::UnwindRadians(MeanAnomaly);
+		double E = M + FMath::UnwindRadians(Guess - M);
+
+		// A stale guess (time jump) is worse than the standard starting points
+		if (FMath::Abs(E - M) > 1.0)
+		{
+			E = Eccentricity > 0.8 ? (M < 0.0 ? -UE_DOUBLE_PI : UE_DOUBLE_PI) : M;
+		}
+
+		for (int32 Iteration = 0; Iteration < MaxNewtonIterations; ++Iteration)
+		{
+			const double Delta = (E - Eccentricity * FMath::Sin(E) - M) / (1.0 - Eccentricity * FMath::Cos(E));
+			E -= Delta;
+
+			if (FMath::Abs(Delta) < NewtonTolerance)
+			{
+				break;
+			}
+		}
+
+		return E;
+	}
+
+	void Evaluate(FOrbit& Orbit, double Time, FVector& OutPosition, FVector& OutVelocity)
+	{
+		const double MeanAnomaly = Orbit.MeanAnomalyAtEpoch + Orbit.MeanMotion * (Time - Orbit.Epoch);
+		const double E = SolveKepler(MeanAnomaly, Orbit.Eccentricity, Orbit.CachedEccentricAnomaly);
+		Orbit.CachedEccentricAnomaly = E;
+
+		double SinE, CosE;
+		FMath::SinCos(&SinE, &CosE, E);
+
+		const double SemiMinorAxis = Orbit.SemiMajorAxis * FMath::Sqrt(1.0 - Orbit.Eccentricity * Orbit.Eccentricity);
+		const double EccentricAnomalyRate = Orbit.MeanMotion / (1.0 - Orbit.Eccentricity * CosE);
+
+		OutPosition = Orbit.P * (Orbit.SemiMajorAxis * (CosE - Orbit.Eccentricity)) + Orbit.Q * (SemiMinorAxis * SinE);
+		OutVelocity = (Orbit.P * (-Orbit.SemiMajorAxis * SinE) + Orbit.Q * (SemiMinorAxis * CosE)) * EccentricAnomalyRate;
+	}
+}
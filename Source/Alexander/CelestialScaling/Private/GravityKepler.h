@@ -0,0 +1,67 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FKeplerOrbitElements;
+
+/**
+ * Closed-form two-body propagation for elliptic orbits
+ * Positions and velocities are relative to the parent body, in Unreal units and Unreal units per second
+ */
+namespace GravityKepler
+{
+	/** Elliptic orbit in perifocal-vector form, ready for O(1) evaluation */
+	struct FOrbit
+	{
+		double SemiMajorAxis = 0.0;
+		double Eccentricity = 0.0;
+
+		/** Mean motion (radians per second) */
+		double MeanMotion = 0.0;
+
+		/** Mean anomaly at Epoch (radians) */
+		double MeanAnomalyAtEpoch = 0.0;
+
+		/** Simulation time the orbit was fitted at (seconds) */
+		double Epoch = 0.0;
+
+		/** Unit vector towards periapsis */
+		FVector P = FVector::XAxisVector;
+
+		/** Unit vector in the orbit plane 90 degrees ahead of P */
+		FVector Q = FVector::YAxisVector;
+
+		/** Eccentric anomaly of the last evaluation, used to warm-start the next solve */
+		double CachedEccentricAnomaly = 0.0;
+
+		bool IsValid() const { return MeanMotion > 0.0; }
+	};
+
+	/** Orbits at or above this eccentricity are left to numerical integration */
+	constexpr double MaxEccentricity = 0.99;
+
+	/**
+	 * Build an orbit from designer-facing elements
+	 * @param Mu - Gravitational parameter of parent plus body, in the caller's acceleration scale
+	 * @param Epoch - Simulation time the mean anomaly refers to
+	 * @return False if the elements do not describe a bound elliptic orbit
+	 */
+	bool MakeOrbit(const FKeplerOrbitElements& Elements, double Mu, double Epoch, FOrbit& OutOrbit);
+
+	/**
+	 * Fit the osculating orbit to a relative state vector
+	 * @return False if the state is unbound, degenerate or too eccentric for rails
+	 */
+	bool FitOrbit(const FVector& RelativePosition, const FVector& RelativeVelocity, double Mu, double Epoch, FOrbit& OutOrbit);
+
+	/** Solve M = E - e sin E for E with Newton's method, starting from Guess */
+	double SolveKepler(double MeanAnomaly, double Eccentricity, double Guess);
+
+	/**
+	 * Evaluate the orbit at a simulation time
+	 * Updates the orbit's cached eccentric anomaly, so evaluations at nearby times converge in one or two iterations
+	 */
+	void Evaluate(FOrbit& Orbit, double Time, FVector& OutPosition, FVector& OutVelocity);
+}
@@ -0,0 +1,328 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityKernels.h"
+#include "GravityBodySnapshot.h"
+#include "GravityOctree.h"
+#include "GravitySOITree.h"
+#include "GravityStats.h"
+#include "Math/VectorRegister.h"
+
+namespace GravityKernels
+{
+	namespace
+	{
+		/** Targets evaluated per vector register */
+		constexpr int32 LaneCount = 4;
+
+		/** Distances below this are treated as coincident (matches FVector::GetSafeNormal) */
+		constexpr double CoincidentDistance = 1.0e-4;
+
+		FORCEINLINE VectorRegister4Double Splat(double Value)
+		{
+			return MakeVectorRegisterDouble(Value, Value, Value, Value);
+		}
+
+		/** Gather up to four targets into lane arrays, repeating the last target in unused lanes */
+		FORCEINLINE int32 LoadTargetLanes(TArrayView<const FVector> Targets, int32 Base,
+			VectorRegister4Double& OutX, VectorRegister4Double& OutY, VectorRegister4Double& OutZ)
+		{
+			const int32 LaneNum = FMath::Min(LaneCount, Targets.Num() - Base);
+
+			alignas(32) double X[LaneCount];
+			alignas(32) double Y[LaneCount];
+			alignas(32) double Z[LaneCount];
+
+			for (int32 Lane = 0; Lane < LaneCount; ++Lane)
+			{
+				const FVector& Target = Targets[Base + FMath::Min(Lane, LaneNum - 1)];
+				X[Lane] = Target.X;
+				Y[Lane] = Target.Y;
+				Z[Lane] = Target.Z;
+			}
+
+			OutX = VectorLoadAligned(X);
+			OutY = VectorLoadAligned(Y);
+			OutZ = VectorLoadAligned(Z);
+
+			return LaneNum;
+		}
+
+		/** Acceleration towards a single snapshot body */
+		FORCEINLINE FVector AccelerationFromBody(const FGravityBodySnapshot& Snapshot, int32 BodyIndex, const FVector& Position, double MinDistanceSquared)
+		{
+			const FVector Delta = Snapshot.GetPosition(BodyIndex) - Position;
+			const double DistanceSquared = Delta.SizeSquared();
+
+			if (DistanceSquared < CoincidentDistance * CoincidentDistance)
+			{
+				return FVector::ZeroVector;
+			}
+
+			const double Distance = FMath::Sqrt(DistanceSquared);
+			return Delta * (Snapshot.GM[BodyIndex] / (FMath::Max(DistanceSquared, MinDistanceSquared) * Distance));
+		}
+
+		/** Exact sum over every valid body */
+		void ComputeNBody(const FGravityBodySnapshot& Snapshot, const FGravityKernelParams& Params,
+			TArrayView<const FVector> Targets, TArrayView<FVector> OutAccelerations)
+		{
+			const VectorRegister4Double MinDistanceSquared = Splat(Params.MinDistanceSquared);
+			const VectorRegister4Double Coincident = Splat(CoincidentDistance);
+			const VectorRegister4Double Zero = Splat(0.0);
+
+			for (int32 Base = 0; Base < Targets.Num(); Base += LaneCount)
+			{
+				VectorRegister4Double TargetX, TargetY, TargetZ;
+				const int32 LaneNum = LoadTargetLanes(Targets, Base, TargetX, TargetY, TargetZ);
+
+				VectorRegister4Double AccX = Zero;
+				VectorRegister4Double AccY = Zero;
+				VectorRegister4Double AccZ = Zero;
+
+				for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+				{
+					if (!Snapshot.ValidMask[BodyIndex])
+					{
+						continue;
+					}
+
+					const VectorRegister4Double DX = VectorSubtract(Splat(Snapshot.PositionX[BodyIndex]), TargetX);
+					const VectorRegister4Double DY = VectorSubtract(Splat(Snapshot.PositionY[BodyIndex]), TargetY);
+					const VectorRegister4Double DZ = VectorSubtract(Splat(Snapshot.PositionZ[BodyIndex]), TargetZ);
+
+					const VectorRegister4Double DistanceSquared = VectorMultiplyAdd(DZ, DZ, VectorMultiplyAdd(DY, DY, VectorMultiply(DX, DX)));
+					const VectorRegister4Double Distance = VectorMax(VectorSqrt(DistanceSquared), Coincident);
+
+					// GM / (max(r², min²) * r) scales the unnormalised delta; coincident targets have a zero delta
+					const VectorRegister4Double Scale = VectorDivide(Splat(Snapshot.GM[BodyIndex]),
+						VectorMultiply(VectorMax(DistanceSquared, MinDistanceSquared), Distance));
+
+					AccX = VectorMultiplyAdd(DX, Scale, AccX);
+					AccY = VectorMultiplyAdd(DY, Scale, AccY);
+					AccZ = VectorMultiplyAdd(DZ, Scale, AccZ);
+				}
+
+				alignas(32) double OutX[LaneCount];
+				alignas(32) double OutY[LaneCount];
+				alignas(32) double OutZ[LaneCount];
+				VectorStoreAligned(AccX, OutX);
+				VectorStoreAligned(AccY, OutY);
+				VectorStoreAligned(AccZ, OutZ);
+
+				for (int32 Lane = 0; Lane < LaneNum; ++Lane)
+				{
+					OutAccelerations[Base + Lane] = FVector(OutX[Lane], OutY[Lane], OutZ[Lane]);
+				}
+			}
+		}
+
+		/** Dominant body only: SOI descent, or the strongest body selected per lane without branches */
+		void ComputeSingleBody(const FGravityBodySnapshot& Snapshot, const FGravityKernelParams& Params,
+			TArrayView<const FVector> Targets, TArrayView<FVector> OutAccelerations, TArrayView<FGravityDominantBodyCache> DominantBodies)
+		{
+			// SOI descent, revalidated from the receiver's last dominant body when it has one
+			if (Snapshot.SOITree.IsValid() && Snapshot.SOITree->GetNumBodies() > 0)
+			{
+				for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+				{
+					const int32 DominantIndex = DominantBodies.Num() > 0
+						? Snapshot.SOITree->FindDominantBody(Snapshot, Targets[TargetIndex], Params.DominantBodyHysteresis, DominantBodies[TargetIndex])
+						: Snapshot.SOITree->FindDominantBody(Snapshot, Targets[TargetIndex]);
+
+					OutAccelerations[TargetIndex] = DominantIndex != INDEX_NONE
+						? AccelerationFromBody(Snapshot, DominantIndex, Targets[TargetIndex], Params.MinDistanceSquared)
+						: FVector::ZeroVector;
+				}
+				return;
+			}
+
+			const VectorRegister4Double MinDistanceSquared = Splat(Params.MinDistanceSquared);
+
+			for (int32 Base = 0; Base < Targets.Num(); Base += LaneCount)
+			{
+				VectorRegister4Double TargetX, TargetY, TargetZ;
+				const int32 LaneNum = LoadTargetLanes(Targets, Base, TargetX, TargetY, TargetZ);
+
+				VectorRegister4Double BestInfluence = Splat(0.0);
+				VectorRegister4Double BestIndex = Splat(-1.0);
+
+				for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+				{
+					if (!Snapshot.ValidMask[BodyIndex])
+					{
+						continue;
+					}
+
+					const VectorRegister4Double DX = VectorSubtract(Splat(Snapshot.PositionX[BodyIndex]), TargetX);
+					const VectorRegister4Double DY = VectorSubtract(Splat(Snapshot.PositionY[BodyIndex]), TargetY);
+					const VectorRegister4Double DZ = VectorSubtract(Splat(Snapshot.PositionZ[BodyIndex]), TargetZ);
+
+					const VectorRegister4Double DistanceSquared = VectorMultiplyAdd(DZ, DZ, VectorMultiplyAdd(DY, DY, VectorMultiply(DX, DX)));
+					const VectorRegister4Double Influence = VectorDivide(Splat(Snapshot.GM[BodyIndex]), VectorMax(DistanceSquared, MinDistanceSquared));
+
+					const VectorRegister4Double IsStronger = VectorCompareGT(Influence, BestInfluence);
+					BestInfluence = VectorSelect(IsStronger, Influence, BestInfluence);
+					BestIndex = VectorSelect(IsStronger, Splat(static_cast<double>(BodyIndex)), BestIndex);
+				}
+
+				alignas(32) double Indices[LaneCount];
+				VectorStoreAligned(BestIndex, Indices);
+
+				for (int32 Lane = 0; Lane < LaneNum; ++Lane)
+				{
+					const int32 DominantIndex = static_cast<int32>(Indices[Lane]);
+					OutAccelerations[Base + Lane] = DominantIndex >= 0
+						? AccelerationFromBody(Snapshot, DominantIndex, Targets[Base + Lane], Params.MinDistanceSquared)
+						: FVector::ZeroVector;
+				}
+			}
+		}
+
+		/** Sum of the dominant body's SOI chain (or the N strongest bodies) per target */
+		void ComputeMultiBody(const FGravityBodySnapshot& Snapshot, const FGravityKernelParams& Params,
+			TArrayView<const FVector> Targets, TArrayView<FVector> OutAccelerations, TArrayView<FGravityDominantBodyCache> DominantBodies)
+		{
+			constexpr int32 MaxTrackedBodies = 8;
+			const int32 MaxBodies = FMath::Clamp(Params.MaxInfluencingBodies, 1, MaxTrackedBodies);
+
+			// Dominant body and its SOI ancestors: one tree descent per target
+			if (Snapshot.SOITree.IsValid())
+			{
+				TArray<int32, TInlineAllocator<8>> Chain;
+
+				for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+				{
+					if (DominantBodies.Num() > 0)
+					{
+						Snapshot.SOITree->GetInfluenceChain(Snapshot, Targets[TargetIndex], MaxBodies, Params.DominantBodyHysteresis, DominantBodies[TargetIndex], Chain);
+					}
+					else
+					{
+						Snapshot.SOITree->GetInfluenceChain(Snapshot, Targets[TargetIndex], MaxBodies, Chain);
+					}
+
+					FVector Acceleration = FVector::ZeroVector;
+					for (int32 BodyIndex : Chain)
+					{
+						Acceleration += AccelerationFromBody(Snapshot, BodyIndex, Targets[TargetIndex], Params.MinDistanceSquared);
+					}
+
+					OutAccelerations[TargetIndex] = Acceleration;
+				}
+				return;
+			}
+
+			for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+			{
+				const FVector& Target = Targets[TargetIndex];
+
+				double TopInfluence[MaxTrackedBodies];
+				int32 TopIndex[MaxTrackedBodies];
+				int32 TopNum = 0;
+
+				for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+				{
+					const double DX = Snapshot.PositionX[BodyIndex] - Target.X;
+					const double DY = Snapshot.PositionY[BodyIndex] - Target.Y;
+					const double DZ = Snapshot.PositionZ[BodyIndex] - Target.Z;
+					const double Influence = Snapshot.GM[BodyIndex] / FMath::Max(DX * DX + DY * DY + DZ * DZ, Params.MinDistanceSquared);
+
+					if (Influence <= 0.0 || (TopNum == MaxBodies && Influence <= TopInfluence[TopNum - 1]))
+					{
+						continue;
+					}
+
+					// Insertion into a tiny sorted list
+					int32 InsertAt = FMath::Min(TopNum, MaxBodies - 1);
+					while (InsertAt > 0 && TopInfluence[InsertAt - 1] < Influence)
+					{
+						TopInfluence[InsertAt] = TopInfluence[InsertAt - 1];
+						TopIndex[InsertAt] = TopIndex[InsertAt - 1];
+						--InsertAt;
+					}
+
+					TopInfluence[InsertAt] = Influence;
+					TopIndex[InsertAt] = BodyIndex;
+					TopNum = FMath::Min(TopNum + 1, MaxBodies);
+				}
+
+				FVector Acceleration = FVector::ZeroVector;
+				for (int32 Slot = 0; Slot < TopNum; ++Slot)
+				{
+					Acceleration += AccelerationFromBody(Snapshot, TopIndex[Slot], Target, Params.MinDistanceSquared);
+				}
+
+				OutAccelerations[TargetIndex] = Acceleration;
+			}
+		}
+	}
+
+	void ComputeAccelerations(EGravitySimulationMode Mode, const FGravityBodySnapshot& Snapshot, const FGravityKernelParams& Params,
+		TArrayView<const FVector> TargetPositions, TArrayView<FVector> OutAccelerations, TArrayView<FGravityDominantBodyCache> DominantBodies)
+	{
+		check(TargetPositions.Num() == OutAccelerations.Num());
+		check(DominantBodies.Num() == 0 || DominantBodies.Num() == TargetPositions.Num());
+
+		if (TargetPositions.Num() == 0)
+		{
+			return;
+		}
+
+		if (Snapshot.Num() == 0)
+		{
+			for (FVector& Acceleration : OutAccelerations)
+			{
+				Acceleration = FVector::ZeroVector;
+			}
+			return;
+		}
+
+		switch (Mode)
+		{
+		case EGravitySimulationMode::SingleBody:
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GravitySingleBody);
+			TRACE_CPUPROFILER_EVENT_SCOPE(GravityKernels::SingleBody);
+			ComputeSingleBody(Snapshot, Params, TargetPositions, OutAccelerations, DominantBodies);
+			break;
+		}
+
+		case EGravitySimulationMode::MultiBody:
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GravityMultiBody);
+			TRACE_CPUPROFILER_EVENT_SCOPE(GravityKernels::MultiBody);
+			ComputeMultiBody(Snapshot, Params, TargetPositions, OutAccelerations, DominantBodies);
+			break;
+		}
+
+		case EGravitySimulationMode::NBody:
+			if (Snapshot.Octree.IsValid())
+			{
+				SCOPE_CYCLE_COUNTER(STAT_GravityBarnesHut);
+				TRACE_CPUPROFILER_EVENT_SCOPE(GravityKernels::BarnesHut);
+
+				// Tree walk per target; far clusters collapse so no distance cutoff is applied
+				for (int32 TargetIndex = 0; TargetIndex < TargetPositions.Num(); ++TargetIndex)
+				{
+					OutAccelerations[TargetIndex] = Snapshot.Octree->CalculateAcceleration(
+						TargetPositions[TargetIndex], Params.OpeningAngle, Params.MinDistanceSquared);
+				}
+			}
+			else
+			{
+				SCOPE_CYCLE_COUNTER(STAT_GravityNBody);
+				TRACE_CPUPROFILER_EVENT_SCOPE(GravityKernels::NBody);
+				ComputeNBody(Snapshot, Params, TargetPositions, OutAccelerations);
+			}
+			break;
+
+		case EGravitySimulationMode::Disabled:
+		default:
+			for (FVector& Acceleration : OutAccelerations)
+			{
+				Acceleration = FVector::ZeroVector;
+			}
+			break;
+		}
+	}
+}
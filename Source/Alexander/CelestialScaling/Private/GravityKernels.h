@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GravitySimulator.h"
+
+struct FGravityBodySnapshot;
+
+/**
+ * Batched gravity kernels operating on a body snapshot
+ * Targets are processed four at a time in VectorRegister4Double lanes (AVX2 / NEON)
+ * against the snapshot's contiguous body arrays
+ */
+namespace GravityKernels
+{
+	/** Parameters shared by every target in a batch */
+	struct FGravityKernelParams
+	{
+		/** Squared minimum distance used to clamp singularities */
+		double MinDistanceSquared = 1.0;
+
+		/** Number of bodies summed per target in MultiBody mode */
+		int32 MaxInfluencingBodies = 3;
+
+		/** Barnes-Hut opening angle used when the snapshot carries an octree */
+		double OpeningAngle = 0.5;
+
+		/** SOI hysteresis band used when revalidating cached dominant bodies */
+		double DominantBodyHysteresis = 0.05;
+	};
+
+	/**
+	 * Compute gravitational acceleration (GM / r², towards each body) for every target
+	 * Dispatches once per batch to the kernel specialised for the simulation mode
+	 * @param Mode - Simulation mode (Disabled writes zero accelerations)
+	 * @param Snapshot - Bodies to evaluate against
+	 * @param Params - Distance clamps and mode tuning
+	 * @param TargetPositions - Target positions in Unreal units
+	 * @param OutAccelerations - One acceleration per target, must match TargetPositions in size
+	 * @param DominantBodies - Optional per-target dominant-body caches used by SingleBody and MultiBody modes
+	 */
+	void ComputeAccelerations(EGravitySimulationMode Mode, const FGravityBodySnapshot& Snapshot, const FGravityKernelParams& Params,
+		TArrayView<const FVector> TargetPositions, TArrayView<FVector> OutAccelerations,
+		TArrayView<FGravityDominantBodyCache> DominantBodies = TArrayView<FGravityDominantBodyCache>());
+}
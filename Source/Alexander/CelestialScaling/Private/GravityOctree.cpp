@@ -0,0 +1,190 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityOctree.h"
+#include "GravityBodySnapshot.h"
+#include "GravityStats.h"
+
+void FGravityOctree::Build(const FGravityBodySnapshot& Snapshot)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityOctree::Build);
+
+	Nodes.Reset();
+	BodyPosition.Reset(Snapshot.Num());
+	BodyGM.Reset(Snapshot.Num());
+
+	FBox Bounds(ForceInit);
+
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+	{
+		if (!Snapshot.IsValidIndex(BodyIndex))
+		{
+			continue;
+		}
+
+		const FVector Position = Snapshot.GetPosition(BodyIndex);
+		BodyPosition.Add(Position);
+		BodyGM.Add(Snapshot.GM[BodyIndex]);
+		Bounds += Position;
+	}
+
+	if (BodyGM.Num() == 0)
+	{
+		return;
+	}
+
+	// Cube around all bodies, padded so bodies on the boundary fall inside
+	const double HalfSize = FMath::Max(Bounds.GetExtent().GetMax(), 1.0) * 1.001;
+
+	ScratchPosition.SetNumUninitialized(BodyPosition.Num(), EAllowShrinking::No);
+	ScratchGM.SetNumUninitialized(BodyGM.Num(), EAllowShrinking::No);
+
+	Nodes.AddDefaulted();
+	BuildNode(0, 0, BodyGM.Num(), Bounds.GetCenter(), HalfSize, 0);
+}
+
+void FGravityOctree::BuildNode(int32 NodeIndex, int32 Begin, int32 End, const FVector& Center, double HalfSize, int32 Depth)
+{
+	// Aggregate mass for this node
+	double TotalGM = 0.0;
+	FVector WeightedPosition = FVector::ZeroVector;
+
+	for (int32 Index = Begin; Index < End; ++Index)
+	{
+		TotalGM += BodyGM[Index];
+		WeightedPosition += BodyPosition[Index] * BodyGM[Index];
+	}
+
+	{
+		FNode& Node = Nodes[NodeIndex];
+		Node.GM = TotalGM;
+		Node.CenterOfMass = TotalGM > 0.0 ? WeightedPosition / TotalGM : Center;
+		Node.Size = HalfSize * 2.0;
+		Node.FirstBody = Begin;
+		Node.NumBodies = End - Begin;
+	}
+
+	if (End - Begin <= MaxLeafBodies || Depth >= MaxDepth)
+	{
+		return;
+	}
+
+	// Counting sort of the range into octants
+	auto OctantOf = [&Center](const FVector& Position)
+	{
+		return (Position.X >= Center.X ? 1 : 0) | (Position.Y >= Center.Y ? 2 : 0) | (Position.Z >= Center.Z ? 4 : 0);
+	};
+
+	int32 OctantCount[8] = {};
+	for (int32 Index = Begin; Index < End; ++Index)
+	{
+		++OctantCount[OctantOf(BodyPosition[Index])];
+	}
+
+	int32 OctantStart[8];
+	int32 Running = Begin;
+	for (int32 Octant = 0; Octant < 8; ++Octant)
+	{
+		OctantStart[Octant] = Running;
+		Running += OctantCount[Octant];
+	}
+
+	int32 Cursor[8];
+	FMemory::Memcpy(Cursor, OctantStart, sizeof(Cursor));
+
+	for (int32 Index = Begin; Index < End; ++Index)
+	{
+		const int32 Slot = Cursor[OctantOf(BodyPosition[Index])]++;
+		ScratchPosition[Slot] = BodyPosition[Index];
+		ScratchGM[Slot] = BodyGM[Index];
+	}
+
+	for (int32 Index = Begin; Index < End; ++Index)
+	{
+		BodyPosition[Index] = ScratchPosition[Index];
+		BodyGM[Index] = ScratchGM[Index];
+	}
+
+	// Allocate the non-empty children contiguously
+	int32 NumChildren = 0;
+	for (int32 Octant = 0; Octant < 8; ++Octant)
+	{
+		NumChildren += OctantCount[Octant] > 0 ? 1 : 0;
+	}
+
+	const int32 FirstChild = Nodes.Num();
+	Nodes.AddDefaulted(NumChildren);
+	Nodes[NodeIndex].FirstChild = FirstChild;
+	Nodes[NodeIndex].NumChildren = NumChildren;
+
+	const double ChildHalfSize = HalfSize * 0.5;
+	int32 ChildIndex = FirstChild;
+
+	for (int32 Octant = 0; Octant < 8; ++Octant)
+	{
+		if (OctantCount[Octant] == 0)
+		{
+			continue;
+		}
+
+		const FVector ChildCenter(
+			Center.X + ((Octant & 1) ? ChildHalfSize : -ChildHalfSize),
+			Center.Y + ((Octant & 2) ? ChildHalfSize : -ChildHalfSize),
+			Center.Z + ((Octant & 4) ? ChildHalfSize : -ChildHalfSize));
+
+		BuildNode(ChildIndex++, OctantStart[Octant], OctantStart[Octant] + OctantCount[Octant], ChildCenter, ChildHalfSize, Depth + 1);
+	}
+}
+
+FVector FGravityOctree::CalculateAcceleration(const FVector& Position, double OpeningAngle, double MinDistanceSquared) const
+{
+	if (Nodes.Num() == 0)
+	{
+		return FVector::ZeroVector;
+	}
+
+	// Acceleration towards a point mass, matching the simulator's distance clamp
+	auto PointAcceleration = [MinDistanceSquared](const FVector& Delta, double GM)
+	{
+		const double DistanceSquared = Delta.SizeSquared();
+		if (DistanceSquared < UE_SMALL_NUMBER)
+		{
+			return FVector::ZeroVector;
+		}
+		return Delta * (GM / (FMath::Max(DistanceSquared, MinDistanceSquared) * FMath::Sqrt(DistanceSquared)));
+	};
+
+	const double OpeningAngleSquared = OpeningAngle * OpeningAngle;
+	FVector Acceleration = FVector::ZeroVector;
+
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Push(0);
+
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = Nodes[Stack.Pop(EAllowShrinking::No)];
+		const FVector Delta = Node.CenterOfMass - Position;
+
+		// Far enough away: treat the whole node as one point mass
+		if (Node.NumBodies > 1 && Node.Size * Node.Size < OpeningAngleSquared * Delta.SizeSquared())
+		{
+			Acceleration += PointAcceleration(Delta, Node.GM);
+			continue;
+		}
+
+		if (Node.FirstChild == INDEX_NONE)
+		{
+			for (int32 Index = Node.FirstBody; Index < Node.FirstBody + Node.NumBodies; ++Index)
+			{
+				Acceleration += PointAcceleration(BodyPosition[Index] - Position, BodyGM[Index]);
+			}
+			continue;
+		}
+
+		for (int32 Child = Node.FirstChild; Child < Node.FirstChild + Node.NumChildren; ++Child)
+		{
+			Stack.Push(Child);
+		}
+	}
+
+	return Acceleration;
+}
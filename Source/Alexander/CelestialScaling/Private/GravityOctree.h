@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGravityBodySnapshot;
+
+/**
+ * Barnes-Hut octree over the bodies of one gravity snapshot
+ * Each node stores the total GM and centre of mass of its bodies so distant
+ * clusters collapse into a single point mass, giving O(log n) force evaluation
+ * per target without discarding far-but-massive bodies
+ */
+class FGravityOctree
+{
+public:
+	/** Maximum bodies stored in a leaf before it is split */
+	static constexpr int32 MaxLeafBodies = 8;
+
+	/** Depth limit guarding against coincident bodies */
+	static constexpr int32 MaxDepth = 24;
+
+	/**
+	 * Rebuild the tree from the valid bodies of a snapshot
+	 * @param Snapshot - Snapshot to index; bodies with a zero validity mask are skipped
+	 */
+	void Build(const FGravityBodySnapshot& Snapshot);
+
+	/**
+	 * Gravitational acceleration (GM / r², towards the bodies) at a position
+	 * @param Position - Query position in Unreal units
+	 * @param OpeningAngle - Barnes-Hut theta; a node is approximated when size / distance < theta (0 = exact)
+	 * @param MinDistanceSquared - Squared distance clamp preventing singularities
+	 */
+	FVector CalculateAcceleration(const FVector& Position, double OpeningAngle, double MinDistanceSquared) const;
+
+	/** Number of bodies indexed by the tree */
+	int32 GetNumBodies() const { return BodyGM.Num(); }
+
+	/** Number of nodes in the tree */
+	int32 GetNumNodes() const { return Nodes.Num(); }
+
+private:
+	struct FNode
+	{
+		/** Centre of mass of all bodies below this node */
+		FVector CenterOfMass = FVector::ZeroVector;
+
+		/** Sum of GM of all bodies below this node */
+		double GM = 0.0;
+
+		/** Edge length of the node's cube */
+		double Size = 0.0;
+
+		/** First child node (children are contiguous), INDEX_NONE for leaves */
+		int32 FirstChild = INDEX_NONE;
+		int32 NumChildren = 0;
+
+		/** Range into the body arrays for leaves */
+		int32 FirstBody = 0;
+		int32 NumBodies = 0;
+	};
+
+	/** Recursively split the body range [Begin, End) into octants */
+	void BuildNode(int32 NodeIndex, int32 Begin, int32 End, const FVector& Center, double HalfSize, int32 Depth);
+
+	/** Flat node storage, root at index 0 */
+	TArray<FNode> Nodes;
+
+	/** Body positions and GM reordered so each leaf owns a contiguous range */
+	TArray<FVector> BodyPosition;
+	TArray<double> BodyGM;
+
+	/** Scratch buffers reused between builds */
+	TArray<FVector> ScratchPosition;
+	TArray<double> ScratchGM;
+};
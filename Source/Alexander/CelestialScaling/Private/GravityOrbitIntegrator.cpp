@@ -0,0 +1,778 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityOrbitIntegrator.h"
+#include "GravityChebyshevEphemeris.h"
+#include "GravitySimulator.h"
+#include "CelestialBodyComponent.h"
+#include "GameFramework/Actor.h"
+
+namespace
+{
+	/** Actor moves smaller than this (Unreal units) are float noise, not external moves */
+	constexpr double ExternalMoveTolerance = 1.0;
+
+	/** Extra fraction of the perturbation radius a numerical body must clear before going back on rails */
+	constexpr double RailsReturnHysteresis = 0.25;
+
+	/** Yoshida 4th-order composition weights: w1, w0, w1 */
+	const double YoshidaW1 = 1.0 / (2.0 - FMath::Pow(2.0, 1.0 / 3.0));
+	const double YoshidaW0 = -FMath::Pow(2.0, 1.0 / 3.0) / (2.0 - FMath::Pow(2.0, 1.0 / 3.0));
+
+	bool IsDrivenByServer(const AActor* Owner, bool bIsNetClient)
+	{
+		return bIsNetClient && Owner->GetIsReplicated() && Owner->IsReplicatingMovement();
+	}
+}
+
+void FGravityOrbitIntegrator::Sync(TConstArrayView<UCelestialBodyComponent*> InBodies, uint32 RegistryGeneration, double GravitationalConstant, bool bIsNetClient,
+	const FGravityOrbitParams& Params)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityOrbitIntegrator::Sync);
+
+	const bool bRebuild = !bHasSynced || RegistryGeneration != SyncedRegistryGeneration || InBodies.Num() != Bodies.Num();
+
+	if (bRebuild)
+	{
+		// Carry state over for bodies that were already tracked
+		FGravityOrbitIntegrator Previous = MoveTemp(*this);
+		Reset();
+		SimulationTime = Previous.SimulationTime;
+		Ephemeris = MoveTemp(Previous.Ephemeris);
+
+		TMap<FName, int32> IndicesByID;
+
+		for (UCelestialBodyComponent* Body : InBodies)
+		{
+			AActor* Owner = IsValid(Body) ? Body->GetOwner() : nullptr;
+			const double BodyMass = Owner ? Body->GetMass() : 0.0;
+			const bool bMoving = Owner && BodyMass > 0.0 && Body->bSimulateOrbit && !IsDrivenByServer(Owner, bIsNetClient);
+
+			FVector Position = Owner ? Owner->GetActorLocation() : FVector::ZeroVector;
+			FVector Velocity = bMoving ? Body->InitialVelocity : FVector::ZeroVector;
+			const FVector ActorPosition = Position;
+
+			// The table is authoritative for the bodies it lists
+			const int32 EphemerisSlot = bMoving && Ephemeris.IsValid() && Body->BodyID != NAME_None ? Ephemeris->FindBody(Body->BodyID) : INDEX_NONE;
+			FVector EphemerisOffset = FVector::ZeroVector;
+
+			if (const int32* PreviousIndex = Previous.BodyIndices.Find(Body))
+			{
+				const int32 Index = *PreviousIndex;
+				Position = Position + Previous.GetPositionAt(Index) - Previous.ActorPositions[Index];
+				if (bMoving && (Previous.MovingMask[Index] || Previous.RailsMask[Index]))
+				{
+					Velocity = Previous.GetVelocityAt(Index);
+				}
+
+				if (EphemerisSlot != INDEX_NONE && Previous.EphemerisSlots[Index] != INDEX_NONE)
+				{
+					EphemerisOffset = Previous.EphemerisOffsets[Index] + ActorPosition - Previous.ActorPositions[Index];
+				}
+			}
+
+			if (Owner && Body->BodyID != NAME_None)
+			{
+				IndicesByID.Add(Body->BodyID, Bodies.Num());
+			}
+
+			BodyIndices.Add(Body, Bodies.Num());
+			Bodies.Add(Body);
+			PositionX.Add(Position.X);
+			PositionY.Add(Position.Y);
+			PositionZ.Add(Position.Z);
+			VelocityX.Add(Velocity.X);
+			VelocityY.Add(Velocity.Y);
+			VelocityZ.Add(Velocity.Z);
+			GM.Add(GravitationalConstant * BodyMass);
+			Mass.Add(BodyMass);
+			MovingMask.Add(bMoving && EphemerisSlot == INDEX_NONE ? 1 : 0);
+			RailsMask.Add(0);
+			RailsParents.Add(INDEX_NONE);
+			EphemerisSlots.Add(EphemerisSlot);
+			EphemerisOffsets.Add(EphemerisOffset);
+			ActorPositions.Add(ActorPosition);
+			NumMoving += bMoving ? 1 : 0;
+
+			if (EphemerisSlot != INDEX_NONE)
+			{
+				EphemerisBodies.Add(Bodies.Num() - 1);
+			}
+		}
+
+		RailsOrbits.SetNum(Bodies.Num());
+
+		// Resolve rails parents now that every body has an index
+		for (int32 Index = 0; Index < Bodies.Num(); ++Index)
+		{
+			const UCelestialBodyComponent* Body = Bodies[Index].Get();
+			if (!MovingMask[Index] || !Body->bOnRails)
+			{
+				continue;
+			}
+
+			const int32* Parent = IndicesByID.Find(Body->OrbitParentID);
+			if (!Parent || *Parent == Index || GM[*Parent] <= 0.0)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: %s is on rails but parent '%s' was not found; integrating it numerically"),
+					*Body->GetBodyName().ToString(), *Body->OrbitParentID.ToString());
+				continue;
+			}
+
+			RailsParents[Index] = *Parent;
+		}
+
+		// Parents first; a parent cycle leaves the bodies involved to numerical integration
+		TArray<int32> Depths;
+		Depths.SetNumZeroed(Bodies.Num());
+
+		for (int32 Index = 0; Index < Bodies.Num(); ++Index)
+		{
+			int32 Depth = 0;
+			for (int32 Ancestor = RailsParents[Index]; Ancestor != INDEX_NONE && Depth <= Bodies.Num(); Ancestor = RailsParents[Ancestor])
+			{
+				++Depth;
+			}
+
+			if (Depth > Bodies.Num())
+			{
+				RailsParents[Index] = INDEX_NONE;
+				continue;
+			}
+
+			Depths[Index] = Depth;
+			if (RailsParents[Index] != INDEX_NONE)
+			{
+				RailsOrder.Add(Index);
+			}
+		}
+
+		RailsOrder.Sort([&Depths](int32 A, int32 B)
+		{
+			return Depths[A] < Depths[B];
+		});
+
+		// Keep existing orbits; start new rails bodies from their designed elements
+		for (int32 Index : RailsOrder)
+		{
+			const UCelestialBodyComponent* Body = Bodies[Index].Get();
+			const int32* PreviousIndex = Previous.BodyIndices.Find(Body);
+
+			if (PreviousIndex && Previous.RailsParents[*PreviousIndex] != INDEX_NONE
+				&& Previous.Bodies[Previous.RailsParents[*PreviousIndex]] == Bodies[RailsParents[Index]])
+			{
+				RailsOrbits[Index] = Previous.RailsOrbits[*PreviousIndex];
+				RailsMask[Index] = Previous.RailsMask[*PreviousIndex];
+			}
+			else if (GravityKepler::MakeOrbit(Body->OrbitElements, GetRailsMu(Index, Params), SimulationTime, RailsOrbits[Index]))
+			{
+				RailsMask[Index] = 1;
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: %s has no bound elliptic orbit; integrating it numerically"),
+					*Body->GetBodyName().ToString());
+				RailsParents[Index] = INDEX_NONE;
+				continue;
+			}
+
+			if (RailsMask[Index])
+			{
+				MovingMask[Index] = 0;
+			}
+		}
+
+		RailsOrder.RemoveAll([this](int32 Index)
+		{
+			return RailsParents[Index] == INDEX_NONE;
+		});
+
+		for (uint8 bMoving : MovingMask)
+		{
+			NumNumerical += bMoving;
+		}
+
+		AccelerationX.SetNumZeroed(Bodies.Num());
+		AccelerationY.SetNumZeroed(Bodies.Num());
+		AccelerationZ.SetNumZeroed(Bodies.Num());
+
+		EvaluateRails(SimulationTime);
+
+		SyncedRegistryGeneration = RegistryGeneration;
+		bHasSynced = true;
+		return;
+	}
+
+	// Same body set: absorb actor moves made by anyone but us
+	for (int32 Index = 0; Index < Bodies.Num(); ++Index)
+	{
+		const UCelestialBodyComponent* Body = Bodies[Index].Get();
+		const AActor* Owner = Body ? Body->GetOwner() : nullptr;
+		if (!Owner)
+		{
+			continue;
+		}
+
+		const FVector ActorPosition = Owner->GetActorLocation();
+		const FVector Delta = ActorPosition - ActorPositions[Index];
+
+		if (Delta.SizeSquared() > ExternalMoveTolerance * ExternalMoveTolerance)
+		{
+			PositionX[Index] += Delta.X;
+			PositionY[Index] += Delta.Y;
+			PositionZ[Index] += Delta.Z;
+			ActorPositions[Index] = ActorPosition;
+
+			if (EphemerisSlots[Index] != INDEX_NONE)
+			{
+				EphemerisOffsets[Index] += Delta;
+			}
+
+			bAccelerationsValid = false;
+			bEnergyReferenceStale = true;
+		}
+	}
+
+	// Rails bodies follow their parents wherever those were moved
+	EvaluateRails(SimulationTime);
+}
+
+void FGravityOrbitIntegrator::UpdatePropagationModes(TConstArrayView<FVector> Probes, double PerturbationScale, bool bAllowNumerical, const FGravityOrbitParams& Params)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityOrbitIntegrator::UpdatePropagationModes);
+
+	for (int32 Index : RailsOrder)
+	{
+		bool bPerturbed = false;
+
+		if (bAllowNumerical)
+		{
+			// Numerical bodies must be clearly outside the radius before returning to rails
+			const int32 Parent = RailsParents[Index];
+			const double SOIRadius = RailsOrbits[Index].SemiMajorAxis * FMath::Pow(Mass[Index] / FMath::Max(Mass[Parent], UE_DOUBLE_SMALL_NUMBER), 0.4);
+			const double Radius = SOIRadius * PerturbationScale * (RailsMask[Index] ? 1.0 : 1.0 + RailsReturnHysteresis);
+			const double RadiusSquared = Radius * Radius;
+			const FVector Position = GetPositionAt(Index);
+
+			for (const FVector& Probe : Probes)
+			{
+				if (FVector::DistSquared(Probe, Position) < RadiusSquared)
+				{
+					bPerturbed = true;
+					break;
+				}
+			}
+
+			for (int32 Other = 0; Other < Bodies.Num() && !bPerturbed; ++Other)
+			{
+				if (Other == Index || Other == Parent || GM[Other] <= 0.0 || IsRailsDescendant(Other, Index))
+				{
+					continue;
+				}
+
+				bPerturbed = FVector::DistSquared(GetPositionAt(Other), Position) < RadiusSquared;
+			}
+		}
+
+		if (RailsMask[Index] && bPerturbed)
+		{
+			// Continue numerically from the exact rails state
+			RailsMask[Index] = 0;
+			MovingMask[Index] = 1;
+			++NumNumerical;
+			bAccelerationsValid = false;
+			bEnergyReferenceStale = true;
+		}
+		else if (MovingMask[Index] && !bPerturbed)
+		{
+			EnterRails(Index, Params);
+		}
+	}
+}
+
+void FGravityOrbitIntegrator::Step(double DeltaTime, EGravityOrbitIntegrator Method, const FGravityOrbitParams& Params)
+{
+	if (NumMoving == 0 || DeltaTime <= 0.0)
+	{
+		return;
+	}
+
+	// Nothing integrated numerically: the rails are exact at any step size
+	if (NumNumerical == 0)
+	{
+		SimulationTime += DeltaTime;
+		EvaluateRails(SimulationTime);
+		return;
+	}
+
+	if (Method == EGravityOrbitIntegrator::DormandPrince45)
+	{
+		AdaptiveStep(DeltaTime, Params);
+	}
+	else if (Method == EGravityOrbitIntegrator::Yoshida4)
+	{
+		const double EndTime = SimulationTime + DeltaTime;
+
+		LeapfrogStep(YoshidaW1 * DeltaTime, Params);
+		LeapfrogStep(YoshidaW0 * DeltaTime, Params);
+		LeapfrogStep(YoshidaW1 * DeltaTime, Params);
+
+		// The three sub-step times need not sum back to DeltaTime in floating point; a tiny step could
+		// otherwise leave the clock unchanged and stall callers that step until a target time is reached
+		if (SimulationTime != EndTime)
+		{
+			SimulationTime = EndTime;
+			EvaluateRails(SimulationTime);
+		}
+	}
+	else
+	{
+		LeapfrogStep(DeltaTime, Params);
+	}
+}
+
+void FGravityOrbitIntegrator::LeapfrogStep(double DeltaTime, const FGravityOrbitParams& Params)
+{
+	if (!bAccelerationsValid)
+	{
+		ComputeAccelerations(Params);
+	}
+
+	Kick(0.5 * DeltaTime);
+	Drift(DeltaTime);
+	SimulationTime += DeltaTime;
+	EvaluateRails(SimulationTime);
+	ComputeAccelerations(Params);
+	Kick(0.5 * DeltaTime);
+}
+
+void FGravityOrbitIntegrator::AdaptiveStep(double DeltaTime, const FGravityOrbitParams& Params)
+{
+	AdaptiveIndices.Reset(NumNumerical);
+	TArray<FVector, TInlineAllocator<32>> StartPositions;
+	TArray<FVector, TInlineAllocator<32>> StartVelocities;
+
+	for (int32 Index = 0; Index < Bodies.Num(); ++Index)
+	{
+		if (MovingMask[Index])
+		{
+			AdaptiveIndices.Add(Index);
+			StartPositions.Add(GetPositionAt(Index));
+			StartVelocities.Add(GetVelocityAt(Index));
+		}
+	}
+
+	// Trial states go through the body arrays so rails children follow their numerical parents
+	auto Acceleration = [this, &Params](double Time, TConstArrayView<FVector> Positions, TConstArrayView<FVector> Velocities, TArrayView<FVector> OutAccelerations)
+	{
+		for (int32 Slot = 0; Slot < AdaptiveIndices.Num(); ++Slot)
+		{
+			const int32 Index = AdaptiveIndices[Slot];
+			PositionX[Index] = Positions[Slot].X;
+			PositionY[Index] = Positions[Slot].Y;
+			PositionZ[Index] = Positions[Slot].Z;
+			VelocityX[Index] = Velocities[Slot].X;
+			VelocityY[Index] = Velocities[Slot].Y;
+			VelocityZ[Index] = Velocities[Slot].Z;
+		}
+
+		EvaluateRails(Time);
+		ComputeAccelerations(Params);
+
+		for (int32 Slot = 0; Slot < AdaptiveIndices.Num(); ++Slot)
+		{
+			const int32 Index = AdaptiveIndices[Slot];
+			OutAccelerations[Slot] = FVector(AccelerationX[Index], AccelerationY[Index], AccelerationZ[Index]);
+		}
+	};
+
+	const double EndTime = SimulationTime + DeltaTime;
+	if (AdaptiveStepSize <= 0.0)
+	{
+		AdaptiveStepSize = DeltaTime;
+	}
+
+	AdaptiveStepper.Begin(SimulationTime, StartPositions, StartVelocities, Acceleration);
+	AdaptiveStepper.Integrate(EndTime, AdaptiveStepSize, Params.Adaptive, Acceleration);
+
+	// Leave the arrays at the accepted end state rather than the last trial stage
+	TConstArrayView<FVector> EndPositions = AdaptiveStepper.GetPositions();
+	TConstArrayView<FVector> EndVelocities = AdaptiveStepper.GetVelocities();
+	for (int32 Slot = 0; Slot < AdaptiveIndices.Num(); ++Slot)
+	{
+		const int32 Index = AdaptiveIndices[Slot];
+		PositionX[Index] = EndPositions[Slot].X;
+		PositionY[Index] = EndPositions[Slot].Y;
+		PositionZ[Index] = EndPositions[Slot].Z;
+		VelocityX[Index] = EndVelocities[Slot].X;
+		VelocityY[Index] = EndVelocities[Slot].Y;
+		VelocityZ[Index] = EndVelocities[Slot].Z;
+	}
+
+	SimulationTime = EndTime;
+	EvaluateRails(SimulationTime);
+	bAccelerationsValid = false;
+}
+
+void FGravityOrbitIntegrator::EvaluateRails(double Time)
+{
+	// Table bodies first: they can be rails parents but never children
+	for (int32 Index : EphemerisBodies)
+	{
+		FVector Position, Velocity;
+		if (!Ephemeris->Evaluate(EphemerisSlots[Index], Time, Position, Velocity))
+		{
+			// Outside the cooked span: hold the last position rather than extrapolate
+			continue;
+		}
+
+		Position += EphemerisOffsets[Index];
+		PositionX[Index] = Position.X;
+		PositionY[Index] = Position.Y;
+		PositionZ[Index] = Position.Z;
+		VelocityX[Index] = Velocity.X;
+		VelocityY[Index] = Velocity.Y;
+		VelocityZ[Index] = Velocity.Z;
+	}
+
+	for (int32 Index : RailsOrder)
+	{
+		if (!RailsMask[Index])
+		{
+			continue;
+		}
+
+		FVector RelativePosition, RelativeVelocity;
+		GravityKepler::Evaluate(RailsOrbits[Index], Time, RelativePosition, RelativeVelocity);
+
+		const int32 Parent = RailsParents[Index];
+		const FVector Position = GetPositionAt(Parent) + RelativePosition;
+		const FVector Velocity = GetVelocityAt(Parent) + RelativeVelocity;
+
+		PositionX[Index] = Position.X;
+		PositionY[Index] = Position.Y;
+		PositionZ[Index] = Position.Z;
+		VelocityX[Index] = Velocity.X;
+		VelocityY[Index] = Velocity.Y;
+		VelocityZ[Index] = Velocity.Z;
+	}
+}
+
+double FGravityOrbitIntegrator::GetRailsMu(int32 Index, const FGravityOrbitParams& Params) const
+{
+	return (GM[RailsParents[Index]] + GM[Index]) * Params.AccelerationScale;
+}
+
+bool FGravityOrbitIntegrator::IsRailsDescendant(int32 Index, int32 Ancestor) const
+{
+	for (int32 Current = Index; Current != INDEX_NONE; Current = RailsParents[Current])
+	{
+		if (Current == Ancestor)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FGravityOrbitIntegrator::EnterRails(int32 Index, const FGravityOrbitParams& Params)
+{
+	const int32 Parent = RailsParents[Index];
+	if (!GravityKepler::FitOrbit(GetPositionAt(Index) - GetPositionAt(Parent), GetVelocityAt(Index) - GetVelocityAt(Parent),
+		GetRailsMu(Index, Params), SimulationTime, RailsOrbits[Index]))
+	{
+		// Escaping or plunging: stay numerical until the orbit is bound again
+		return false;
+	}
+
+	if (MovingMask[Index])
+	{
+		MovingMask[Index] = 0;
+		--NumNumerical;
+		bAccelerationsValid = false;
+	}
+
+	RailsMask[Index] = 1;
+	bEnergyReferenceStale = true;
+	return true;
+}
+
+void FGravityOrbitIntegrator::Kick(double DeltaTime)
+{
+	for (int32 Index = 0; Index < Bodies.Num(); ++Index)
+	{
+		if (MovingMask[Index])
+		{
+			VelocityX[Index] += AccelerationX[Index] * DeltaTime;
+			VelocityY[Index] += AccelerationY[Index] * DeltaTime;
+			VelocityZ[Index] += AccelerationZ[Index] * DeltaTime;
+		}
+	}
+}
+
+void FGravityOrbitIntegrator::Drift(double DeltaTime)
+{
+	for (int32 Index = 0; Index < Bodies.Num(); ++Index)
+	{
+		if (MovingMask[Index])
+		{
+			PositionX[Index] += VelocityX[Index] * DeltaTime;
+			PositionY[Index] += VelocityY[Index] * DeltaTime;
+			PositionZ[Index] += VelocityZ[Index] * DeltaTime;
+		}
+	}
+}
+
+void FGravityOrbitIntegrator::ComputeAccelerations(const FGravityOrbitParams& Params)
+{
+	const int32 NumBodies = Bodies.Num();
+
+	FMemory::Memzero(AccelerationX.GetData(), NumBodies * sizeof(double));
+	FMemory::Memzero(AccelerationY.GetData(), NumBodies * sizeof(double));
+	FMemory::Memzero(AccelerationZ.GetData(), NumBodies * sizeof(double));
+
+	// Each pair once; only moving bodies accumulate, but every massive body attracts
+	for (int32 A = 0; A < NumBodies; ++A)
+	{
+		for (int32 B = A + 1; B < NumBodies; ++B)
+		{
+			if (!MovingMask[A] && !MovingMask[B])
+			{
+				continue;
+			}
+
+			const double DX = PositionX[B] - PositionX[A];
+			const double DY = PositionY[B] - PositionY[A];
+			const double DZ = PositionZ[B] - PositionZ[A];
+			const double DistanceSquared = DX * DX + DY * DY + DZ * DZ;
+
+			if (DistanceSquared <= 0.0)
+			{
+				continue;
+			}
+
+			const double InverseCube = Params.AccelerationScale / (FMath::Max(DistanceSquared, Params.MinDistanceSquared) * FMath::Sqrt(DistanceSquared));
+
+			if (MovingMask[A])
+			{
+				AccelerationX[A] += DX * GM[B] * InverseCube;
+				AccelerationY[A] += DY * GM[B] * InverseCube;
+				AccelerationZ[A] += DZ * GM[B] * InverseCube;
+			}
+
+			if (MovingMask[B])
+			{
+				AccelerationX[B] -= DX * GM[A] * InverseCube;
+				AccelerationY[B] -= DY * GM[A] * InverseCube;
+				AccelerationZ[B] -= DZ * GM[A] * InverseCube;
+			}
+		}
+	}
+
+	bAccelerationsValid = true;
+}
+
+int32 FGravityOrbitIntegrator::WriteBack(double Tolerance)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityOrbitIntegrator::WriteBack);
+
+	const double ToleranceSquared = Tolerance * Tolerance;
+	int32 NumWritten = 0;
+
+	for (int32 Index = 0; Index < Bodies.Num(); ++Index)
+	{
+		if (!MovingMask[Index] && !RailsMask[Index] && EphemerisSlots[Index] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		UCelestialBodyComponent* Body = Bodies[Index].Get();
+		AActor* Owner = Body ? Body->GetOwner() : nullptr;
+		if (!Owner)
+		{
+			continue;
+		}
+
+		const FVector Position(PositionX[Index], PositionY[Index], PositionZ[Index]);
+		if (FVector::DistSquared(Position, ActorPositions[Index]) <= ToleranceSquared)
+		{
+			continue;
+		}
+
+		Owner->SetActorLocation(Position, false, nullptr, ETeleportType::TeleportPhysics);
+
+		// Remember where the actor actually ended up so our own move is not mistaken for an external one
+		ActorPositions[Index] = Owner->GetActorLocation();
+		++NumWritten;
+	}
+
+	return NumWritten;
+}
+
+double FGravityOrbitIntegrator::ComputeEnergy(const FGravityOrbitParams& Params) const
+{
+	const int32 NumBodies = Bodies.Num();
+	double Kinetic = 0.0;
+	double Potential = 0.0;
+
+	for (int32 A = 0; A < NumBodies; ++A)
+	{
+		if (MovingMask[A])
+		{
+			Kinetic += 0.5 * Mass[A] * (VelocityX[A] * VelocityX[A] + VelocityY[A] * VelocityY[A] + VelocityZ[A] * VelocityZ[A]);
+		}
+
+		for (int32 B = A + 1; B < NumBodies; ++B)
+		{
+			// Static pairs only add a constant
+			if (!MovingMask[A] && !MovingMask[B])
+			{
+				continue;
+			}
+
+			const double DX = PositionX[B] - PositionX[A];
+			const double DY = PositionY[B] - PositionY[A];
+			const double DZ = PositionZ[B] - PositionZ[A];
+			const double Distance = FMath::Sqrt(DX * DX + DY * DY + DZ * DZ);
+			const double MinDistance = FMath::Sqrt(Params.MinDistanceSquared);
+			const double Strength = Params.AccelerationScale * GM[A] * Mass[B];
+
+			// Potential of the softened force above: -k/r outside MinDistance, and inside it the integral of
+			// the constant k/min² magnitude, joined continuously at MinDistance
+			Potential -= Distance >= MinDistance
+				? Strength / Distance
+				: Strength * (2.0 * MinDistance - Distance) / Params.MinDistanceSquared;
+		}
+	}
+
+	return Kinetic + Potential;
+}
+
+double FGravityOrbitIntegrator::GetEnergyDrift(const FGravityOrbitParams& Params) const
+{
+	if (bEnergyReferenceStale || FMath::IsNearlyZero(ReferenceEnergy))
+	{
+		return 0.0;
+	}
+
+	return FMath::Abs(ComputeEnergy(Params) - ReferenceEnergy) / FMath::Abs(ReferenceEnergy);
+}
+
+void FGravityOrbitIntegrator::ResetEnergyReference(const FGravityOrbitParams& Params)
+{
+	ReferenceEnergy = ComputeEnergy(Params);
+	bEnergyReferenceStale = false;
+}
+
+bool FGravityOrbitIntegrator::GetPosition(const UCelestialBodyComponent* Body, FVector& OutPosition) const
+{
+	const int32* Index = BodyIndices.Find(Body);
+	if (!Index)
+	{
+		return false;
+	}
+
+	OutPosition = FVector(PositionX[*Index], PositionY[*Index], PositionZ[*Index]);
+	return true;
+}
+
+bool FGravityOrbitIntegrator::GetVelocity(const UCelestialBodyComponent* Body, FVector& OutVelocity) const
+{
+	const int32* Index = BodyIndices.Find(Body);
+	if (!Index)
+	{
+		return false;
+	}
+
+	OutVelocity = FVector(VelocityX[*Index], VelocityY[*Index], VelocityZ[*Index]);
+	return true;
+}
+
+bool FGravityOrbitIntegrator::SetVelocity(const UCelestialBodyComponent* Body, const FVector& Velocity, const FGravityOrbitParams& Params)
+{
+	const int32* Index = BodyIndices.Find(Body);
+	if (!Index || (!MovingMask[*Index] && !RailsMask[*Index]))
+	{
+		return false;
+	}
+
+	VelocityX[*Index] = Velocity.X;
+	VelocityY[*Index] = Velocity.Y;
+	VelocityZ[*Index] = Velocity.Z;
+	bEnergyReferenceStale = true;
+
+	// A rails body takes the new orbit, or drops to numerical integration if it is no longer bound
+	if (RailsMask[*Index] && !EnterRails(*Index, Params))
+	{
+		RailsMask[*Index] = 0;
+		MovingMask[*Index] = 1;
+		++NumNumerical;
+		bAccelerationsValid = false;
+	}
+
+	return true;
+}
+
+bool FGravityOrbitIntegrator::IsOnRails(const UCelestialBodyComponent* Body) const
+{
+	const int32* Index = BodyIndices.Find(Body);
+	return Index && RailsMask[*Index];
+}
+
+bool FGravityOrbitIntegrator::IsMoving(const UCelestialBodyComponent* Body) const
+{
+	const int32* Index = BodyIndices.Find(Body);
+	return Index && (MovingMask[*Index] || RailsMask[*Index]);
+}
+
+void FGravityOrbitIntegrator::SetEphemeris(TSharedPtr<const FGravityChebyshevEphemeris, ESPMode::ThreadSafe> InEphemeris)
+{
+	Ephemeris = MoveTemp(InEphemeris);
+	bHasSynced = false;
+}
+
+void FGravityOrbitIntegrator::JumpToTime(double Time)
+{
+	SimulationTime = Time;
+	EvaluateRails(SimulationTime);
+
+	bAccelerationsValid = false;
+	bEnergyReferenceStale = true;
+}
+
+void FGravityOrbitIntegrator::Reset()
+{
+	PositionX.Reset();
+	PositionY.Reset();
+	PositionZ.Reset();
+	VelocityX.Reset();
+	VelocityY.Reset();
+	VelocityZ.Reset();
+	AccelerationX.Reset();
+	AccelerationY.Reset();
+	AccelerationZ.Reset();
+	GM.Reset();
+	Mass.Reset();
+	MovingMask.Reset();
+	RailsMask.Reset();
+	RailsOrbits.Reset();
+	RailsParents.Reset();
+	RailsOrder.Reset();
+	EphemerisSlots.Reset();
+	EphemerisOffsets.Reset();
+	EphemerisBodies.Reset();
+	ActorPositions.Reset();
+	Bodies.Reset();
+	BodyIndices.Reset();
+
+	AdaptiveIndices.Reset();
+
+	NumMoving = 0;
+	NumNumerical = 0;
+	SimulationTime = 0.0;
+	AdaptiveStepSize = 0.0;
+	bHasSynced = false;
+	bAccelerationsValid = false;
+	bEnergyReferenceStale = true;
+	ReferenceEnergy = 0.0;
+}
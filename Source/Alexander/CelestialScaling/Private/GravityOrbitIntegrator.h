@@ -0,0 +1,253 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "GravityKepler.h"
+#include "GravityDormandPrince.h"
+
+class UCelestialBodyComponent;
+class FGravityChebyshevEphemeris;
+enum class EGravityOrbitIntegrator : uint8;
+
+/**
+ * Force model shared by every body in an orbit step
+ */
+struct FGravityOrbitParams
+{
+	/** Converts GM / r² into Unreal units per second² (physics scale × Newton-to-Unreal factor) */
+	double AccelerationScale = 100.0;
+
+	/** Squared minimum separation used to soften close encounters */
+	double MinDistanceSquared = 1.0;
+
+	/** Error control for the Dormand-Prince method */
+	FGravityAdaptiveStepParams Adaptive;
+};
+
+/**
+ * Symplectic integrator advancing celestial bodies under their mutual gravity
+ * Body states live in dense double arrays and are stepped at a fixed rate with kick-drift-kick
+ * leapfrog or Yoshida's fourth-order composition of it; both conserve energy over long runs
+ * instead of spiralling like explicit Euler. The Dormand-Prince method instead takes as many error-controlled
+ * substeps as each step needs, which keeps close encounters and large time-warp steps accurate. Actors are only moved when their integrated position
+ * has drifted past a tolerance, and moves made by anyone else (origin rebasing, teleports) are absorbed.
+ * Bodies that do not simulate their orbit still attract but stay where their actor puts them.
+ *
+ * On-rails bodies follow a Kepler orbit around their parent in closed form (O(1), exact at any
+ * time step) and only join the numerical integration while something perturbs them; once clear
+ * they are refitted to their osculating orbit and put back on rails.
+ *
+ * Bodies found in a cooked Chebyshev ephemeris are read from the table instead (also O(1)); they
+ * attract and carry rails children like any other body but never integrate.
+ */
+class FGravityOrbitIntegrator
+{
+public:
+	/**
+	 * Match the integrator to the current body list
+	 * New bodies start at their actor location with their InitialVelocity, or on their orbit when on rails;
+	 * existing bodies keep their state
+	 * @param Bodies - Registered celestial bodies
+	 * @param RegistryGeneration - Registry generation the list was read at; unchanged generations skip the rebuild
+	 * @param GravitationalConstant - G used to derive each body's GM
+	 * @param bIsNetClient - Bodies whose owners replicate movement are driven by the server on clients
+	 * @param Params - Force model, used to derive on-rails mean motions
+	 */
+	void Sync(TConstArrayView<UCelestialBodyComponent*> Bodies, uint32 RegistryGeneration, double GravitationalConstant, bool bIsNetClient,
+		const FGravityOrbitParams& Params);
+
+	/**
+	 * Move on-rails bodies between closed-form and numerical propagation
+	 * A body is perturbed while a probe (player) or a massive body other than its parent and descendants
+	 * is inside its sphere of influence scaled by PerturbationScale
+	 * @param Probes - Positions that perturb nearby rails bodies
+	 * @param PerturbationScale - Multiplier on each body's sphere of influence
+	 * @param bAllowNumerical - False forces every rails body back onto its osculating orbit (time warp)
+	 */
+	void UpdatePropagationModes(TConstArrayView<FVector> Probes, double PerturbationScale, bool bAllowNumerical, const FGravityOrbitParams& Params);
+
+	/**
+	 * Advance all moving bodies by one fixed step
+	 * @param DeltaTime - Step length in seconds
+	 * @param Method - Leapfrog (second order), Yoshida (fourth order, three force evaluations)
+	 *                 or Dormand-Prince (adaptive substeps, six force evaluations each)
+	 */
+	void Step(double DeltaTime, EGravityOrbitIntegrator Method, const FGravityOrbitParams& Params);
+
+	/**
+	 * Move actors whose integrated position differs from their location by more than Tolerance
+	 * @return Number of actors moved
+	 */
+	int32 WriteBack(double Tolerance);
+
+	/** Total kinetic plus potential energy of the numerically integrated bodies, in the integrator's units */
+	double ComputeEnergy(const FGravityOrbitParams& Params) const;
+
+	/** Relative energy change since the reference was last taken (|E - E0| / |E0|) */
+	double GetEnergyDrift(const FGravityOrbitParams& Params) const;
+
+	/** Take the current energy as the drift reference */
+	void ResetEnergyReference(const FGravityOrbitParams& Params);
+
+	/** Whether the body set or a body state changed discontinuously since the last reference */
+	bool NeedsEnergyReference() const { return bEnergyReferenceStale; }
+
+	/** Integrated position of a body, false if it is not tracked */
+	bool GetPosition(const UCelestialBodyComponent* Body, FVector& OutPosition) const;
+
+	/** Integrated velocity of a body (Unreal units per second), false if it is not tracked */
+	bool GetVelocity(const UCelestialBodyComponent* Body, FVector& OutVelocity) const;
+
+	/** Overwrite the velocity of a moving body; rails bodies are refitted to the new orbit */
+	bool SetVelocity(const UCelestialBodyComponent* Body, const FVector& Velocity, const FGravityOrbitParams& Params);
+
+	/** Integrator index of a body, INDEX_NONE if it is not tracked */
+	int32 FindBodyIndex(const UCelestialBodyComponent* Body) const
+	{
+		const int32* Index = BodyIndices.Find(Body);
+		return Index ? *Index : INDEX_NONE;
+	}
+
+	/** Position of the body at an integrator index */
+	FVector GetPositionAt(int32 Index) const { return FVector(PositionX[Index], PositionY[Index], PositionZ[Index]); }
+
+	/** Velocity of the body at an integrator index */
+	FVector GetVelocityAt(int32 Index) const { return FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]); }
+
+	/** Whether a body is currently propagated in closed form */
+	bool IsOnRails(const UCelestialBodyComponent* Body) const;
+
+	/** Whether a body is moved by the integrator or its rails, rather than only tracked as a static attractor */
+	bool IsMoving(const UCelestialBodyComponent* Body) const;
+
+	/** Number of bodies the integrator moves (on rails or numerically) */
+	int32 GetNumMovingBodies() const { return NumMoving; }
+
+	/** Number of bodies currently on rails */
+	int32 GetNumOnRails() const { return NumMoving - NumNumerical - EphemerisBodies.Num(); }
+
+	/** Number of bodies currently integrated numerically */
+	int32 GetNumNumerical() const { return NumNumerical; }
+
+	/** Seconds of simulation time integrated so far */
+	double GetSimulationTime() const { return SimulationTime; }
+
+	/**
+	 * Drive bodies listed in a cooked table from it; takes effect at the next Sync
+	 * @param InEphemeris - Table to use, or null to integrate every body again
+	 */
+	void SetEphemeris(TSharedPtr<const FGravityChebyshevEphemeris, ESPMode::ThreadSafe> InEphemeris);
+
+	/** Number of bodies currently read from the ephemeris table */
+	int32 GetNumFromEphemeris() const { return EphemerisBodies.Num(); }
+
+	/**
+	 * Jump the simulation clock, e.g. to the universe time after a server restart or a time-warp catch-up
+	 * Table and rails bodies move to their positions at Time; numerically integrated bodies keep their state
+	 */
+	void JumpToTime(double Time);
+
+	/** Forget every body */
+	void Reset();
+
+private:
+	/** Velocity change of numerically integrated bodies: v += a * DeltaTime */
+	void Kick(double DeltaTime);
+
+	/** Position change of numerically integrated bodies: x += v * DeltaTime */
+	void Drift(double DeltaTime);
+
+	/** Recompute mutual accelerations for the current positions */
+	void ComputeAccelerations(const FGravityOrbitParams& Params);
+
+	/** One kick-drift-kick leapfrog step; accelerations are reused from the previous step's final kick */
+	void LeapfrogStep(double DeltaTime, const FGravityOrbitParams& Params);
+
+	/** Advance numerical bodies by DeltaTime with error-controlled Dormand-Prince substeps */
+	void AdaptiveStep(double DeltaTime, const FGravityOrbitParams& Params);
+
+	/** Place table bodies at their ephemeris positions and every on-rails body on its orbit at Time, parents before children */
+	void EvaluateRails(double Time);
+
+	/** Gravitational parameter of a rails body's two-body problem in the integrator's units */
+	double GetRailsMu(int32 Index, const FGravityOrbitParams& Params) const;
+
+	/** Whether Ancestor is Index or one of its rails parents */
+	bool IsRailsDescendant(int32 Index, int32 Ancestor) const;
+
+	/** Refit a numerical body to its osculating orbit and put it on rails */
+	bool EnterRails(int32 Index, const FGravityOrbitParams& Params);
+
+	/** Dense body state, one array per axis */
+	TArray<double> PositionX;
+	TArray<double> PositionY;
+	TArray<double> PositionZ;
+	TArray<double> VelocityX;
+	TArray<double> VelocityY;
+	TArray<double> VelocityZ;
+	TArray<double> AccelerationX;
+	TArray<double> AccelerationY;
+	TArray<double> AccelerationZ;
+
+	/** Gravitational parameter (G * Mass) and mass in kg */
+	TArray<double> GM;
+	TArray<double> Mass;
+
+	/** 1 if the body is numerically integrated, 0 if it is on rails or only attracts */
+	TArray<uint8> MovingMask;
+
+	/** 1 if the body is currently propagated in closed form */
+	TArray<uint8> RailsMask;
+
+	/** Orbit around RailsParents, valid for bodies that can go on rails */
+	TArray<GravityKepler::FOrbit> RailsOrbits;
+
+	/** Parent index of bodies that can go on rails, INDEX_NONE otherwise */
+	TArray<int32> RailsParents;
+
+	/** Rails-capable bodies ordered parents first */
+	TArray<int32> RailsOrder;
+
+	/** Cooked positions for bodies listed in it */
+	TSharedPtr<const FGravityChebyshevEphemeris, ESPMode::ThreadSafe> Ephemeris;
+
+	/** Table index per body, INDEX_NONE for bodies not read from the ephemeris */
+	TArray<int32> EphemerisSlots;
+
+	/** World offset of each table body, accumulated from external moves (origin rebasing) */
+	TArray<FVector> EphemerisOffsets;
+
+	/** Bodies read from the ephemeris */
+	TArray<int32> EphemerisBodies;
+
+	/** Dormand-Prince state over the numerically integrated bodies, reused between steps */
+	FGravityDormandPrince AdaptiveStepper;
+
+	/** Integrator index of each body in the adaptive stepper's state */
+	TArray<int32> AdaptiveIndices;
+
+	/** Substep length the adaptive stepper will try next (seconds, 0 until the first step) */
+	double AdaptiveStepSize = 0.0;
+
+	/** Actor location after our last write (or last external move), used to detect moves by others */
+	TArray<FVector> ActorPositions;
+
+	/** Source components, index-aligned with the arrays above */
+	TArray<TWeakObjectPtr<UCelestialBodyComponent>> Bodies;
+
+	/** Component to index lookup */
+	TMap<const UCelestialBodyComponent*, int32> BodyIndices;
+
+	uint32 SyncedRegistryGeneration = 0;
+	int32 NumMoving = 0;
+	int32 NumNumerical = 0;
+	double SimulationTime = 0.0;
+	bool bHasSynced = false;
+	bool bAccelerationsValid = false;
+	bool bEnergyReferenceStale = true;
+
+	/** Energy at the last reference point */
+	double ReferenceEnergy = 0.0;
+};
@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityReceiverComponent.h"
+#include "GravitySimulator.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+namespace
+{
+	/** Mass assumed for receivers without a physics body, matching the simulator's actor queries */
+	constexpr float DefaultReceiverMass = 1000.0f;
+}
+
+UGravityReceiverComponent::UGravityReceiverComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	MassOverride = 0.0f;
+	GravityScale = 1.0f;
+	ReceiverMode = EGravityReceiverMode::Automatic;
+	Primitive = nullptr;
+	CachedMass = DefaultReceiverMass;
+}
+
+void UGravityReceiverComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ResolvePrimitive();
+
+	if (Primitive)
+	{
+		Primitive->OnComponentPhysicsStateChanged.AddDynamic(this, &UGravityReceiverComponent::OnPrimitivePhysicsStateChanged);
+	}
+
+	RefreshMass();
+
+	UWorld* World = GetWorld();
+	if (UGravitySimulator* GravitySimulator = World ? World->GetSubsystem<UGravitySimulator>() : nullptr)
+	{
+		GravitySimulator->RegisterGravityReceiver(this);
+		Simulator = GravitySimulator;
+	}
+}
+
+void UGravityReceiverComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGravitySimulator* GravitySimulator = Simulator.Get())
+	{
+		GravitySimulator->UnregisterGravityReceiver(this);
+	}
+	Simulator.Reset();
+
+	if (Primitive)
+	{
+		Primitive->OnComponentPhysicsStateChanged.RemoveDynamic(this, &UGravityReceiverComponent::OnPrimitivePhysicsStateChanged);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGravityReceiverComponent::SetMassOverride(float NewMassOverride)
+{
+	MassOverride = FMath::Max(NewMassOverride, 0.0f);
+}
+
+void UGravityReceiverComponent::RefreshMass()
+{
+	// A primitive without a physics body has no meaningful mass
+	const FBodyInstance* BodyInstance = Primitive ? Primitive->GetBodyInstance() : nullptr;
+	CachedMass = BodyInstance && BodyInstance->IsValidBodyInstance() ? Primitive->GetMass() : DefaultReceiverMass;
+}
+
+void UGravityReceiverComponent::OnPrimitivePhysicsStateChanged(UPrimitiveComponent* ChangedComponent, EComponentPhysicsStateChange StateChange)
+{
+	RefreshMass();
+}
+
+void UGravityReceiverComponent::ResolvePrimitive()
+{
+	AActor* Owner = GetOwner();
+	if (Primitive || !Owner)
+	{
+		return;
+	}
+
+	Primitive = Cast<UPrimitiveComponent>(Owner->GetRootComponent());
+	if (!Primitive)
+	{
+		Primitive = Owner->FindComponentByClass<UPrimitiveComponent>();
+	}
+}
@@ -0,0 +1,219 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravitySOITree.h"
+#include "GravityBodySnapshot.h"
+#include "AstronomicalConstants.h"
+#include "CelestialBodyComponent.h"
+#include "GravityStats.h"
+
+void FGravitySOITree::Build(const FGravityBodySnapshot& Snapshot)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravitySOITree::Build);
+
+	Nodes.Reset();
+	Nodes.SetNum(Snapshot.Num());
+	Root = INDEX_NONE;
+	NumBodies = 0;
+
+	// Place bodies heaviest first so every candidate parent already has its SOI
+	TArray<int32> Order;
+	Order.Reserve(Snapshot.Num());
+
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+	{
+		Nodes[BodyIndex].Body = Snapshot.Bodies[BodyIndex];
+
+		if (Snapshot.IsValidIndex(BodyIndex))
+		{
+			Order.Add(BodyIndex);
+		}
+	}
+
+	Order.Sort([&Snapshot](int32 A, int32 B)
+	{
+		return Snapshot.Mass[A] > Snapshot.Mass[B];
+	});
+
+	for (int32 BodyIndex : Order)
+	{
+		FNode& Node = Nodes[BodyIndex];
+		Node.BuildPosition = Snapshot.GetPosition(BodyIndex);
+		Node.bInTree = true;
+		++NumBodies;
+
+		if (Root == INDEX_NONE)
+		{
+			Root = BodyIndex;
+			Node.SOIRadius = TNumericLimits<double>::Max();
+			continue;
+		}
+
+		const int32 Parent = DescendFrom(Snapshot, Root, Node.BuildPosition);
+		const double SemiMajorAxis = FVector::Dist(Node.BuildPosition, Nodes[Parent].BuildPosition);
+
+		Node.Parent = Parent;
+		Node.SOIRadius = UAstronomicalConstantsLibrary::CalculateSphereOfInfluence(SemiMajorAxis, Snapshot.Mass[Parent], Snapshot.Mass[BodyIndex]);
+		Nodes[Parent].Children.Add(BodyIndex);
+	}
+}
+
+bool FGravitySOITree::NeedsRebuild(const FGravityBodySnapshot& Snapshot) const
+{
+	if (Nodes.Num() != Snapshot.Num())
+	{
+		return true;
+	}
+
+	const double MoveFractionSquared = RebuildMoveFraction * RebuildMoveFraction;
+
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+	{
+		const FNode& Node = Nodes[BodyIndex];
+
+		if (Node.Body != Snapshot.Bodies[BodyIndex] || Node.bInTree != Snapshot.IsValidIndex(BodyIndex))
+		{
+			return true;
+		}
+
+		if (!Node.bInTree)
+		{
+			continue;
+		}
+
+		// Roots have no finite SOI; measure them against their tightest child instead
+		double Reference = Node.SOIRadius;
+		if (Node.Parent == INDEX_NONE)
+		{
+			Reference = TNumericLimits<double>::Max();
+			for (int32 Child : Node.Children)
+			{
+				Reference = FMath::Min(Reference, Nodes[Child].SOIRadius);
+			}
+		}
+
+		if (Reference < TNumericLimits<double>::Max()
+			&& FVector::DistSquared(Snapshot.GetPosition(BodyIndex), Node.BuildPosition) > MoveFractionSquared * Reference * Reference)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32 FGravitySOITree::FindDominantBody(const FGravityBodySnapshot& Snapshot, const FVector& Position) const
+{
+	return Root != INDEX_NONE ? DescendFrom(Snapshot, Root, Position) : INDEX_NONE;
+}
+
+int32 FGravitySOITree::FindDominantBody(const FGravityBodySnapshot& Snapshot, const FVector& Position, double Hysteresis,
+	FGravityDominantBodyCache& Cache) const
+{
+	if (Root == INDEX_NONE)
+	{
+		Cache = FGravityDominantBodyCache();
+		return INDEX_NONE;
+	}
+
+	// Bodies were registered or removed since the cache was filled: find the same body again by handle
+	if (Cache.RegistryGeneration != Snapshot.RegistryGeneration)
+	{
+		Cache.BodyIndex = Snapshot.IndexOf(Cache.Body);
+		Cache.RegistryGeneration = Snapshot.RegistryGeneration;
+	}
+
+	// No usable cache: plain descent from the root
+	if (!Nodes.IsValidIndex(Cache.BodyIndex) || !Nodes[Cache.BodyIndex].bInTree)
+	{
+		Cache.BodyIndex = DescendFrom(Snapshot, Root, Position);
+		Cache.Body = Snapshot.GetHandle(Cache.BodyIndex);
+		return Cache.BodyIndex;
+	}
+
+	// Climb out only once clearly outside the cached body's SOI
+	const double ExitScale = 1.0 + Hysteresis;
+	int32 Current = Cache.BodyIndex;
+
+	while (Current != Root)
+	{
+		const double ExitRadius = Nodes[Current].SOIRadius * ExitScale;
+		if (FVector::DistSquared(Position, Snapshot.GetPosition(Current)) <= ExitRadius * ExitRadius)
+		{
+			break;
+		}
+
+		Current = Nodes[Current].Parent;
+	}
+
+	// Enter a child only once clearly inside its SOI
+	Cache.BodyIndex = DescendFrom(Snapshot, Current, Position, FMath::Max(1.0 - Hysteresis, 0.0));
+	Cache.Body = Snapshot.GetHandle(Cache.BodyIndex);
+	return Cache.BodyIndex;
+}
+
+void FGravitySOITree::GetInfluenceChain(const FGravityBodySnapshot& Snapshot, const FVector& Position, int32 MaxBodies,
+	TArray<int32, TInlineAllocator<8>>& OutIndices) const
+{
+	OutIndices.Reset();
+	WalkChain(FindDominantBody(Snapshot, Position), MaxBodies, OutIndices);
+}
+
+void FGravitySOITree::GetInfluenceChain(const FGravityBodySnapshot& Snapshot, const FVector& Position, int32 MaxBodies, double Hysteresis,
+	FGravityDominantBodyCache& Cache, TArray<int32, TInlineAllocator<8>>& OutIndices) const
+{
+	OutIndices.Reset();
+	WalkChain(FindDominantBody(Snapshot, Position, Hysteresis, Cache), MaxBodies, OutIndices);
+}
+
+void FGravitySOITree::WalkChain(int32 BodyIndex, int32 MaxBodies, TArray<int32, TInlineAllocator<8>>& OutIndices) const
+{
+	for (; BodyIndex != INDEX_NONE && OutIndices.Num() < MaxBodies; BodyIndex = Nodes[BodyIndex].Parent)
+	{
+		OutIndices.Add(BodyIndex);
+	}
+}
+
+double FGravitySOITree::GetSphereOfInfluence(int32 BodyIndex) const
+{
+	return Nodes.IsValidIndex(BodyIndex) && Nodes[BodyIndex].bInTree ? Nodes[BodyIndex].SOIRadius : 0.0;
+}
+
+int32 FGravitySOITree::GetParent(int32 BodyIndex) const
+{
+	return Nodes.IsValidIndex(BodyIndex) ? Nodes[BodyIndex].Parent : INDEX_NONE;
+}
+
+TConstArrayView<int32> FGravitySOITree::GetChildren(int32 BodyIndex) const
+{
+	return Nodes.IsValidIndex(BodyIndex) ? TConstArrayView<int32>(Nodes[BodyIndex].Children) : TConstArrayView<int32>();
+}
+
+int32 FGravitySOITree::DescendFrom(const FGravityBodySnapshot& Snapshot, int32 BodyIndex, const FVector& Position, double RadiusScale) const
+{
+	int32 Current = BodyIndex;
+
+	while (true)
+	{
+		int32 Next = INDEX_NONE;
+		double NearestDistanceSquared = TNumericLimits<double>::Max();
+
+		for (int32 Child : Nodes[Current].Children)
+		{
+			const double SOIRadius = Nodes[Child].SOIRadius * RadiusScale;
+			const double DistanceSquared = FVector::DistSquared(Position, Snapshot.GetPosition(Child));
+
+			if (DistanceSquared < SOIRadius * SOIRadius && DistanceSquared < NearestDistanceSquared)
+			{
+				NearestDistanceSquared = DistanceSquared;
+				Next = Child;
+			}
+		}
+
+		if (Next == INDEX_NONE)
+		{
+			return Current;
+		}
+
+		Current = Next;
+	}
+}
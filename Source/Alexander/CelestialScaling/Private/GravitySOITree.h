@@ -0,0 +1,114 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+struct FGravityBodySnapshot;
+struct FGravityDominantBodyCache;
+class UCelestialBodyComponent;
+
+/**
+ * Parent/child sphere-of-influence hierarchy over the bodies of a snapshot
+ * The heaviest body is the root with unbounded SOI; every other body's parent is the
+ * deepest heavier body whose SOI contains it, and its SOI radius is the Laplace sphere
+ * r = a * (m / M)^(2/5) relative to that parent
+ * Rebuilt only when the body set changes or a body moves a significant fraction of its SOI
+ */
+class FGravitySOITree
+{
+public:
+	/** Fraction of a body's SOI it may move before the tree is rebuilt */
+	static constexpr double RebuildMoveFraction = 0.05;
+
+	/**
+	 * Build the hierarchy from the valid bodies of a snapshot
+	 * @param Snapshot - Snapshot whose indices the tree refers to
+	 */
+	void Build(const FGravityBodySnapshot& Snapshot);
+
+	/**
+	 * Whether the tree no longer describes a snapshot
+	 * True when bodies were added, removed or reordered, or moved significantly since the build
+	 */
+	bool NeedsRebuild(const FGravityBodySnapshot& Snapshot) const;
+
+	/**
+	 * Snapshot index of the deepest body whose SOI contains a position
+	 * @return Snapshot body index, or INDEX_NONE if the tree is empty
+	 */
+	int32 FindDominantBody(const FGravityBodySnapshot& Snapshot, const FVector& Position) const;
+
+	/**
+	 * Dominant body, revalidated from a receiver's cached result
+	 * The cached body is kept until the position leaves its SOI grown by Hysteresis, and a child
+	 * only takes over once the position is inside its SOI shrunk by Hysteresis, so receivers near
+	 * a boundary do not flicker between bodies. Costs a walk of the neighbouring nodes instead of a full descent.
+	 * @param Hysteresis - Fraction of an SOI radius used as the band on either side of its boundary
+	 * @param Cache - Receiver cache, read and updated
+	 * @return Snapshot body index, or INDEX_NONE if the tree is empty
+	 */
+	int32 FindDominantBody(const FGravityBodySnapshot& Snapshot, const FVector& Position, double Hysteresis, FGravityDominantBodyCache& Cache) const;
+
+	/**
+	 * Dominant body followed by its ancestors, nearest SOI first
+	 * @param MaxBodies - Maximum number of bodies to return
+	 * @param OutIndices - Snapshot body indices
+	 */
+	void GetInfluenceChain(const FGravityBodySnapshot& Snapshot, const FVector& Position, int32 MaxBodies, TArray<int32, TInlineAllocator<8>>& OutIndices) const;
+
+	/** Influence chain starting from a receiver's revalidated dominant body */
+	void GetInfluenceChain(const FGravityBodySnapshot& Snapshot, const FVector& Position, int32 MaxBodies, double Hysteresis,
+		FGravityDominantBodyCache& Cache, TArray<int32, TInlineAllocator<8>>& OutIndices) const;
+
+	/** SOI radius of a snapshot body (max double for root bodies, 0 if not in the tree) */
+	double GetSphereOfInfluence(int32 BodyIndex) const;
+
+	/** Snapshot index of a body's SOI parent, or INDEX_NONE for roots */
+	int32 GetParent(int32 BodyIndex) const;
+
+	/** Direct SOI children of a snapshot body */
+	TConstArrayView<int32> GetChildren(int32 BodyIndex) const;
+
+	/** Number of bodies in the tree */
+	int32 GetNumBodies() const { return NumBodies; }
+
+private:
+	struct FNode
+	{
+		/** Parent body index, INDEX_NONE for roots */
+		int32 Parent = INDEX_NONE;
+
+		/** Laplace SOI radius relative to the parent */
+		double SOIRadius = 0.0;
+
+		/** Position when the tree was built, for movement checks */
+		FVector BuildPosition = FVector::ZeroVector;
+
+		/** Body identity when the tree was built */
+		TWeakObjectPtr<UCelestialBodyComponent> Body;
+
+		/** Child body indices */
+		TArray<int32> Children;
+
+		bool bInTree = false;
+	};
+
+	/**
+	 * Descend from a node into the child whose SOI contains the position
+	 * @param RadiusScale - Multiplier on child SOI radii (below 1 requires the position to be well inside)
+	 */
+	int32 DescendFrom(const FGravityBodySnapshot& Snapshot, int32 BodyIndex, const FVector& Position, double RadiusScale = 1.0) const;
+
+	/** Append a body and its ancestors */
+	void WalkChain(int32 BodyIndex, int32 MaxBodies, TArray<int32, TInlineAllocator<8>>& OutIndices) const;
+
+	/** Nodes indexed by snapshot body index */
+	TArray<FNode> Nodes;
+
+	/** Heaviest body, INDEX_NONE when empty */
+	int32 Root = INDEX_NONE;
+
+	int32 NumBodies = 0;
+};
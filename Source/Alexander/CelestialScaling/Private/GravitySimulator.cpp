@@ -4,11 +4,189 @@
 #include "CelestialBodyComponent.h"
 #include "CelestialBodyRegistry.h"
 #include "AstronomicalConstants.h"
+#include "GravityKernels.h"
+#include "GravityOctree.h"
+#include "GravitySOITree.h"
+#include "GravityStats.h"
+#include "GravityFieldClipmap.h"
+#include "GravityOrbitIntegrator.h"
+#include "GravityTrajectoryPredictor.h"
+#include "GravityChebyshevEphemeris.h"
+#include "GravityDeterministic.h"
+#include "GravityReceiverComponent.h"
+#include "GravityDebugRenderer.h"
 #include "Components/PrimitiveComponent.h"
 #include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
 #include "Engine/World.h"
 #include "DrawDebugHelpers.h"
 #include "Math/UnrealMathUtility.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+DEFINE_STAT(STAT_GravitySingleBody);
+DEFINE_STAT(STAT_GravityMultiBody);
+DEFINE_STAT(STAT_GravityNBody);
+DEFINE_STAT(STAT_GravityBarnesHut);
+DEFINE_STAT(STAT_GravityBuildSnapshot);
+DEFINE_STAT(STAT_GravityStep);
+DEFINE_STAT(STAT_GravityApply);
+DEFINE_STAT(STAT_GravityReplay);
+DEFINE_STAT(STAT_GravityOrbits);
+DEFINE_STAT(STAT_GravityTrajectory);
+DEFINE_STAT(STAT_GravityEphemeris);
+DEFINE_STAT(STAT_GravityBodyEvents);
+DEFINE_STAT(STAT_GravityDebugDraw);
+DEFINE_STAT(STAT_CelestialScaleUpdate);
+DEFINE_STAT(STAT_GravityCalculations);
+DEFINE_STAT(STAT_GravityTargets);
+DEFINE_STAT(STAT_GravityDebugLines);
+DEFINE_STAT(STAT_CelestialBodiesScaled);
+
+namespace
+{
+	/** Adds the wall time of a scope to a per-frame cycle accumulator */
+	struct FScopedCalculationTimer
+	{
+		explicit FScopedCalculationTimer(std::atomic<uint64>& InAccumulator)
+			: Accumulator(InAccumulator)
+			, StartCycles(FPlatformTime::Cycles64())
+		{
+		}
+
+		~FScopedCalculationTimer()
+		{
+			Accumulator.fetch_add(FPlatformTime::Cycles64() - StartCycles, std::memory_order_relaxed);
+		}
+
+		std::atomic<uint64>& Accumulator;
+		uint64 StartCycles;
+	};
+
+	/** Fraction of a radius a target must move back out before the same surface or atmosphere can fire again */
+	constexpr double ContactReleaseFraction = 0.01;
+
+	/**
+	 * Earliest fraction along Start -> End at which the segment lies inside a sphere
+	 * @return False if the segment never touches the sphere (0 if Start is already inside)
+	 */
+	bool FindSphereEntry(const FVector& Start, const FVector& End, const FVector& Center, double Radius, double& OutFraction)
+	{
+		const FVector FromCenter = Start - Center;
+		const double StartOutside = FromCenter.SizeSquared() - Radius * Radius;
+
+		if (StartOutside <= 0.0)
+		{
+			OutFraction = 0.0;
+			return true;
+		}
+
+		// |FromCenter + t Direction|² = Radius², nearer root; half-b form
+		const FVector Direction = End - Start;
+		const double A = Direction.SizeSquared();
+		const double HalfB = FVector::DotProduct(FromCenter, Direction);
+
+		if (A <= 0.0 || HalfB >= 0.0)
+		{
+			return false;
+		}
+
+		const double Discriminant = HalfB * HalfB - A * StartOutside;
+		if (Discriminant < 0.0)
+		{
+			return false;
+		}
+
+		OutFraction = (-HalfB - FMath::Sqrt(Discriminant)) / A;
+		return OutFraction <= 1.0;
+	}
+
+	/** Nearest-rank percentile of an unsorted sample set */
+	template <typename ValueType>
+	ValueType CalculatePercentile(TArray<ValueType> Values, float Fraction)
+	{
+		if (Values.Num() == 0)
+		{
+			return ValueType();
+		}
+
+		Values.Sort();
+		const int32 Rank = FMath::Clamp(FMath::CeilToInt32(Fraction * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Rank];
+	}
+
+	FAutoConsoleCommandWithWorld GGravityDumpStatsCommand(
+		TEXT("Gravity.DumpStats"),
+		TEXT("Log gravity simulator averages and p50/p99 per-frame calculation time and count"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UGravitySimulator* Simulator = World ? World->GetSubsystem<UGravitySimulator>() : nullptr)
+			{
+				Simulator->DumpSimulationStatistics();
+			}
+		}));
+
+	FAutoConsoleCommandWithWorldAndArgs GGravityCookEphemerisCommand(
+		TEXT("Gravity.CookEphemeris"),
+		TEXT("Cook orbiting bodies into a Chebyshev ephemeris: Gravity.CookEphemeris <DurationSeconds> [SegmentSeconds=3600] [Coefficients=12] [File=Saved/Gravity/Ephemeris.gcep]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UGravitySimulator* Simulator = World ? World->GetSubsystem<UGravitySimulator>() : nullptr;
+			if (!Simulator || Args.Num() < 1)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Usage: Gravity.CookEphemeris <DurationSeconds> [SegmentSeconds] [Coefficients] [File]"));
+				return;
+			}
+
+			const double Duration = FCString::Atod(*Args[0]);
+			const double SegmentDuration = Args.Num() > 1 ? FCString::Atod(*Args[1]) : 3600.0;
+			const int32 NumCoefficients = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 12;
+			const FString Filename = Args.Num() > 3 ? Args[3] : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Gravity"), TEXT("Ephemeris.gcep"));
+
+			Simulator->CookOrbitEphemeris(Filename, Duration, SegmentDuration, NumCoefficients);
+		}));
+
+	FAutoConsoleCommand GGravityDeterminismTestCommand(
+		TEXT("Gravity.DeterminismTest"),
+		TEXT("Step a synthetic system with deterministic gravity on different thread counts, body orders and split body sums and compare state hashes: Gravity.DeterminismTest [Steps=10000] [Targets=256]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumSteps = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+			const int32 NumTargets = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 256;
+			GravityDeterministic::RunSelfTest(NumSteps, NumTargets);
+		}));
+
+	/** Resolve a designer-facing path against the project directory */
+	FString ResolveProjectPath(const FString& Filename)
+	{
+		return FPaths::IsRelative(Filename) ? FPaths::Combine(FPaths::ProjectDir(), Filename) : Filename;
+	}
+
+	/**
+	 * Resolve a virtual position against the snapshot's origin sector
+	 * A local offset wider than a sector means the origin manager uses a different sector size than gravity does
+	 */
+	FVector ResolveVirtualPosition(const FGravitySimulationParams& Params, const FVirtualPosition& Position)
+	{
+		ensureMsgf(Position.LocalPosition.GetAbsMax() <= Params.SectorSize,
+			TEXT("GravitySimulator: Virtual position offset %s exceeds the %.0f sector size; CelestialScalingConstants::VirtualSectorSize must match the player origin manager"),
+			*Position.LocalPosition.ToString(), Params.SectorSize);
+		return Params.ResolveSectorPosition(Position.SectorCoordinates, Position.LocalPosition);
+	}
+
+	/** Kernel parameters matching a snapshot's captured settings */
+	GravityKernels::FGravityKernelParams MakeKernelParams(const FGravitySimulationParams& SimParams)
+	{
+		GravityKernels::FGravityKernelParams Params;
+		Params.MinDistanceSquared = SimParams.MinGravityDistance * SimParams.MinGravityDistance;
+		Params.MaxInfluencingBodies = 3;
+		Params.OpeningAngle = SimParams.BarnesHutOpeningAngle;
+		Params.DominantBodyHysteresis = SimParams.DominantBodyHysteresis;
+		return Params;
+	}
+}
 
 void UGravitySimulator::Initialize(FSubsystemCollectionBase& Collection)
 {
@@ -22,16 +200,70 @@ void UGravitySimulator::Initialize(FSubsystemCollectionBase& Collection)
 	GravitationalConstant = CelestialScalingConstants::SolSystem::G;
 	PhysicsScaleFactor = 1.0f;
 	bAutoDiscoverBodies = true;
-	MaxInfluenceDistance = 1000000.0f; // 10 km
+	bUseBarnesHut = true;
+	BarnesHutOpeningAngle = 0.5f;
+	BarnesHutMinBodies = 64;
 	GravityUpdateFrequency = 60.0f; // 60 Hz
+	bAutoApplyGravity = true;
+	ParallelBatchSize = 128;
+	DominantBodyHysteresis = 0.05f;
+	PredictionCorrectionThreshold = 10.0f; // 10 cm
+	bDeterministicGravity = false;
+	bDetectBodyEvents = true;
+	MaxPredictionReplaySteps = 16;
+	bUseGravityField = true;
+	GravityFieldMassThreshold = 1000.0f; // Debris and loot; ships are heavier
+	GravityFieldLevels = 4;
+	GravityFieldResolution = 16;
+	GravityFieldCellSize = 10000.0f; // 100 m innermost spacing
+	GravityFieldRefreshBudget = 512;
+	bGravityFieldReady = false;
+	bSimulateOrbits = true;
+	OrbitIntegrationMethod = EGravityOrbitIntegrator::Leapfrog;
+	OrbitStepFrequency = 60.0f;
+	MaxOrbitSubSteps = 8;
+	OrbitWriteBackTolerance = 10.0f; // 10 cm
+	OrbitEnergyDriftWarning = 0.001f;
+	OrbitTimeAccumulator = 0.0;
+	OrbitEnergyDrift = 0.0;
+	bOrbitDriftWarned = false;
+	OnRailsPerturbationScale = 1.0f;
+	OrbitTimeWarp = 1.0f;
+	MaxTrajectorySteps = 2048;
+	TrajectoryReusePositionTolerance = 100.0f; // 1 m
+	TrajectoryReuseVelocityTolerance = 10.0f; // 10 cm/s
+	bAdaptiveTrajectories = true;
+	AdaptiveRelativeTolerance = 1.0e-8;
+	AdaptiveAbsoluteTolerance = 1.0; // 1 cm
+	AdaptiveMaxStepSize = 600.0;
+	OriginSector = FIntVector::ZeroValue;
+	MaxGravitySubSteps = 4;
+	bInterpolateGravity = true;
+	GravityTimeAccumulator = 0.0;
+	GravityStepAlpha = 0.0f;
 	bEnableDebugVisualization = false;
 	bEnableDebugLogging = false;
 	DebugForceColor = FColor::Yellow;
+	DebugMaxLinesPerFrame = 4096;
+	DebugMaxLabels = 8;
+	DebugRenderer = MakeShared<FGravityDebugRenderer>();
 
 	// Initialize statistics
 	CalculationsThisFrame = 0;
+	CalculationCyclesThisFrame = 0;
+	TotalCalculations = 0;
 	TotalCalculationTime = 0.0f;
 	FrameCounter = 0;
+	FrameTimeHistory.Reset(StatisticsHistoryLength);
+	FrameCalculationHistory.Reset(StatisticsHistoryLength);
+	StatisticsHistoryHead = 0;
+
+	// Preallocate rewind history so recording and validation never allocate
+	StateHistories.SetNum(MaxRewindActors);
+	StateHistoryIndices.Reserve(MaxRewindActors);
+
+	// Nothing published yet; the first game-thread query publishes
+	bSimulationStateDirty = true;
 
 	UE_LOG(LogTemp, Log, TEXT("GravitySimulator: Initialized with mode %d, G = %.6e"),
 		static_cast<int32>(CurrentSimulationMode), GravitationalConstant);
@@ -49,25 +281,106 @@ void UGravitySimulator::Deinitialize()
 			AvgCalcs, AvgTime);
 	}
 
+	{
+		FScopeLock Lock(&SnapshotLock);
+		PublishedSnapshot.Reset();
+	}
+	GravityTargets.Empty();
+	GravityTargetKeys.Empty();
+	GravityTargetStates.Empty();
+	GravityTargetDominantBodies.Empty();
+	GravityTargetIndices.Empty();
+	GravityTargetReceivers.Empty();
+	PendingBodyEvents.Empty();
+	GravityReceivers.Empty();
+	GravityReceiverIndices.Empty();
+	GravityField.Reset();
+	bGravityFieldReady = false;
+	OrbitIntegrator.Reset();
+	if (TrajectoryService.IsValid())
+	{
+		TrajectoryService->Reset();
+		TrajectoryService.Reset();
+	}
+	StateHistories.Empty();
+	StateHistoryIndices.Empty();
+	DebugRenderer.Reset();
+
 	Super::Deinitialize();
 
 	UE_LOG(LogTemp, Log, TEXT("GravitySimulator: Deinitialized"));
 }
 
+void UGravitySimulator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Everything calculated since the previous tick belongs to the frame that just ended
+	EndStatisticsFrame();
+
+	// Debug shapes queued by bodies and callers during this frame go out in one submission
+	FlushDebugDrawing();
+
+	// Bodies move first so this frame's snapshot and forces see their new positions
+	if (bGravityEnabled && bSimulateOrbits)
+	{
+		StepOrbits(DeltaTime);
+	}
+
+	// Predictions need no targets; they only poll finished tasks and launch pending requests
+	UpdateTrajectoryPredictions();
+
+	if (!bGravityEnabled || GravityTargets.Num() == 0)
+	{
+		return;
+	}
+
+	// Forces are evaluated at GravityUpdateFrequency; every frame applies the cached result
+	StepGravity(DeltaTime);
+	BroadcastBodyEvents();
+
+	if (bAutoApplyGravity)
+	{
+		ApplyCachedGravity();
+	}
+}
+
+TStatId UGravitySimulator::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGravitySimulator, STATGROUP_Gravity);
+}
+
 // ========== Gravitational Force Calculation ==========
 
 FVector UGravitySimulator::CalculateTotalGravitationalForce(AActor* Target, const FVector& TargetPosition) const
 {
-	if (!bGravityEnabled || !Target)
+	if (!Target)
 	{
 		return FVector::ZeroVector;
 	}
 
-	FScopeLock Lock(&SimulationLock);
+	FScopedCalculationTimer Timer(CalculationCyclesThisFrame);
+
+	// All queries this frame share one published snapshot; no locks are taken
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+	const FGravitySimulationParams& Params = Snapshot->Params;
+
+	if (!Params.bGravityEnabled)
+	{
+		return FVector::ZeroVector;
+	}
 
-	// Get target mass (default to 1000 kg if not specified)
+	// Receivers carry their mass and scale; other actors fall back to a component search (default 1000 kg).
+	// The receiver registry is game-thread state, so other threads look for the component on the actor
 	float TargetMass = 1000.0f;
-	if (UPrimitiveComponent* PrimComp = Target->FindComponentByClass<UPrimitiveComponent>())
+	float GravityScale = 1.0f;
+	const UGravityReceiverComponent* Receiver = IsInGameThread() ? FindGravityReceiver(Target) : Target->FindComponentByClass<UGravityReceiverComponent>();
+	if (Receiver)
+	{
+		TargetMass = Receiver->GetGravityMass();
+		GravityScale = Receiver->GravityScale;
+	}
+	else if (UPrimitiveComponent* PrimComp = Target->FindComponentByClass<UPrimitiveComponent>())
 	{
 		if (PrimComp->IsSimulatingPhysics())
 		{
@@ -75,39 +388,88 @@ FVector UGravitySimulator::CalculateTotalGravitationalForce(AActor* Target, cons
 		}
 	}
 
-	// Calculate based on simulation mode
-	FVector TotalForce = FVector::ZeroVector;
+	const FVector TotalForce = CalculateForceAtPosition(*Snapshot, TargetPosition, TargetMass, GravityScale);
 
-	switch (CurrentSimulationMode)
+	if (bEnableDebugLogging)
 	{
-	case EGravitySimulationMode::SingleBody:
-		TotalForce = CalculateSingleBodyGravity(TargetPosition, TargetMass);
-		break;
+		UE_LOG(LogTemp, Verbose, TEXT("GravitySimulator: Total force on %s = %s N"),
+			*Target->GetName(), *TotalForce.ToString());
+	}
 
-	case EGravitySimulationMode::MultiBody:
-		TotalForce = CalculateMultiBodyGravity(TargetPosition, TargetMass);
-		break;
+	return TotalForce;
+}
 
-	case EGravitySimulationMode::NBody:
-		TotalForce = CalculateNBodyGravity(TargetPosition, TargetMass);
-		break;
+void UGravitySimulator::CalculateGravitationalForcesBatch(const TArray<FVector>& TargetPositions, const TArray<float>& TargetMasses, TArray<FVector>& OutForces) const
+{
+	OutForces.SetNumUninitialized(TargetPositions.Num());
 
-	case EGravitySimulationMode::Disabled:
-		return FVector::ZeroVector;
+	if (TargetMasses.Num() != TargetPositions.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Batch size mismatch (%d positions, %d masses)"),
+			TargetPositions.Num(), TargetMasses.Num());
+		for (FVector& Force : OutForces)
+		{
+			Force = FVector::ZeroVector;
+		}
+		return;
 	}
 
-	// Validate and clamp the force
-	TotalForce = ValidateForce(TotalForce, TargetMass);
+	CalculateGravitationalForces(TargetPositions, TargetMasses, OutForces);
+}
+
+void UGravitySimulator::CalculateGravitationalForces(TArrayView<const FVector> TargetPositions, TArrayView<const float> TargetMasses, TArrayView<FVector> OutForces) const
+{
+	check(TargetPositions.Num() == TargetMasses.Num() && TargetPositions.Num() == OutForces.Num());
 
-	CalculationsThisFrame++;
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGravitySimulator::CalculateGravitationalForces);
+	FScopedCalculationTimer Timer(CalculationCyclesThisFrame);
 
-	if (bEnableDebugLogging)
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+	CalculateForcesFromSnapshot(*Snapshot, TargetPositions, TargetMasses, OutForces);
+
+	CalculationsThisFrame.fetch_add(OutForces.Num(), std::memory_order_relaxed);
+}
+
+void UGravitySimulator::CalculateForcesFromSnapshot(const FGravityBodySnapshot& Snapshot, TArrayView<const FVector> TargetPositions,
+	TArrayView<const float> TargetMasses, TArrayView<FVector> OutForces, TArrayView<FGravityDominantBodyCache> DominantBodies,
+	TArrayView<const float> GravityScales) const
+{
+	const FGravitySimulationParams& SimParams = Snapshot.Params;
+
+	if (!SimParams.bGravityEnabled || SimParams.Mode == EGravitySimulationMode::Disabled)
 	{
-		UE_LOG(LogTemp, Verbose, TEXT("GravitySimulator: Total force on %s = %s N"),
-			*Target->GetName(), *TotalForce.ToString());
+		for (FVector& Force : OutForces)
+		{
+			Force = FVector::ZeroVector;
+		}
+		return;
 	}
 
-	return TotalForce;
+	const GravityKernels::FGravityKernelParams Params = MakeKernelParams(SimParams);
+
+	// Kernels write accelerations into the output buffer, then scale by target mass in place
+	if (SimParams.bDeterministic)
+	{
+		for (int32 TargetIndex = 0; TargetIndex < TargetPositions.Num(); ++TargetIndex)
+		{
+			OutForces[TargetIndex] = GravityDeterministic::ComputeAcceleration(Snapshot, Params, TargetPositions[TargetIndex]);
+		}
+	}
+	else
+	{
+		GravityKernels::ComputeAccelerations(SimParams.Mode, Snapshot, Params, TargetPositions, OutForces, DominantBodies);
+	}
+
+	for (int32 TargetIndex = 0; TargetIndex < OutForces.Num(); ++TargetIndex)
+	{
+		const float TargetMass = TargetMasses[TargetIndex];
+		const FVector Force = TargetMass > 0.0f
+			? OutForces[TargetIndex] * (static_cast<double>(TargetMass) * SimParams.PhysicsScaleFactor)
+			: FVector::ZeroVector;
+
+		const float GravityScale = GravityScales.IsValidIndex(TargetIndex) ? GravityScales[TargetIndex] : 1.0f;
+		OutForces[TargetIndex] = ValidateForce(Force, TargetMass, SimParams, GravityScale);
+	}
 }
 
 FVector UGravitySimulator::CalculateGravityFromBody(UCelestialBodyComponent* Body, const FVector& TargetPosition, float TargetMass) const
@@ -117,36 +479,24 @@ FVector UGravitySimulator::CalculateGravityFromBody(UCelestialBodyComponent* Bod
 		return FVector::ZeroVector;
 	}
 
-	// Get body position and mass
-	FVector BodyPosition = Body->GetOwner()->GetActorLocation();
-	float BodyMass = Body->GetMass();
+	// Get body position and mass (double throughout; float distances collapse at interplanetary range)
+	const FVector BodyPosition = Body->GetOwner()->GetActorLocation();
+	const double BodyMass = Body->GetMass();
 
-	if (BodyMass <= 0.0f)
+	if (BodyMass <= 0.0)
 	{
 		return FVector::ZeroVector;
 	}
 
 	// Calculate distance vector
-	FVector DeltaPosition = BodyPosition - TargetPosition;
-	float Distance = DeltaPosition.Size();
-
-	// Prevent singularities
-	if (Distance < MinGravityDistance)
-	{
-		Distance = MinGravityDistance;
-	}
-
-	// Calculate gravitational force: F = G * (m1 * m2) / r²
-	double DistanceSquared = static_cast<double>(Distance) * static_cast<double>(Distance);
-	double ForceMagnitude = (GravitationalConstant * BodyMass * TargetMass) / DistanceSquared;
-
-	// Direction towards the body
-	FVector Direction = DeltaPosition.GetSafeNormal();
+	const FVector DeltaPosition = BodyPosition - TargetPosition;
+	const double Distance = FMath::Max(DeltaPosition.Size(), static_cast<double>(MinGravityDistance));
 
-	// Apply physics scale factor
-	FVector Force = Direction * static_cast<float>(ForceMagnitude) * PhysicsScaleFactor;
+	// Calculate gravitational force: F = GM * m / r²
+	const double ForceMagnitude = (GravitationalConstant * BodyMass) * TargetMass / (Distance * Distance);
 
-	return Force;
+	// Direction towards the body, with physics scale factor applied
+	return DeltaPosition.GetSafeNormal() * (ForceMagnitude * PhysicsScaleFactor);
 }
 
 FVector UGravitySimulator::CalculateGravitationalAcceleration(UCelestialBodyComponent* Body, const FVector& TargetPosition) const
@@ -157,63 +507,88 @@ FVector UGravitySimulator::CalculateGravitationalAcceleration(UCelestialBodyComp
 	}
 
 	// Get body position and mass
-	FVector BodyPosition = Body->GetOwner()->GetActorLocation();
-	float BodyMass = Body->GetMass();
+	const FVector BodyPosition = Body->GetOwner()->GetActorLocation();
+	const double BodyMass = Body->GetMass();
 
-	if (BodyMass <= 0.0f)
+	if (BodyMass <= 0.0)
 	{
 		return FVector::ZeroVector;
 	}
 
 	// Calculate distance vector
-	FVector DeltaPosition = BodyPosition - TargetPosition;
-	float Distance = DeltaPosition.Size();
-
-	// Prevent singularities
-	if (Distance < MinGravityDistance)
-	{
-		Distance = MinGravityDistance;
-	}
+	const FVector DeltaPosition = BodyPosition - TargetPosition;
+	const double Distance = FMath::Max(DeltaPosition.Size(), static_cast<double>(MinGravityDistance));
 
 	// Calculate gravitational acceleration: a = G * M / r²
-	double DistanceSquared = static_cast<double>(Distance) * static_cast<double>(Distance);
-	double AccelerationMagnitude = (GravitationalConstant * BodyMass) / DistanceSquared;
+	const double AccelerationMagnitude = (GravitationalConstant * BodyMass) / (Distance * Distance);
 
 	// Direction towards the body
-	FVector Direction = DeltaPosition.GetSafeNormal();
+	return DeltaPosition.GetSafeNormal() * AccelerationMagnitude;
+}
+
+FVector UGravitySimulator::CalculateGravitationalForceAtVirtualPosition(const FVirtualPosition& Position, float TargetMass) const
+{
+	FScopedCalculationTimer Timer(CalculationCyclesThisFrame);
+
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+	if (!Snapshot->Params.bGravityEnabled)
+	{
+		return FVector::ZeroVector;
+	}
 
-	return Direction * static_cast<float>(AccelerationMagnitude);
+	const FVector TargetPosition = ResolveVirtualPosition(Snapshot->Params, Position);
+	return CalculateForceAtPosition(*Snapshot, TargetPosition, TargetMass);
 }
 
-UCelestialBodyComponent* UGravitySimulator::GetDominantGravitationalBody(const FVector& Position) const
+FVector UGravitySimulator::VirtualToSimulationPosition(const FVirtualPosition& Position) const
 {
-	TArray<UCelestialBodyComponent*> Bodies = GetCelestialBodies();
+	return ResolveVirtualPosition(GetBodySnapshot()->Params, Position);
+}
 
-	if (Bodies.Num() == 0)
+void UGravitySimulator::SetOriginSector(const FIntVector& Sector)
+{
+	if (OriginSector != Sector)
 	{
-		return nullptr;
+		OriginSector = Sector;
+		bSimulationStateDirty = true;
 	}
+}
 
-	UCelestialBodyComponent* DominantBody = nullptr;
-	float MaxInfluence = 0.0f;
+FVector UGravitySimulator::CalculateForceAtPosition(const FGravityBodySnapshot& Snapshot, const FVector& TargetPosition, float TargetMass, float GravityScale) const
+{
+	// Calculate based on simulation mode
+	FVector TotalForce = FVector::ZeroVector;
 
-	for (UCelestialBodyComponent* Body : Bodies)
+	switch (Snapshot.Params.Mode)
 	{
-		if (!IsValid(Body))
-		{
-			continue;
-		}
+	case EGravitySimulationMode::SingleBody:
+		TotalForce = CalculateSingleBodyGravity(Snapshot, TargetPosition, TargetMass);
+		break;
 
-		float Influence = CalculateInfluenceStrength(Body, Position);
+	case EGravitySimulationMode::MultiBody:
+		TotalForce = CalculateMultiBodyGravity(Snapshot, TargetPosition, TargetMass);
+		break;
 
-		if (Influence > MaxInfluence)
-		{
-			MaxInfluence = Influence;
-			DominantBody = Body;
-		}
+	case EGravitySimulationMode::NBody:
+		TotalForce = CalculateNBodyGravity(Snapshot, TargetPosition, TargetMass);
+		break;
+
+	case EGravitySimulationMode::Disabled:
+		return FVector::ZeroVector;
 	}
 
-	return DominantBody;
+	CalculationsThisFrame.fetch_add(1, std::memory_order_relaxed);
+
+	// Scale, validate and clamp the force
+	return ValidateForce(TotalForce, TargetMass, Snapshot.Params, GravityScale);
+}
+
+UCelestialBodyComponent* UGravitySimulator::GetDominantGravitationalBody(const FVector& Position) const
+{
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+
+	const int32 DominantIndex = FindDominantBodyIndex(*Snapshot, Position);
+	return DominantIndex != INDEX_NONE ? Snapshot->Bodies[DominantIndex].Get() : nullptr;
 }
 
 // ========== Physics Integration ==========
@@ -226,7 +601,8 @@ void UGravitySimulator::ApplyGravityToActor(AActor* Target, float DeltaTime)
 	}
 
 	// Find the primitive component to apply force to
-	UPrimitiveComponent* PrimComp = Target->FindComponentByClass<UPrimitiveComponent>();
+	const UGravityReceiverComponent* Receiver = FindGravityReceiver(Target);
+	UPrimitiveComponent* PrimComp = Receiver ? Receiver->Primitive.Get() : Target->FindComponentByClass<UPrimitiveComponent>();
 
 	if (PrimComp && PrimComp->IsSimulatingPhysics())
 	{
@@ -246,17 +622,28 @@ void UGravitySimulator::ApplyGravityToComponent(UPrimitiveComponent* Component,
 		return;
 	}
 
-	// Calculate gravitational force
-	FVector Position = Component->GetComponentLocation();
-	FVector Force = CalculateTotalGravitationalForce(Component->GetOwner(), Position);
+	// Registered targets reuse the fixed-rate cache; the tick already applies it when auto-apply is on
+	FVector Force;
+	if (const int32* TargetIndex = GravityTargetIndices.Find(Component))
+	{
+		if (bAutoApplyGravity || !GravityTargetStates[*TargetIndex].bHasForce)
+		{
+			return;
+		}
+
+		Force = SampleCachedForce(GravityTargetStates[*TargetIndex]);
+	}
+	else
+	{
+		// Calculate gravitational force
+		FVector Position = Component->GetComponentLocation();
+		Force = CalculateTotalGravitationalForce(Component->GetOwner(), Position);
+	}
 
-	// Convert to Unreal force units
+	// Convert to Unreal force units (already limited to MaxGForce when it was calculated)
 	float Mass = Component->GetMass();
 	FVector UnrealForce = ConvertNewtonsToUnrealForce(Force, Mass);
 
-	// Clamp to max G-force
-	UnrealForce = ClampGravitationalForce(UnrealForce, MaxGForce);
-
 	// Apply force in world space
 	Component->AddForce(UnrealForce, NAME_None, false);
 
@@ -267,192 +654,1283 @@ void UGravitySimulator::ApplyGravityToComponent(UPrimitiveComponent* Component,
 	}
 }
 
-FVector UGravitySimulator::ConvertNewtonsToUnrealForce(const FVector& ForceInNewtons, float TargetMass) const
-{
-	// Unreal Engine uses kg·cm/s² for force
-	// 1 Newton = 100 Unreal force units (kg·cm/s²)
-	return ForceInNewtons * 100.0f;
-}
-
-FVector UGravitySimulator::ClampGravitationalForce(const FVector& Force, float MaxGForceLimit) const
+void UGravitySimulator::RegisterGravityTarget(UPrimitiveComponent* Component)
 {
-	// Calculate G-force magnitude
-	float ForceMagnitude = Force.Size();
-
-	// 1 G = 9.80665 m/s² = 980.665 cm/s²
-	float OneG = 980.665f;
-	float MaxForce = MaxGForceLimit * OneG;
-
-	if (ForceMagnitude > MaxForce)
+	if (!IsValid(Component) || GravityTargetIndices.Contains(Component))
 	{
-		// Clamp to maximum
-		return Force.GetSafeNormal() * MaxForce;
+		return;
 	}
 
-	return Force;
+	GravityTargetIndices.Add(Component, GravityTargets.Num());
+	GravityTargets.Add(Component);
+	GravityTargetKeys.Add(Component);
+	GravityTargetStates.AddDefaulted();
+	GravityTargetDominantBodies.AddDefaulted();
+	GravityTargetReceivers.AddDefaulted();
 }
 
-// ========== Sphere of Influence ==========
-
-bool UGravitySimulator::IsWithinInfluenceRadius(UCelestialBodyComponent* Body, const FVector& Position, float InfluenceRadius) const
+void UGravitySimulator::UnregisterGravityTarget(UPrimitiveComponent* Component)
 {
-	if (!Body || !IsValid(Body))
+	if (const int32* Index = GravityTargetIndices.Find(Component))
 	{
-		return false;
+		RemoveGravityTargetAt(*Index);
 	}
+}
 
-	// Calculate radius if not provided
-	if (InfluenceRadius <= 0.0f)
+FVector UGravitySimulator::GetCachedGravitationalForce(UPrimitiveComponent* Component) const
+{
+	const int32* Index = GravityTargetIndices.Find(Component);
+	if (!Index || !GravityTargetStates[*Index].bHasForce)
 	{
-		InfluenceRadius = CalculateSphereOfInfluence(Body);
+		return FVector::ZeroVector;
 	}
 
-	FVector BodyPosition = Body->GetOwner()->GetActorLocation();
-	float Distance = FVector::Dist(Position, BodyPosition);
-
-	return Distance <= InfluenceRadius;
+	return SampleCachedForce(GravityTargetStates[*Index]);
 }
 
-float UGravitySimulator::CalculateSphereOfInfluence(UCelestialBodyComponent* Body) const
+void UGravitySimulator::RegisterGravityReceiver(UGravityReceiverComponent* Receiver)
 {
-	if (!Body || !IsValid(Body))
+	const AActor* Owner = Receiver ? Receiver->GetOwner() : nullptr;
+	if (!IsValid(Receiver) || !Owner || GravityReceiverIndices.Contains(Owner))
 	{
-		return 0.0f;
+		return;
 	}
 
-	// Simplified SOI calculation
-	// In reality, this uses the Laplace sphere: r_SOI = a * (m_satellite / m_primary)^(2/5)
-	// For now, use a simple multiple of the body radius
-	float BodyRadius = Body->GetRadius();
-	float BodyMass = Body->GetMass();
+	GravityReceiverIndices.Add(Owner, GravityReceivers.Num());
+	GravityReceivers.Add(Receiver);
 
-	// SOI scales with mass^(1/3) approximately
-	float SOIMultiplier = FMath::Pow(BodyMass / 1.0e24f, 0.333f);
+	UPrimitiveComponent* Primitive = Receiver->Primitive;
+	if (!IsValid(Primitive))
+	{
+		return;
+	}
 
-	return BodyRadius * 100.0f * FMath::Max(SOIMultiplier, 2.0f); // At least 2x radius
+	RegisterGravityTarget(Primitive);
+	GravityTargetReceivers[GravityTargetIndices.FindChecked(Primitive)] = Receiver;
 }
 
-TArray<UCelestialBodyComponent*> UGravitySimulator::GetInfluencingBodies(const FVector& Position, int32 MaxBodies) const
+void UGravitySimulator::UnregisterGravityReceiver(UGravityReceiverComponent* Receiver)
 {
-	TArray<UCelestialBodyComponent*> AllBodies = GetCelestialBodies();
-	TArray<TPair<float, UCelestialBodyComponent*>> BodiesWithInfluence;
-
-	for (UCelestialBodyComponent* Body : AllBodies)
+	const AActor* Owner = Receiver ? Receiver->GetOwner() : nullptr;
+	const int32* Index = Owner ? GravityReceiverIndices.Find(Owner) : nullptr;
+	if (!Index || GravityReceivers[*Index].Get() != Receiver)
 	{
-		if (!IsValid(Body))
-		{
-			continue;
-		}
+		return;
+	}
 
-		float Influence = CalculateInfluenceStrength(Body, Position);
+	const int32 RemovedIndex = *Index;
+	GravityReceiverIndices.Remove(Owner);
+	GravityReceivers.RemoveAtSwap(RemovedIndex, 1, EAllowShrinking::No);
 
-		if (Influence > 0.0f)
+	// Fix up the index of the receiver swapped into the hole
+	if (GravityReceivers.IsValidIndex(RemovedIndex))
+	{
+		if (const UGravityReceiverComponent* Moved = GravityReceivers[RemovedIndex].Get())
 		{
-			BodiesWithInfluence.Add(TPair<float, UCelestialBodyComponent*>(Influence, Body));
+			GravityReceiverIndices.Add(Moved->GetOwner(), RemovedIndex);
 		}
 	}
 
-	// Sort by influence strength (descending)
-	BodiesWithInfluence.Sort([](const TPair<float, UCelestialBodyComponent*>& A, const TPair<float, UCelestialBodyComponent*>& B)
-	{
-		return A.Key > B.Key;
-	});
+	UnregisterGravityTarget(Receiver->Primitive);
+}
 
-	// Extract top N bodies
-	TArray<UCelestialBodyComponent*> InfluencingBodies;
-	int32 NumToReturn = FMath::Min(MaxBodies, BodiesWithInfluence.Num());
+UGravityReceiverComponent* UGravitySimulator::FindGravityReceiver(const AActor* Actor) const
+{
+	const int32* Index = Actor ? GravityReceiverIndices.Find(Actor) : nullptr;
+	return Index ? GravityReceivers[*Index].Get() : nullptr;
+}
 
-	for (int32 i = 0; i < NumToReturn; ++i)
+UCelestialBodyComponent* UGravitySimulator::GetCachedDominantBody(UPrimitiveComponent* Component) const
+{
+	const int32* Index = GravityTargetIndices.Find(Component);
+	if (!Index)
 	{
-		InfluencingBodies.Add(BodiesWithInfluence[i].Value);
+		return nullptr;
 	}
 
-	return InfluencingBodies;
-}
-
-// ========== Configuration ==========
+	// The index is only meaningful for the generation the cache was filled from; otherwise go by handle
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+	const FGravityDominantBodyCache& Cache = GravityTargetDominantBodies[*Index];
 
-void UGravitySimulator::SetSimulationMode(EGravitySimulationMode Mode)
-{
-	if (CurrentSimulationMode != Mode)
+	const int32 BodyIndex = Cache.RegistryGeneration == Snapshot->RegistryGeneration ? Cache.BodyIndex : Snapshot->IndexOf(Cache.Body);
+	if (!Snapshot->Bodies.IsValidIndex(BodyIndex))
 	{
-		CurrentSimulationMode = Mode;
-
-		UE_LOG(LogTemp, Log, TEXT("GravitySimulator: Simulation mode changed to %d"), static_cast<int32>(Mode));
+		return nullptr;
 	}
-}
 
-// ========== Network Prediction ==========
+	return Snapshot->Bodies[BodyIndex].Get();
+}
 
-bool UGravitySimulator::ValidateClientPrediction(int32 ActorID, const FVector& ClientPosition, const FVector& ClientVelocity,
-	FVector& OutCorrectedPosition, FVector& OutCorrectedVelocity)
+void UGravitySimulator::RemoveGravityTargetAt(int32 Index)
 {
-	// Server-side validation of client's predicted physics
-	// For now, simple implementation that accepts client prediction
-	// In production, would compare with server simulation and correct if divergent
-
-	OutCorrectedPosition = ClientPosition;
-	OutCorrectedVelocity = ClientVelocity;
+	// The stored key outlives the component, so collected targets leave no stale entry behind
+	GravityTargetIndices.Remove(GravityTargetKeys[Index]);
 
-	// Threshold for position correction (10 cm)
-	float CorrectionThreshold = 10.0f;
+	GravityTargets.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GravityTargetKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GravityTargetStates.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GravityTargetDominantBodies.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GravityTargetReceivers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
 
-	// TODO: Implement actual server-side simulation comparison
-	// For now, no correction needed
-	return false;
+	// Fix up the index of the element swapped into the hole
+	if (GravityTargetKeys.IsValidIndex(Index))
+	{
+		GravityTargetIndices.Add(GravityTargetKeys[Index], Index);
+	}
 }
 
-// ========== Debug ==========
-
-void UGravitySimulator::DrawGravityDebug(AActor* Target, float Duration) const
+void UGravitySimulator::StepOrbits(float DeltaTime)
 {
-	if (!bEnableDebugVisualization || !Target || !GetWorld())
+	SCOPE_CYCLE_COUNTER(STAT_GravityOrbits);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGravitySimulator::StepOrbits);
+
+	UWorld* World = GetWorld();
+	UCelestialBodyRegistry* Registry = World ? World->GetSubsystem<UCelestialBodyRegistry>() : nullptr;
+	if (!Registry)
 	{
 		return;
 	}
 
-	FVector TargetPosition = Target->GetActorLocation();
-	TArray<UCelestialBodyComponent*> Bodies = GetCelestialBodies();
+	if (!OrbitIntegrator.IsValid())
+	{
+		OrbitIntegrator = MakeShared<FGravityOrbitIntegrator>();
+
+		if (!OrbitEphemerisFile.IsEmpty())
+		{
+			LoadOrbitEphemeris(OrbitEphemerisFile);
+		}
+	}
+
+	const FGravityOrbitParams Params = GetOrbitParams();
+	const TSharedRef<const FCelestialBodyList, ESPMode::ThreadSafe> BodyList = GetCelestialBodies();
+	OrbitIntegrator->Sync(BodyList->Bodies, BodyList->Generation, GravitationalConstant, World->GetNetMode() == NM_Client, Params);
+
+	if (OrbitIntegrator->GetNumMovingBodies() == 0)
+	{
+		OrbitTimeAccumulator = 0.0;
+		OrbitEnergyDrift = 0.0;
+		return;
+	}
+
+	// Players near an on-rails body need it integrated; time warp keeps everything that can on rails
+	OrbitProbePositions.Reset();
+	for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (const APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr)
+		{
+			OrbitProbePositions.Add(PlayerPawn->GetActorLocation());
+		}
+	}
+
+	const bool bWarping = OrbitTimeWarp > 1.0f;
+	OrbitIntegrator->UpdatePropagationModes(OrbitProbePositions, OnRailsPerturbationScale, !bWarping, Params);
+
+	// Bodies were added, removed or moved by someone else: drift is measured from here on
+	if (OrbitIntegrator->NeedsEnergyReference())
+	{
+		OrbitIntegrator->ResetEnergyReference(Params);
+		bOrbitDriftWarned = false;
+	}
+
+	const double StepInterval = 1.0 / FMath::Max(OrbitStepFrequency, 1.0f);
+	const double TimeWarp = FMath::Max(static_cast<double>(OrbitTimeWarp), 0.0);
+	OrbitTimeAccumulator += DeltaTime;
+
+	int32 NumSteps = FMath::FloorToInt32(OrbitTimeAccumulator / StepInterval);
+
+	// Frame spike: run at most MaxOrbitSubSteps and drop the rest of the backlog
+	const int32 MaxSteps = FMath::Max(MaxOrbitSubSteps, 1);
+	if (NumSteps > MaxSteps)
+	{
+		OrbitTimeAccumulator -= (NumSteps - MaxSteps) * StepInterval;
+		NumSteps = MaxSteps;
+	}
+
+	if (NumSteps == 0)
+	{
+		return;
+	}
+
+	if (OrbitIntegrationMethod == EGravityOrbitIntegrator::DormandPrince45)
+	{
+		// Substeps are chosen by error control, so the frame's whole backlog is one call
+		OrbitIntegrator->Step(NumSteps * StepInterval * TimeWarp, OrbitIntegrationMethod, Params);
+		OrbitTimeAccumulator -= NumSteps * StepInterval;
+	}
+	else
+	{
+		for (int32 Step = 0; Step < NumSteps; ++Step)
+		{
+			OrbitIntegrator->Step(StepInterval * TimeWarp, OrbitIntegrationMethod, Params);
+			OrbitTimeAccumulator -= StepInterval;
+		}
+	}
+
+	OrbitIntegrator->WriteBack(OrbitWriteBackTolerance);
+	bSimulationStateDirty = true;
+
+	// Bodies just moved; registry queries later this frame must see the new positions
+	Registry->InvalidateSpatialIndex();
+
+	OrbitEnergyDrift = OrbitIntegrator->GetEnergyDrift(Params);
+	if (OrbitEnergyDrift > OrbitEnergyDriftWarning && !bOrbitDriftWarned)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Orbit energy drifted by %.3e (limit %.3e); consider a higher OrbitStepFrequency or the Yoshida integrator"),
+			OrbitEnergyDrift, OrbitEnergyDriftWarning);
+		bOrbitDriftWarned = true;
+	}
+}
+
+FGravityOrbitParams UGravitySimulator::GetOrbitParams() const
+{
+	// Same scaling as forces applied to physics targets: GM / r² * physics scale, Newtons to Unreal units
+	FGravityOrbitParams Params;
+	Params.AccelerationScale = static_cast<double>(PhysicsScaleFactor) * 100.0;
+	Params.MinDistanceSquared = static_cast<double>(MinGravityDistance) * MinGravityDistance;
+	Params.Adaptive = GetAdaptiveStepParams();
+	return Params;
+}
+
+void UGravitySimulator::SetOrbitSimulationTime(double Time)
+{
+	if (!OrbitIntegrator.IsValid())
+	{
+		OrbitIntegrator = MakeShared<FGravityOrbitIntegrator>();
+	}
+
+	OrbitIntegrator->JumpToTime(Time);
+	OrbitIntegrator->WriteBack(OrbitWriteBackTolerance);
+	OrbitTimeAccumulator = 0.0;
+	bSimulationStateDirty = true;
+}
+
+double UGravitySimulator::GetOrbitSimulationTime() const
+{
+	return OrbitIntegrator.IsValid() ? OrbitIntegrator->GetSimulationTime() : 0.0;
+}
+
+bool UGravitySimulator::LoadOrbitEphemeris(const FString& Filename)
+{
+	TSharedRef<FGravityChebyshevEphemeris, ESPMode::ThreadSafe> Ephemeris = MakeShared<FGravityChebyshevEphemeris, ESPMode::ThreadSafe>();
+	if (!Ephemeris->Load(ResolveProjectPath(Filename)))
+	{
+		return false;
+	}
+
+	if (!OrbitIntegrator.IsValid())
+	{
+		OrbitIntegrator = MakeShared<FGravityOrbitIntegrator>();
+	}
+
+	OrbitEphemeris = Ephemeris;
+	OrbitIntegrator->SetEphemeris(OrbitEphemeris);
+	return true;
+}
+
+bool UGravitySimulator::CookOrbitEphemeris(const FString& Filename, double Duration, double SegmentDuration, int32 NumCoefficients)
+{
+	if (!OrbitIntegrator.IsValid() || OrbitIntegrator->GetNumMovingBodies() == 0 || Duration <= 0.0 || SegmentDuration <= 0.0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Nothing to cook; orbits must be running and Duration/SegmentDuration positive"));
+		return false;
+	}
+
+	// Integrate a copy so the live bodies are untouched; bodies already read from a table are resampled from it
+	FGravityOrbitIntegrator Cooker = *OrbitIntegrator;
+	const FGravityOrbitParams Params = GetOrbitParams();
+
+	TArray<FName> BodyIDs;
+	TArray<int32> Indices;
+	for (UCelestialBodyComponent* Body : GetCelestialBodies()->Bodies)
+	{
+		const int32 Index = Cooker.FindBodyIndex(Body);
+		if (Body->bSimulateOrbit && Body->BodyID != NAME_None && Index != INDEX_NONE)
+		{
+			BodyIDs.Add(Body->BodyID);
+			Indices.Add(Index);
+		}
+	}
+
+	if (BodyIDs.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: No orbiting body has a BodyID to cook"));
+		return false;
+	}
+
+	// Keep numerical bodies at the live step size; rails, tables and the adaptive method are exact at any step
+	const bool bAnyStepSize = Cooker.GetNumNumerical() == 0 || OrbitIntegrationMethod == EGravityOrbitIntegrator::DormandPrince45;
+	const double MaxStep = bAnyStepSize ? TNumericLimits<double>::Max() : 1.0 / FMath::Max(OrbitStepFrequency, 1.0f);
+
+	const int32 NumSegments = FMath::CeilToInt32(Duration / SegmentDuration);
+
+	return FGravityChebyshevEphemeris::Cook(ResolveProjectPath(Filename), BodyIDs, Cooker.GetSimulationTime(), NumSegments, SegmentDuration, NumCoefficients,
+		[&](double Time, TArrayView<FVector> OutPositions)
+		{
+			for (double Remaining = Time - Cooker.GetSimulationTime(); Remaining > 0.0; Remaining = Time - Cooker.GetSimulationTime())
+			{
+				Cooker.Step(FMath::Min(Remaining, MaxStep), OrbitIntegrationMethod, Params);
+			}
+
+			for (int32 Slot = 0; Slot < Indices.Num(); ++Slot)
+			{
+				OutPositions[Slot] = Cooker.GetPositionAt(Indices[Slot]);
+			}
+		});
+}
+
+FGravityAdaptiveStepParams UGravitySimulator::GetAdaptiveStepParams() const
+{
+	FGravityAdaptiveStepParams Params;
+	Params.RelativeTolerance = AdaptiveRelativeTolerance;
+	Params.AbsoluteTolerance = AdaptiveAbsoluteTolerance;
+	Params.MaxStep = FMath::Max(AdaptiveMaxStepSize, Params.MinStep);
+	return Params;
+}
+
+FVector UGravitySimulator::GetBodyOrbitalVelocity(UCelestialBodyComponent* Body) const
+{
+	FVector Velocity = FVector::ZeroVector;
+	if (OrbitIntegrator.IsValid())
+	{
+		OrbitIntegrator->GetVelocity(Body, Velocity);
+	}
+	return Velocity;
+}
+
+bool UGravitySimulator::SetBodyOrbitalVelocity(UCelestialBodyComponent* Body, const FVector& Velocity)
+{
+	return OrbitIntegrator.IsValid() && OrbitIntegrator->SetVelocity(Body, Velocity, GetOrbitParams());
+}
+
+bool UGravitySimulator::IsBodyOnRails(UCelestialBodyComponent* Body) const
+{
+	return OrbitIntegrator.IsValid() && OrbitIntegrator->IsOnRails(Body);
+}
+
+void UGravitySimulator::RequestTrajectoryPrediction(int32 PredictionID, const FVector& Position, const FVector& Velocity, int32 NumSteps, float StepSize)
+{
+	if (StepSize <= 0.0f || NumSteps <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Ignoring trajectory request %d with %d steps of %.3f s"), PredictionID, NumSteps, StepSize);
+		return;
+	}
+
+	if (!TrajectoryService.IsValid())
+	{
+		TrajectoryService = MakeShared<FGravityTrajectoryService>();
+	}
+
+	FGravityTrajectoryContext Context;
+	FillTrajectoryContext(Context);
+
+	FGravityTrajectoryRequest Request;
+	Request.Position = Position;
+	Request.Velocity = Velocity;
+	Request.StartTime = Context.CurrentTime;
+	Request.StepSize = StepSize;
+	Request.NumSteps = FMath::Min(NumSteps, FMath::Max(MaxTrajectorySteps, 1));
+
+	TrajectoryService->Request(PredictionID, Request, Context);
+}
+
+bool UGravitySimulator::GetTrajectoryPrediction(int32 PredictionID, FGravityTrajectoryPrediction& OutPrediction) const
+{
+	const FGravityTrajectoryPrediction* Prediction = TrajectoryService.IsValid() ? TrajectoryService->Find(PredictionID) : nullptr;
+	if (!Prediction)
+	{
+		return false;
+	}
+
+	OutPrediction = *Prediction;
+	return true;
+}
+
+void UGravitySimulator::CancelTrajectoryPrediction(int32 PredictionID)
+{
+	if (TrajectoryService.IsValid())
+	{
+		TrajectoryService->Cancel(PredictionID);
+	}
+}
+
+void UGravitySimulator::FillTrajectoryContext(FGravityTrajectoryContext& OutContext) const
+{
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+	const FGravitySimulationParams& SimParams = Snapshot->Params;
+
+	OutContext.Snapshot = Snapshot;
+	OutContext.KernelParams = MakeKernelParams(SimParams);
+
+	OutContext.Orbits = bSimulateOrbits ? OrbitIntegrator.Get() : nullptr;
+	OutContext.OrbitMethod = OrbitIntegrationMethod;
+	OutContext.OrbitParams = GetOrbitParams();
+
+	const UWorld* World = GetWorld();
+	OutContext.CurrentTime = World ? World->GetTimeSeconds() : 0.0;
+	OutContext.FrameNumber = GFrameCounter;
+	OutContext.ReusePositionTolerance = TrajectoryReusePositionTolerance;
+	OutContext.ReuseVelocityTolerance = TrajectoryReuseVelocityTolerance;
+	OutContext.bAdaptive = bAdaptiveTrajectories;
+	OutContext.Adaptive = GetAdaptiveStepParams();
+}
+
+void UGravitySimulator::UpdateTrajectoryPredictions()
+{
+	if (!TrajectoryService.IsValid())
+	{
+		return;
+	}
+
+	FGravityTrajectoryContext Context;
+	FillTrajectoryContext(Context);
+
+	TArray<int32> Completed;
+	TrajectoryService->Update(Context, Completed);
+
+	for (const int32 PredictionID : Completed)
+	{
+		// Listeners may request or cancel, which can move the stored prediction; broadcast a copy
+		if (const FGravityTrajectoryPrediction* Found = TrajectoryService->Find(PredictionID))
+		{
+			const FGravityTrajectoryPrediction Prediction = *Found;
+			OnTrajectoryPredicted.Broadcast(PredictionID, Prediction);
+		}
+	}
+}
+
+void UGravitySimulator::UpdateGravityField()
+{
+	bGravityFieldReady = false;
+
+	const FGravitySimulationParams SimParams = GetBodySnapshot()->Params;
+	if (!bUseGravityField || !SimParams.bGravityEnabled || SimParams.Mode == EGravitySimulationMode::Disabled)
+	{
+		return;
+	}
+
+	// The field follows the local player; dedicated servers and spectators have none
+	UWorld* World = GetWorld();
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+	if (!PlayerPawn)
+	{
+		return;
+	}
+
+	if (!GravityField.IsValid())
+	{
+		GravityField = MakeShared<FGravityFieldClipmap>();
+	}
+
+	if (!GravityField->IsConfiguredFor(GravityFieldLevels, GravityFieldResolution, GravityFieldCellSize))
+	{
+		GravityField->Configure(GravityFieldLevels, GravityFieldResolution, GravityFieldCellSize);
+	}
+
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+	const int32 NumEvaluated = GravityField->Update(*Snapshot, MakeKernelParams(SimParams), PlayerPawn->GetActorLocation(), GravityFieldRefreshBudget);
+
+	CalculationsThisFrame.fetch_add(NumEvaluated, std::memory_order_relaxed);
+	bGravityFieldReady = true;
+}
+
+bool UGravitySimulator::SampleGravityField(const FVector& Position, FVector& OutAcceleration) const
+{
+	OutAcceleration = FVector::ZeroVector;
+	return bGravityFieldReady && GravityField->Sample(Position, OutAcceleration);
+}
+
+void UGravitySimulator::StepGravity(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityStep);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGravitySimulator::StepGravity);
+
+	// Drop stale targets before anything indexes the arrays
+	for (int32 Index = GravityTargets.Num() - 1; Index >= 0; --Index)
+	{
+		if (!GravityTargets[Index].IsValid())
+		{
+			RemoveGravityTargetAt(Index);
+		}
+	}
+
+	if (GravityTargets.Num() == 0)
+	{
+		GravityTimeAccumulator = 0.0;
+		return;
+	}
+
+	const double StepInterval = 1.0 / FMath::Max(GravityUpdateFrequency, 1.0f);
+	GravityTimeAccumulator += DeltaTime;
+
+	int32 NumSteps = FMath::FloorToInt32(GravityTimeAccumulator / StepInterval);
+
+	// Frame spike: run at most MaxGravitySubSteps and drop the rest of the backlog
+	const int32 MaxSteps = FMath::Max(MaxGravitySubSteps, 1);
+	if (NumSteps > MaxSteps)
+	{
+		GravityTimeAccumulator -= (NumSteps - MaxSteps) * StepInterval;
+		NumSteps = MaxSteps;
+	}
+
+	for (FGravityReceiverState& State : GravityTargetStates)
+	{
+		State.StepForceSum = FVector::ZeroVector;
+		State.StepsThisFrame = 0;
+	}
+
+	if (NumSteps > 0)
+	{
+		UpdateGravityField();
+	}
+
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		GravityTimeAccumulator -= StepInterval;
+
+		// Each step is evaluated where the target was when the step fell due
+		EvaluateGravityStep(-GravityTimeAccumulator);
+	}
+
+	// Newly registered targets get a force immediately rather than waiting for the next step
+	const bool bAnyMissing = GravityTargetStates.ContainsByPredicate([](const FGravityReceiverState& State)
+	{
+		return !State.bHasForce;
+	});
+
+	if (bAnyMissing)
+	{
+		EvaluateGravityStep(0.0, true);
+	}
+
+	GravityStepAlpha = FMath::Clamp(static_cast<float>(GravityTimeAccumulator / StepInterval), 0.0f, 1.0f);
+}
+
+void UGravitySimulator::EvaluateGravityStep(double TimeOffset, bool bMissingOnly)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGravitySimulator::EvaluateGravityStep);
+	FScopedCalculationTimer Timer(CalculationCyclesThisFrame);
+
+	// Gather on the game thread
+	const int32 NumTargets = GravityTargets.Num();
+
+	TickPositions.Reset();
+	TickMasses.Reset();
+	TickFieldSampled.Reset();
+	TickGravityScales.Reset();
+	TickForces.SetNumUninitialized(NumTargets, EAllowShrinking::No);
+
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+	const FGravitySimulationParams& SimParams = Snapshot->Params;
+
+	int32 NumEvaluated = 0;
+
+	for (int32 Index = 0; Index < NumTargets; ++Index)
+	{
+		// Targets that already have a force are marked as covered so no batch evaluates them
+		if (bMissingOnly && GravityTargetStates[Index].bHasForce)
+		{
+			TickPositions.Add(FVector::ZeroVector);
+			TickMasses.Add(0.0f);
+			TickGravityScales.Add(1.0f);
+			TickFieldSampled.Add(1);
+			continue;
+		}
+
+		++NumEvaluated;
+
+		UPrimitiveComponent* Component = GravityTargets[Index].Get();
+		const bool bSimulating = Component && Component->IsSimulatingPhysics();
+		const FVector Position = bSimulating ? Component->GetComponentLocation() + Component->GetPhysicsLinearVelocity() * TimeOffset : FVector::ZeroVector;
+		// Receivers supply a cached mass and their own settings; plain targets query the body
+		const UGravityReceiverComponent* Receiver = GravityTargetReceivers[Index].Get();
+		const EGravityReceiverMode ReceiverMode = Receiver ? Receiver->ReceiverMode : EGravityReceiverMode::Automatic;
+		const float Mass = !bSimulating ? 0.0f : Receiver ? Receiver->GetGravityMass() : Component->GetMass();
+
+		const float GravityScale = Receiver ? Receiver->GravityScale : 1.0f;
+
+		TickPositions.Add(Position);
+		TickMasses.Add(Mass);
+		TickGravityScales.Add(GravityScale);
+
+		// Light targets read the field: a few memory reads instead of a kernel evaluation
+		const bool bWantsField = ReceiverMode == EGravityReceiverMode::Field
+			|| (ReceiverMode == EGravityReceiverMode::Automatic && Mass < GravityFieldMassThreshold);
+
+		FVector Acceleration;
+		const bool bFieldSampled = bSimulating && bWantsField && bGravityFieldReady && !SimParams.bDeterministic
+			&& GravityField->Sample(Position, Acceleration);
+
+		if (bFieldSampled)
+		{
+			TickForces[Index] = ValidateForce(Acceleration * (static_cast<double>(Mass) * SimParams.PhysicsScaleFactor), Mass, SimParams, GravityScale);
+		}
+		TickFieldSampled.Add(bFieldSampled ? 1 : 0);
+	}
+
+	// Compute the rest on worker threads, one snapshot shared by every batch
+	const int32 BatchSize = FMath::Max(ParallelBatchSize, 16);
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumTargets, BatchSize);
+
+	ParallelFor(NumBatches, [this, &Snapshot, BatchSize, NumTargets](int32 BatchIndex)
+	{
+		const int32 Start = BatchIndex * BatchSize;
+		const int32 End = FMath::Min(Start + BatchSize, NumTargets);
+
+		// Evaluate each contiguous run of targets that the field did not cover
+		int32 RunStart = Start;
+		for (int32 Index = Start; Index <= End; ++Index)
+		{
+			if (Index < End && !TickFieldSampled[Index])
+			{
+				continue;
+			}
+
+			if (Index > RunStart)
+			{
+				const int32 Count = Index - RunStart;
+				CalculateForcesFromSnapshot(*Snapshot,
+					TArrayView<const FVector>(TickPositions.GetData() + RunStart, Count),
+					TArrayView<const float>(TickMasses.GetData() + RunStart, Count),
+					TArrayView<FVector>(TickForces.GetData() + RunStart, Count),
+					TArrayView<FGravityDominantBodyCache>(GravityTargetDominantBodies.GetData() + RunStart, Count),
+					TArrayView<const float>(TickGravityScales.GetData() + RunStart, Count));
+			}
+
+			RunStart = Index + 1;
+		}
+	});
+
+	CalculationsThisFrame.fetch_add(NumEvaluated, std::memory_order_relaxed);
+
+	// New targets start their event sweep on the next full step; zero mass here would reset everyone else's
+	if (bDetectBodyEvents && !bMissingOnly)
+	{
+		const UWorld* World = GetWorld();
+		DetectBodyEvents(*Snapshot, (World ? World->GetTimeSeconds() : 0.0) + TimeOffset);
+	}
+
+	// Shift the per-receiver cache
+	for (int32 Index = 0; Index < NumTargets; ++Index)
+	{
+		FGravityReceiverState& State = GravityTargetStates[Index];
+		if (bMissingOnly && State.bHasForce)
+		{
+			continue;
+		}
+
+		const FVector& Force = TickForces[Index];
+
+		State.PreviousForce = State.bHasForce ? State.CurrentForce : Force;
+		State.CurrentForce = Force;
+		State.bHasForce = true;
+		State.StepForceSum += Force;
+		State.StepsThisFrame++;
+	}
+}
+
+void UGravitySimulator::DetectBodyEvents(const FGravityBodySnapshot& Snapshot, double StepTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityBodyEvents);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGravitySimulator::DetectBodyEvents);
+
+	const int32 NumTargets = GravityTargets.Num();
+	const int32 BatchSize = FMath::Max(ParallelBatchSize, 16);
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumTargets, BatchSize);
+
+	TickBatchEvents.SetNum(NumBatches, EAllowShrinking::No);
+
+	ParallelFor(NumBatches, [this, &Snapshot, StepTime, BatchSize, NumTargets](int32 BatchIndex)
+	{
+		TArray<FGravityBodyEvent>& Events = TickBatchEvents[BatchIndex];
+		Events.Reset();
+
+		const int32 End = FMath::Min((BatchIndex + 1) * BatchSize, NumTargets);
+		for (int32 Index = BatchIndex * BatchSize; Index < End; ++Index)
+		{
+			FGravityReceiverState& State = GravityTargetStates[Index];
+
+			// Zero mass marks targets that were not simulating this step
+			if (TickMasses[Index] <= 0.0f)
+			{
+				State.bHasPosition = false;
+				continue;
+			}
+
+			const FVector& Position = TickPositions[Index];
+			const int32 SOIBody = Snapshot.SOITree.IsValid()
+				? Snapshot.SOITree->FindDominantBody(Snapshot, Position, Snapshot.Params.DominantBodyHysteresis, State.SOICache)
+				: INDEX_NONE;
+
+			// First step, or indices from another registry generation: record where the target is without reporting crossings
+			if (!State.bHasPosition || State.ContactGeneration != Snapshot.RegistryGeneration)
+			{
+				State.SurfaceBody = INDEX_NONE;
+				State.AtmosphereBody = INDEX_NONE;
+
+				for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+				{
+					const double DistanceSquared = FVector::DistSquared(Snapshot.GetPosition(BodyIndex), Position);
+					if (Snapshot.IsValidIndex(BodyIndex) && DistanceSquared < FMath::Square(Snapshot.Radius[BodyIndex]))
+					{
+						State.SurfaceBody = BodyIndex;
+					}
+					if (Snapshot.IsValidIndex(BodyIndex) && DistanceSquared < FMath::Square(Snapshot.AtmosphereRadius[BodyIndex]))
+					{
+						State.AtmosphereBody = BodyIndex;
+					}
+				}
+
+				State.SOIBody = SOIBody;
+				State.ContactGeneration = Snapshot.RegistryGeneration;
+				State.LastPosition = Position;
+				State.LastTime = StepTime;
+				State.bHasPosition = true;
+				continue;
+			}
+
+			// Release contacts once the target is clearly back outside, so resting on a surface does not re-fire
+			if (State.SurfaceBody != INDEX_NONE)
+			{
+				const double ReleaseRadius = Snapshot.Radius[State.SurfaceBody] * (1.0 + ContactReleaseFraction);
+				if (FVector::DistSquared(Snapshot.GetPosition(State.SurfaceBody), Position) > ReleaseRadius * ReleaseRadius)
+				{
+					State.SurfaceBody = INDEX_NONE;
+				}
+			}
+			if (State.AtmosphereBody != INDEX_NONE)
+			{
+				const double ReleaseRadius = Snapshot.AtmosphereRadius[State.AtmosphereBody] * (1.0 + ContactReleaseFraction);
+				if (FVector::DistSquared(Snapshot.GetPosition(State.AtmosphereBody), Position) > ReleaseRadius * ReleaseRadius)
+				{
+					State.AtmosphereBody = INDEX_NONE;
+				}
+			}
+
+			// Sweep the step segment against every body; a fast target cannot tunnel through a surface between steps
+			const FVector& Start = State.LastPosition;
+			double ImpactFraction = TNumericLimits<double>::Max();
+			double EntryFraction = TNumericLimits<double>::Max();
+			int32 ImpactBody = INDEX_NONE;
+			int32 EntryBody = INDEX_NONE;
+
+			for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+			{
+				if (!Snapshot.IsValidIndex(BodyIndex))
+				{
+					continue;
+				}
+
+				const FVector Center = Snapshot.GetPosition(BodyIndex);
+				const double SurfaceRadius = Snapshot.Radius[BodyIndex];
+				const double AtmosphereRadius = Snapshot.AtmosphereRadius[BodyIndex];
+				double Fraction;
+
+				if (BodyIndex != State.SurfaceBody && FindSphereEntry(Start, Position, Center, SurfaceRadius, Fraction) && Fraction < ImpactFraction)
+				{
+					ImpactFraction = Fraction;
+					ImpactBody = BodyIndex;
+				}
+
+				if (AtmosphereRadius > SurfaceRadius && BodyIndex != State.AtmosphereBody
+					&& FindSphereEntry(Start, Position, Center, AtmosphereRadius, Fraction) && Fraction < EntryFraction)
+				{
+					EntryFraction = Fraction;
+					EntryBody = BodyIndex;
+				}
+			}
+
+			const double Elapsed = StepTime - State.LastTime;
+			const FVector Velocity = Elapsed > 0.0 ? (Position - Start) / Elapsed : FVector::ZeroVector;
+
+			auto AddEvent = [&](EGravityBodyEventType Type, int32 BodyIndex, double Fraction)
+			{
+				FGravityBodyEvent& Event = Events.AddDefaulted_GetRef();
+				Event.Type = Type;
+				Event.Time = FMath::Lerp(State.LastTime, StepTime, Fraction);
+				Event.Position = FMath::Lerp(Start, Position, Fraction);
+				Event.Velocity = Velocity;
+				Event.TargetIndex = Index;
+				Event.BodyIndex = BodyIndex;
+			};
+
+			// Atmosphere entry precedes an impact on the same step
+			if (EntryBody != INDEX_NONE)
+			{
+				AddEvent(EGravityBodyEventType::AtmosphereEntry, EntryBody, EntryFraction);
+				State.AtmosphereBody = EntryBody;
+			}
+
+			if (ImpactBody != INDEX_NONE)
+			{
+				AddEvent(EGravityBodyEventType::Impact, ImpactBody, ImpactFraction);
+				State.SurfaceBody = ImpactBody;
+			}
+
+			if (SOIBody != State.SOIBody)
+			{
+				AddEvent(EGravityBodyEventType::SOIChange, SOIBody, 1.0);
+				Events.Last().PreviousBodyIndex = State.SOIBody;
+				State.SOIBody = SOIBody;
+			}
+
+			State.LastPosition = Position;
+			State.LastTime = StepTime;
+		}
+	});
+
+	// Resolve objects on the game thread, in batch order
+	for (int32 BatchIndex = 0; BatchIndex < NumBatches; ++BatchIndex)
+	{
+		for (FGravityBodyEvent& Event : TickBatchEvents[BatchIndex])
+		{
+			Event.Target = GravityTargets[Event.TargetIndex].Get();
+			Event.Body = Snapshot.Bodies.IsValidIndex(Event.BodyIndex) ? Snapshot.Bodies[Event.BodyIndex].Get() : nullptr;
+			Event.PreviousBody = Snapshot.Bodies.IsValidIndex(Event.PreviousBodyIndex) ? Snapshot.Bodies[Event.PreviousBodyIndex].Get() : nullptr;
+		}
+
+		PendingBodyEvents.Append(TickBatchEvents[BatchIndex]);
+	}
+}
+
+void UGravitySimulator::BroadcastBodyEvents()
+{
+	if (PendingBodyEvents.Num() == 0)
+	{
+		return;
+	}
+
+	// Listeners may register or remove targets, which can queue further events; broadcast a moved-out copy
+	const TArray<FGravityBodyEvent> Events = MoveTemp(PendingBodyEvents);
+	PendingBodyEvents.Reset();
+
+	if (bEnableDebugLogging)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("GravitySimulator: Broadcasting %d body events"), Events.Num());
+	}
+
+	OnGravityBodyEvents.Broadcast(Events);
+}
+
+FVector UGravitySimulator::SampleCachedForce(const FGravityReceiverState& State) const
+{
+	// Several sub-steps this frame: apply their average so a spike does not skip force
+	if (State.StepsThisFrame > 1)
+	{
+		return State.StepForceSum / static_cast<double>(State.StepsThisFrame);
+	}
+
+	return bInterpolateGravity
+		? FMath::Lerp(State.PreviousForce, State.CurrentForce, static_cast<double>(GravityStepAlpha))
+		: State.CurrentForce;
+}
+
+void UGravitySimulator::ApplyCachedGravity()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityApply);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGravitySimulator::ApplyCachedGravity);
+
+	for (int32 Index = 0; Index < GravityTargets.Num(); ++Index)
+	{
+		UPrimitiveComponent* Component = GravityTargets[Index].Get();
+		const FGravityReceiverState& State = GravityTargetStates[Index];
+
+		if (!Component || !State.bHasForce || !Component->IsSimulatingPhysics())
+		{
+			continue;
+		}
+
+		// Cached forces were limited to MaxGForce when the step evaluated them
+		const FVector UnrealForce = ConvertNewtonsToUnrealForce(SampleCachedForce(State), Component->GetMass());
+
+		Component->AddForce(UnrealForce, NAME_None, false);
+	}
+
+	if (bEnableDebugLogging)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("GravitySimulator: Applied cached gravity to %d targets (alpha %.2f)"),
+			GravityTargets.Num(), GravityStepAlpha);
+	}
+}
+
+FVector UGravitySimulator::ConvertNewtonsToUnrealForce(const FVector& ForceInNewtons, float TargetMass) const
+{
+	// Unreal Engine uses kg·cm/s² for force
+	// 1 Newton = 100 Unreal force units (kg·cm/s²)
+	return ForceInNewtons * 100.0f;
+}
+
+FVector UGravitySimulator::ClampGravitationalForce(const FVector& Force, float TargetMass, float MaxGForceLimit) const
+{
+	if (TargetMass <= 0.0f)
+	{
+		return FVector::ZeroVector;
+	}
+
+	// Unreal force units are kg·cm/s², so dividing by mass gives the acceleration to limit
+	FGravitySimulationParams Limit;
+	Limit.MaxGForce = MaxGForceLimit;
+	return Limit.ClampAcceleration(Force / TargetMass) * TargetMass;
+}
+
+// ========== Sphere of Influence ==========
+
+bool UGravitySimulator::IsWithinInfluenceRadius(UCelestialBodyComponent* Body, const FVector& Position, float InfluenceRadius) const
+{
+	if (!Body || !IsValid(Body))
+	{
+		return false;
+	}
+
+	// Calculate radius if not provided
+	if (InfluenceRadius <= 0.0f)
+	{
+		InfluenceRadius = CalculateSphereOfInfluence(Body);
+	}
+
+	const FVector BodyPosition = Body->GetOwner()->GetActorLocation();
+	const double Distance = FVector::Dist(Position, BodyPosition);
+
+	return Distance <= InfluenceRadius;
+}
+
+float UGravitySimulator::CalculateSphereOfInfluence(UCelestialBodyComponent* Body) const
+{
+	if (!Body || !IsValid(Body))
+	{
+		return 0.0f;
+	}
+
+	// Laplace sphere relative to the body's SOI parent, from the cached hierarchy
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+	const int32 BodyIndex = Snapshot->IndexOf(Body);
+
+	if (Snapshot->SOITree.IsValid() && Snapshot->SOITree->GetParent(BodyIndex) != INDEX_NONE)
+	{
+		return static_cast<float>(Snapshot->SOITree->GetSphereOfInfluence(BodyIndex));
+	}
+
+	// Root or uncaptured bodies have no parent to measure against; fall back to a multiple of the body radius
+	float BodyRadius = Body->GetPhysicalRadius();
+	double BodyMass = Body->GetMass();
+
+	// SOI scales with mass^(1/3) approximately
+	float SOIMultiplier = static_cast<float>(FMath::Pow(BodyMass / 1.0e24, 0.333));
+
+	return BodyRadius * FMath::Max(SOIMultiplier, 2.0f); // At least 2x radius
+}
+
+TArray<UCelestialBodyComponent*> UGravitySimulator::GetInfluencingBodies(const FVector& Position, int32 MaxBodies) const
+{
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+
+	TArray<int32, TInlineAllocator<8>> Indices;
+	FindInfluencingBodyIndices(*Snapshot, Position, MaxBodies, Indices);
+
+	TArray<UCelestialBodyComponent*> InfluencingBodies;
+	InfluencingBodies.Reserve(Indices.Num());
+
+	for (int32 Index : Indices)
+	{
+		if (UCelestialBodyComponent* Body = Snapshot->Bodies[Index].Get())
+		{
+			InfluencingBodies.Add(Body);
+		}
+	}
+
+	return InfluencingBodies;
+}
+
+// ========== Configuration ==========
+
+void UGravitySimulator::SetSimulationMode(EGravitySimulationMode Mode)
+{
+	if (CurrentSimulationMode != Mode)
+	{
+		CurrentSimulationMode = Mode;
+		bSimulationStateDirty = true;
+
+		UE_LOG(LogTemp, Log, TEXT("GravitySimulator: Simulation mode changed to %d"), static_cast<int32>(Mode));
+	}
+}
+
+// ========== Network Prediction ==========
+
+void UGravitySimulator::RecordServerState(int32 ActorID, double Timestamp, const FVector& Position, const FVector& Velocity)
+{
+	FGravityStateHistory& History = FindOrAddStateHistory(ActorID);
+
+	// Keep the ring ordered in time
+	if (History.Count > 0 && Timestamp <= History.GetLatest().Timestamp)
+	{
+		return;
+	}
+
+	// Deterministic replays start from grid values, as the client's replay of the same sample does
+	FGravityStateSample Sample;
+	Sample.Timestamp = Timestamp;
+	Sample.Position = bDeterministicGravity ? GravityDeterministic::Snap(Position, GravityDeterministic::PositionFractionBits) : Position;
+	Sample.Velocity = bDeterministicGravity ? GravityDeterministic::Snap(Velocity, GravityDeterministic::VelocityFractionBits) : Velocity;
+	History.Add(Sample);
+}
+
+void UGravitySimulator::ClearServerState(int32 ActorID)
+{
+	int32 HistoryIndex = INDEX_NONE;
+	if (StateHistoryIndices.RemoveAndCopyValue(ActorID, HistoryIndex))
+	{
+		StateHistories[HistoryIndex].Reset();
+	}
+}
+
+bool UGravitySimulator::ValidateClientPrediction(int32 ActorID, const FVector& ClientPosition, const FVector& ClientVelocity,
+	FVector& OutCorrectedPosition, FVector& OutCorrectedVelocity, double ClientTimestamp)
+{
+	// Server-side validation of client's predicted physics
+	OutCorrectedPosition = ClientPosition;
+	OutCorrectedVelocity = ClientVelocity;
+
+	// Nothing recorded for this actor yet: accept the client
+	const int32* HistoryIndex = StateHistoryIndices.Find(ActorID);
+	if (!HistoryIndex || StateHistories[*HistoryIndex].Count == 0)
+	{
+		return false;
+	}
+
+	const FGravityStateHistory& History = StateHistories[*HistoryIndex];
+	const bool bUseLatest = ClientTimestamp < 0.0;
+	const FGravityStateSample& Sample = bUseLatest ? History.GetLatest() : *History.FindNearest(ClientTimestamp);
+
+	// Replay from the nearest server sample to the time the client state refers to
+	FVector ServerPosition;
+	FVector ServerVelocity;
+	ReplayServerState(Sample, bUseLatest ? 0.0 : ClientTimestamp - Sample.Timestamp, ServerPosition, ServerVelocity);
+
+	const double PositionError = FVector::Dist(ClientPosition, ServerPosition);
+	if (PositionError <= PredictionCorrectionThreshold)
+	{
+		return false;
+	}
+
+	OutCorrectedPosition = ServerPosition;
+	OutCorrectedVelocity = ServerVelocity;
+
+	if (bEnableDebugLogging)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("GravitySimulator: Corrected actor %d by %.1f units"), ActorID, PositionError);
+	}
+
+	return true;
+}
+
+FGravityStateHistory& UGravitySimulator::FindOrAddStateHistory(int32 ActorID)
+{
+	if (const int32* HistoryIndex = StateHistoryIndices.Find(ActorID))
+	{
+		return StateHistories[*HistoryIndex];
+	}
+
+	// Claim a free slot, or the one whose latest sample is oldest
+	int32 SlotIndex = INDEX_NONE;
+	double OldestTimestamp = TNumericLimits<double>::Max();
+
+	for (int32 Index = 0; Index < StateHistories.Num(); ++Index)
+	{
+		const FGravityStateHistory& Candidate = StateHistories[Index];
+		if (Candidate.ActorID == INDEX_NONE)
+		{
+			SlotIndex = Index;
+			break;
+		}
+
+		const double LatestTimestamp = Candidate.Count > 0 ? Candidate.GetLatest().Timestamp : TNumericLimits<double>::Lowest();
+		if (LatestTimestamp < OldestTimestamp)
+		{
+			OldestTimestamp = LatestTimestamp;
+			SlotIndex = Index;
+		}
+	}
+
+	FGravityStateHistory& History = StateHistories[SlotIndex];
+	if (History.ActorID != INDEX_NONE)
+	{
+		StateHistoryIndices.Remove(History.ActorID);
+
+		if (bEnableDebugLogging)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("GravitySimulator: Rewind history full, evicting actor %d for actor %d"),
+				History.ActorID, ActorID);
+		}
+	}
+
+	History.Reset();
+	History.ActorID = ActorID;
+	StateHistoryIndices.Add(ActorID, SlotIndex);
+
+	return History;
+}
+
+void UGravitySimulator::ReplayServerState(const FGravityStateSample& Sample, double Duration, FVector& OutPosition, FVector& OutVelocity) const
+{
+	OutPosition = Sample.Position;
+	OutVelocity = Sample.Velocity;
+
+	if (FMath::IsNearlyZero(Duration))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GravityReplay);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGravitySimulator::ReplayServerState);
+	FScopedCalculationTimer Timer(CalculationCyclesThisFrame);
+
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
+	const FGravitySimulationParams& SimParams = Snapshot->Params;
+	const bool bApplyGravity = SimParams.bGravityEnabled && SimParams.Mode != EGravitySimulationMode::Disabled;
+	const GravityKernels::FGravityKernelParams Params = MakeKernelParams(SimParams);
+
+	// Step at the fixed gravity rate, capped so a stale timestamp cannot stall the server
+	const double StepInterval = 1.0 / FMath::Max(GravityUpdateFrequency, 1.0f);
+	const int32 NumSteps = FMath::Clamp(FMath::CeilToInt32(FMath::Abs(Duration) / StepInterval), 1, FMath::Max(MaxPredictionReplaySteps, 1));
+	const double StepTime = Duration / NumSteps;
+
+	if (SimParams.bDeterministic)
+	{
+		GravityDeterministic::FFixedVector FixedPosition = GravityDeterministic::ToFixed(OutPosition, GravityDeterministic::PositionFractionBits);
+		GravityDeterministic::FFixedVector FixedVelocity = GravityDeterministic::ToFixed(OutVelocity, GravityDeterministic::VelocityFractionBits);
+
+		for (int32 Step = 0; Step < NumSteps; ++Step)
+		{
+			FVector Acceleration = FVector::ZeroVector;
+
+			if (bApplyGravity)
+			{
+				const FVector Position = GravityDeterministic::FromFixed(FixedPosition, GravityDeterministic::PositionFractionBits);
+				Acceleration = SimParams.ToAppliedAcceleration(GravityDeterministic::ComputeAcceleration(*Snapshot, Params, Position));
+			}
+
+			GravityDeterministic::Step(FixedPosition, FixedVelocity, Acceleration, StepTime);
+		}
+
+		OutPosition = GravityDeterministic::FromFixed(FixedPosition, GravityDeterministic::PositionFractionBits);
+		OutVelocity = GravityDeterministic::FromFixed(FixedVelocity, GravityDeterministic::VelocityFractionBits);
+		CalculationsThisFrame.fetch_add(NumSteps, std::memory_order_relaxed);
+		return;
+	}
+
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		FVector Acceleration = FVector::ZeroVector;
+
+		if (bApplyGravity)
+		{
+			GravityKernels::ComputeAccelerations(SimParams.Mode, *Snapshot, Params,
+				TArrayView<const FVector>(&OutPosition, 1), TArrayView<FVector>(&Acceleration, 1));
+			Acceleration = SimParams.ToAppliedAcceleration(Acceleration);
+		}
+
+		// Semi-implicit Euler, matching the physics integrator's ordering
+		OutVelocity += Acceleration * StepTime;
+		OutPosition += OutVelocity * StepTime;
+	}
+
+	CalculationsThisFrame.fetch_add(NumSteps, std::memory_order_relaxed);
+}
+
+void UGravitySimulator::ReplayGravityState(const FVector& Position, const FVector& Velocity, double Duration, FVector& OutPosition, FVector& OutVelocity) const
+{
+	FGravityStateSample Sample;
+	Sample.Position = bDeterministicGravity ? GravityDeterministic::Snap(Position, GravityDeterministic::PositionFractionBits) : Position;
+	Sample.Velocity = bDeterministicGravity ? GravityDeterministic::Snap(Velocity, GravityDeterministic::VelocityFractionBits) : Velocity;
+
+	ReplayServerState(Sample, Duration, OutPosition, OutVelocity);
+}
+
+// ========== Debug ==========
+
+void UGravitySimulator::DrawGravityDebug(AActor* Target, float Duration) const
+{
+	if (!bEnableDebugVisualization || !Target || !DebugRenderer.IsValid())
+	{
+		return;
+	}
+
+	FVector TargetPosition = Target->GetActorLocation();
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = GetBodySnapshot();
 
 	float Mass = 1000.0f;
-	if (UPrimitiveComponent* PrimComp = Target->FindComponentByClass<UPrimitiveComponent>())
+	if (const UGravityReceiverComponent* Receiver = FindGravityReceiver(Target))
+	{
+		Mass = Receiver->GetGravityMass();
+	}
+	else if (UPrimitiveComponent* PrimComp = Target->FindComponentByClass<UPrimitiveComponent>())
 	{
 		Mass = PrimComp->GetMass();
 	}
 
-	// Draw force vectors from each body
-	for (UCelestialBodyComponent* Body : Bodies)
+	// Queue force vectors from each body; the renderer budgets, batches and labels only the nearest
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot->Num(); ++BodyIndex)
 	{
-		if (!IsValid(Body))
+		UCelestialBodyComponent* Body = Snapshot->Bodies[BodyIndex].Get();
+		if (!Snapshot->IsValidIndex(BodyIndex) || !Body)
 		{
 			continue;
 		}
 
-		FVector Force = CalculateGravityFromBody(Body, TargetPosition, Mass);
-		FVector BodyPosition = Body->GetOwner()->GetActorLocation();
+		FVector Force = CalculateGravityFromSnapshotBody(*Snapshot, BodyIndex, TargetPosition, Mass);
+		FVector BodyPosition = Snapshot->GetPosition(BodyIndex);
 
 		// Scale force for visualization
 		FVector ForceVectorEnd = TargetPosition + Force.GetSafeNormal() * FMath::Min(Force.Size() * 0.1f, 1000.0f);
 
-		// Draw line from body to target
-		DrawDebugLine(GetWorld(), BodyPosition, TargetPosition, FColor::Cyan, false, Duration, 0, 2.0f);
+		// Line from body to target
+		DebugRenderer->AddLine(BodyPosition, TargetPosition, FColor::Cyan, 2.0f, Duration);
+
+		// Force vector
+		DebugRenderer->AddArrow(TargetPosition, ForceVectorEnd, 50.0f, DebugForceColor, 3.0f, Duration);
+
+		// Body name
+		DebugRenderer->AddLabel(BodyPosition, Body->GetBodyName().ToString(), FColor::White, Duration);
+	}
+}
+
+void UGravitySimulator::FlushDebugDrawing()
+{
+	if (!DebugRenderer.IsValid() || !DebugRenderer->HasPendingDraws())
+	{
+		return;
+	}
+
+	// Rank against the local player's camera; servers without one rank against the origin
+	UWorld* World = GetWorld();
+	FVector ViewOrigin = FVector::ZeroVector;
+
+	if (APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr)
+	{
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewOrigin, ViewRotation);
+	}
 
-		// Draw force vector
-		DrawDebugDirectionalArrow(GetWorld(), TargetPosition, ForceVectorEnd, 50.0f, DebugForceColor, false, Duration, 0, 3.0f);
+	DebugRenderer->Flush(World, ViewOrigin, DebugMaxLinesPerFrame, DebugMaxLabels);
 
-		// Draw body name
-		DrawDebugString(GetWorld(), BodyPosition, Body->GetBodyName().ToString(), nullptr, FColor::White, Duration);
+	if (bEnableDebugLogging && DebugRenderer->GetNumDroppedItems() > 0)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("GravitySimulator: Debug budget drew %d lines and dropped %d shapes"),
+			DebugRenderer->GetNumSubmittedLines(), DebugRenderer->GetNumDroppedItems());
 	}
 }
 
 void UGravitySimulator::GetSimulationStatistics(int32& OutCalculationsPerFrame, float& OutAverageCalculationTime) const
 {
-	FScopeLock Lock(&SimulationLock);
+	// Relaxed atomic reads; never blocks callers on other threads
+	const int32 Frames = FrameCounter.load(std::memory_order_relaxed);
 
-	if (FrameCounter > 0)
+	if (Frames > 0)
 	{
-		OutCalculationsPerFrame = CalculationsThisFrame / FrameCounter;
-		OutAverageCalculationTime = TotalCalculationTime / static_cast<float>(FrameCounter);
+		OutCalculationsPerFrame = static_cast<int32>(TotalCalculations.load(std::memory_order_relaxed) / Frames);
+		OutAverageCalculationTime = TotalCalculationTime.load(std::memory_order_relaxed) / static_cast<float>(Frames);
 	}
 	else
 	{
@@ -461,113 +1939,411 @@ void UGravitySimulator::GetSimulationStatistics(int32& OutCalculationsPerFrame,
 	}
 }
 
+void UGravitySimulator::GetSimulationPercentiles(float& OutP50Time, float& OutP99Time, int32& OutP50Calculations, int32& OutP99Calculations) const
+{
+	OutP50Time = CalculatePercentile(FrameTimeHistory, 0.50f);
+	OutP99Time = CalculatePercentile(FrameTimeHistory, 0.99f);
+	OutP50Calculations = CalculatePercentile(FrameCalculationHistory, 0.50f);
+	OutP99Calculations = CalculatePercentile(FrameCalculationHistory, 0.99f);
+}
+
+void UGravitySimulator::DumpSimulationStatistics() const
+{
+	int32 AvgCalcs = 0;
+	float AvgTime = 0.0f;
+	GetSimulationStatistics(AvgCalcs, AvgTime);
+
+	float P50Time = 0.0f;
+	float P99Time = 0.0f;
+	int32 P50Calcs = 0;
+	int32 P99Calcs = 0;
+	GetSimulationPercentiles(P50Time, P99Time, P50Calcs, P99Calcs);
+
+	UE_LOG(LogTemp, Log, TEXT("=== GravitySimulator Statistics ==="));
+	UE_LOG(LogTemp, Log, TEXT("Mode: %d, Enabled: %s, Targets: %d (%d receivers), Update Frequency: %.1f Hz"),
+		static_cast<int32>(CurrentSimulationMode), bGravityEnabled ? TEXT("Yes") : TEXT("No"), GravityTargets.Num(), GravityReceivers.Num(), GravityUpdateFrequency);
+	UE_LOG(LogTemp, Log, TEXT("Frames: %d, Avg calculations: %d, Avg time: %.3f ms"),
+		FrameCounter.load(std::memory_order_relaxed), AvgCalcs, AvgTime);
+	UE_LOG(LogTemp, Log, TEXT("Last %d frames - time p50: %.3f ms, p99: %.3f ms; calculations p50: %d, p99: %d"),
+		FrameTimeHistory.Num(), P50Time, P99Time, P50Calcs, P99Calcs);
+	UE_LOG(LogTemp, Log, TEXT("Orbiting bodies: %d (%d on rails, %d from ephemeris), Orbit rate: %.1f Hz, Time warp: %.1fx, Energy drift: %.3e"),
+		OrbitIntegrator.IsValid() ? OrbitIntegrator->GetNumMovingBodies() : 0, OrbitIntegrator.IsValid() ? OrbitIntegrator->GetNumOnRails() : 0,
+		OrbitIntegrator.IsValid() ? OrbitIntegrator->GetNumFromEphemeris() : 0,
+		OrbitStepFrequency, OrbitTimeWarp, OrbitEnergyDrift);
+	UE_LOG(LogTemp, Log, TEXT("Trajectory predictions in flight: %d"),
+		TrajectoryService.IsValid() ? TrajectoryService->GetNumInFlight() : 0);
+}
+
+void UGravitySimulator::EndStatisticsFrame()
+{
+	const int32 Calculations = CalculationsThisFrame.exchange(0, std::memory_order_relaxed);
+	const uint64 Cycles = CalculationCyclesThisFrame.exchange(0, std::memory_order_relaxed);
+	const float TimeMs = static_cast<float>(FPlatformTime::ToMilliseconds64(Cycles));
+
+	TotalCalculations.fetch_add(Calculations, std::memory_order_relaxed);
+	TotalCalculationTime.store(TotalCalculationTime.load(std::memory_order_relaxed) + TimeMs, std::memory_order_relaxed);
+	FrameCounter.fetch_add(1, std::memory_order_relaxed);
+
+	// Fill the rings up to their capacity, then overwrite the oldest frame
+	if (FrameTimeHistory.Num() < StatisticsHistoryLength)
+	{
+		FrameTimeHistory.Add(TimeMs);
+		FrameCalculationHistory.Add(Calculations);
+	}
+	else
+	{
+		FrameTimeHistory[StatisticsHistoryHead] = TimeMs;
+		FrameCalculationHistory[StatisticsHistoryHead] = Calculations;
+	}
+	StatisticsHistoryHead = (StatisticsHistoryHead + 1) % StatisticsHistoryLength;
+
+	SET_DWORD_STAT(STAT_GravityCalculations, Calculations);
+	SET_DWORD_STAT(STAT_GravityTargets, GravityTargets.Num());
+}
+
 // ========== Internal Methods ==========
 
-FVector UGravitySimulator::CalculateSingleBodyGravity(const FVector& TargetPosition, float TargetMass) const
+FVector UGravitySimulator::CalculateSingleBodyGravity(const FGravityBodySnapshot& Snapshot, const FVector& TargetPosition, float TargetMass) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_GravitySingleBody);
+
 	// Find the dominant body
-	UCelestialBodyComponent* DominantBody = GetDominantGravitationalBody(TargetPosition);
+	const int32 DominantIndex = FindDominantBodyIndex(Snapshot, TargetPosition);
 
-	if (!DominantBody)
+	if (DominantIndex == INDEX_NONE)
 	{
 		return FVector::ZeroVector;
 	}
 
 	// Calculate force from dominant body only
-	return CalculateGravityFromBody(DominantBody, TargetPosition, TargetMass);
+	return CalculateGravityFromSnapshotBody(Snapshot, DominantIndex, TargetPosition, TargetMass);
 }
 
-FVector UGravitySimulator::CalculateMultiBodyGravity(const FVector& TargetPosition, float TargetMass) const
+FVector UGravitySimulator::CalculateMultiBodyGravity(const FGravityBodySnapshot& Snapshot, const FVector& TargetPosition, float TargetMass) const
 {
-	// Get the top 3 most influential bodies
-	TArray<UCelestialBodyComponent*> InfluencingBodies = GetInfluencingBodies(TargetPosition, 3);
+	SCOPE_CYCLE_COUNTER(STAT_GravityMultiBody);
+
+	// Dominant body and its SOI ancestors, up to 3
+	TArray<int32, TInlineAllocator<8>> InfluencingIndices;
+	FindInfluencingBodyIndices(Snapshot, TargetPosition, 3, InfluencingIndices);
 
 	FVector TotalForce = FVector::ZeroVector;
 
-	for (UCelestialBodyComponent* Body : InfluencingBodies)
+	for (int32 BodyIndex : InfluencingIndices)
 	{
-		if (IsValid(Body))
-		{
-			TotalForce += CalculateGravityFromBody(Body, TargetPosition, TargetMass);
-		}
+		TotalForce += CalculateGravityFromSnapshotBody(Snapshot, BodyIndex, TargetPosition, TargetMass);
 	}
 
 	return TotalForce;
 }
 
-FVector UGravitySimulator::CalculateNBodyGravity(const FVector& TargetPosition, float TargetMass) const
+FVector UGravitySimulator::CalculateNBodyGravity(const FGravityBodySnapshot& Snapshot, const FVector& TargetPosition, float TargetMass) const
 {
-	// Calculate force from all bodies
-	TArray<UCelestialBodyComponent*> AllBodies = GetCelestialBodies();
+	// Large scenes walk the Barnes-Hut tree; distant bodies are approximated, never dropped
+	if (Snapshot.Octree.IsValid())
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GravityBarnesHut);
+
+		if (TargetMass <= 0.0f)
+		{
+			return FVector::ZeroVector;
+		}
 
+		const double MinDistanceSquared = Snapshot.Params.MinGravityDistance * Snapshot.Params.MinGravityDistance;
+		const FVector Acceleration = Snapshot.Octree->CalculateAcceleration(TargetPosition, Snapshot.Params.BarnesHutOpeningAngle, MinDistanceSquared);
+		return Acceleration * (static_cast<double>(TargetMass) * Snapshot.Params.PhysicsScaleFactor);
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GravityNBody);
+
+	// Small scenes sum every body exactly; a distant sun still dominates, so nothing is skipped by range
 	FVector TotalForce = FVector::ZeroVector;
 
-	for (UCelestialBodyComponent* Body : AllBodies)
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
 	{
-		if (!IsValid(Body))
+		if (!Snapshot.ValidMask[BodyIndex])
 		{
 			continue;
 		}
 
-		// Skip bodies beyond max influence distance
-		FVector BodyPosition = Body->GetOwner()->GetActorLocation();
-		float Distance = FVector::Dist(TargetPosition, BodyPosition);
+		TotalForce += CalculateGravityFromSnapshotBody(Snapshot, BodyIndex, TargetPosition, TargetMass);
+	}
+
+	return TotalForce;
+}
+
+TSharedRef<const FCelestialBodyList, ESPMode::ThreadSafe> UGravitySimulator::GetCelestialBodies() const
+{
+	// Get bodies from the registry
+	if (bAutoDiscoverBodies)
+	{
+		if (UWorld* World = GetWorld())
+		{
+			if (UCelestialBodyRegistry* Registry = World->GetSubsystem<UCelestialBodyRegistry>())
+			{
+				return Registry->GetBodyList();
+			}
+		}
+	}
+
+	static const TSharedRef<const FCelestialBodyList, ESPMode::ThreadSafe> EmptyList = MakeShared<FCelestialBodyList, ESPMode::ThreadSafe>();
+	return EmptyList;
+}
 
-		if (Distance > MaxInfluenceDistance)
+TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> UGravitySimulator::GetBodySnapshot() const
+{
+	// Only the game thread publishes, so it reads its own pointer without locking;
+	// recapture once per engine frame or after a settings change
+	TSharedPtr<const FGravityBodySnapshot, ESPMode::ThreadSafe> Published;
+	if (IsInGameThread())
+	{
+		if (!PublishedSnapshot.IsValid() || PublishedSnapshot->FrameNumber != GFrameCounter || bSimulationStateDirty)
 		{
-			continue;
+			PublishBodySnapshot();
 		}
+		Published = PublishedSnapshot;
+	}
+	else
+	{
+		// Held only for the reference count bump; the copy keeps the snapshot alive after the lock is released
+		FScopeLock Lock(&SnapshotLock);
+		Published = PublishedSnapshot;
+	}
 
-		TotalForce += CalculateGravityFromBody(Body, TargetPosition, TargetMass);
+	if (Published.IsValid())
+	{
+		return Published.ToSharedRef();
 	}
 
-	return TotalForce;
+	// Queried from a worker before the game thread published anything
+	static const TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> EmptySnapshot = MakeShared<FGravityBodySnapshot, ESPMode::ThreadSafe>();
+	return EmptySnapshot;
 }
 
-TArray<UCelestialBodyComponent*> UGravitySimulator::GetCelestialBodies() const
+void UGravitySimulator::PublishBodySnapshot() const
 {
-	if (!bAutoDiscoverBodies)
+	check(IsInGameThread());
+
+	// Build outside the lock; swap under it and let the previous snapshot go after releasing it
+	TSharedPtr<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = BuildBodySnapshot();
 	{
-		return TArray<UCelestialBodyComponent*>();
+		FScopeLock Lock(&SnapshotLock);
+		Swap(PublishedSnapshot, Snapshot);
 	}
+	bSimulationStateDirty = false;
+}
 
-	// Get bodies from the registry
-	if (UWorld* World = GetWorld())
+TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> UGravitySimulator::BuildBodySnapshot() const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityBuildSnapshot);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGravitySimulator::BuildBodySnapshot);
+
+	TSharedRef<FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FGravityBodySnapshot, ESPMode::ThreadSafe>();
+	Snapshot->FrameNumber = GFrameCounter;
+
+	// Capture settings so readers never observe a half-applied configuration change
+	FGravitySimulationParams& Params = Snapshot->Params;
+	Params.Mode = CurrentSimulationMode;
+	Params.bGravityEnabled = bGravityEnabled;
+	Params.MinGravityDistance = MinGravityDistance;
+	Params.PhysicsScaleFactor = PhysicsScaleFactor;
+	Params.MaxGForce = MaxGForce;
+	Params.BarnesHutOpeningAngle = BarnesHutOpeningAngle;
+	Params.DominantBodyHysteresis = DominantBodyHysteresis;
+	Params.bDeterministic = bDeterministicGravity;
+	Params.OriginSector = OriginSector;
+	Params.SectorSize = CelestialScalingConstants::VirtualSectorSize;
+
+	// The list carries the generation it was captured at, so body indices and generation always agree
+	const TSharedRef<const FCelestialBodyList, ESPMode::ThreadSafe> BodyList = GetCelestialBodies();
+	Snapshot->RegistryGeneration = BodyList->Generation;
+	Snapshot->Reset(BodyList->Bodies.Num());
+	Snapshot->BodyList = BodyList;
+
+	for (UCelestialBodyComponent* Body : BodyList->Bodies)
+	{
+		AActor* Owner = IsValid(Body) ? Body->GetOwner() : nullptr;
+		if (!Owner)
+		{
+			Snapshot->Add(Body, FVector::ZeroVector, 0.0, 0.0, GravitationalConstant, false);
+			continue;
+		}
+
+		// Orbiting bodies are only written back past a tolerance; the integrator holds the exact position.
+		// Only while orbits are stepped, and only for bodies it moves: otherwise its copy goes stale as actors move
+		FVector Position = Owner->GetActorLocation();
+		if (bGravityEnabled && bSimulateOrbits && OrbitIntegrator.IsValid() && OrbitIntegrator->IsMoving(Body))
+		{
+			OrbitIntegrator->GetPosition(Body, Position);
+		}
+
+		// Deterministic mode snaps bodies to the fixed-point grid so float jitter in actor transforms cannot leak in
+		if (bDeterministicGravity)
+		{
+			Position = GravityDeterministic::Snap(Position, GravityDeterministic::PositionFractionBits);
+		}
+
+		const double BodyMass = Body->GetMass();
+		Snapshot->Add(Body, Position, BodyMass, Body->GetPhysicalRadius(), GravitationalConstant, BodyMass > 0.0, Body->GetPhysicalAtmosphereRadius());
+	}
+
+	// Carry the SOI hierarchy over from the last snapshot unless bodies changed or moved significantly
+	const TSharedPtr<const FGravityBodySnapshot, ESPMode::ThreadSafe>& Previous = PublishedSnapshot;
+	if (Previous.IsValid() && Previous->SOITree.IsValid() && !Previous->SOITree->NeedsRebuild(*Snapshot))
+	{
+		Snapshot->SOITree = Previous->SOITree;
+	}
+	else
+	{
+		TSharedRef<FGravitySOITree, ESPMode::ThreadSafe> SOITree = MakeShared<FGravitySOITree, ESPMode::ThreadSafe>();
+		SOITree->Build(*Snapshot);
+		Snapshot->SOITree = SOITree;
+	}
+
+	// Rebuild the Barnes-Hut tree alongside the snapshot when N-body mode has enough bodies to benefit
+	if (bUseBarnesHut && CurrentSimulationMode == EGravitySimulationMode::NBody)
 	{
-		if (UCelestialBodyRegistry* Registry = World->GetSubsystem<UCelestialBodyRegistry>())
+		int32 NumValid = 0;
+		for (uint8 bValid : Snapshot->ValidMask)
 		{
-			return Registry->GetAllCelestialBodies();
+			NumValid += bValid;
+		}
+
+		if (NumValid >= BarnesHutMinBodies)
+		{
+			TSharedRef<FGravityOctree, ESPMode::ThreadSafe> Octree = MakeShared<FGravityOctree, ESPMode::ThreadSafe>();
+			Octree->Build(*Snapshot);
+			Snapshot->Octree = Octree;
 		}
 	}
 
-	return TArray<UCelestialBodyComponent*>();
+	return Snapshot;
 }
 
-float UGravitySimulator::CalculateInfluenceStrength(UCelestialBodyComponent* Body, const FVector& Position) const
+FVector UGravitySimulator::CalculateGravityFromSnapshotBody(const FGravityBodySnapshot& Snapshot, int32 BodyIndex, const FVector& TargetPosition, float TargetMass) const
 {
-	if (!Body || !IsValid(Body))
+	if (!Snapshot.IsValidIndex(BodyIndex) || TargetMass <= 0.0f)
 	{
-		return 0.0f;
+		return FVector::ZeroVector;
 	}
 
-	FVector BodyPosition = Body->GetOwner()->GetActorLocation();
-	float Distance = FVector::Dist(Position, BodyPosition);
+	// Calculate distance vector
+	FVector DeltaPosition = Snapshot.GetPosition(BodyIndex) - TargetPosition;
+	double Distance = DeltaPosition.Size();
 
-	// Prevent division by zero
-	if (Distance < MinGravityDistance)
+	// Prevent singularities
+	if (Distance < Snapshot.Params.MinGravityDistance)
+	{
+		Distance = Snapshot.Params.MinGravityDistance;
+	}
+
+	// Calculate gravitational force: F = GM * m / r²
+	double ForceMagnitude = (Snapshot.GM[BodyIndex] * TargetMass) / (Distance * Distance);
+
+	// Direction towards the body, with physics scale factor applied
+	return DeltaPosition.GetSafeNormal() * (ForceMagnitude * Snapshot.Params.PhysicsScaleFactor);
+}
+
+double UGravitySimulator::CalculateInfluenceStrength(const FGravityBodySnapshot& Snapshot, int32 BodyIndex, const FVector& Position) const
+{
+	if (!Snapshot.IsValidIndex(BodyIndex))
 	{
-		Distance = MinGravityDistance;
+		return 0.0;
 	}
 
+	const double DX = Snapshot.PositionX[BodyIndex] - Position.X;
+	const double DY = Snapshot.PositionY[BodyIndex] - Position.Y;
+	const double DZ = Snapshot.PositionZ[BodyIndex] - Position.Z;
+
+	// Prevent division by zero
+	const double MinDistanceSquared = Snapshot.Params.MinGravityDistance * Snapshot.Params.MinGravityDistance;
+	const double DistanceSquared = FMath::Max(DX * DX + DY * DY + DZ * DZ, MinDistanceSquared);
+
 	// Influence strength = Mass / Distance²
-	float BodyMass = Body->GetMass();
-	float DistanceSquared = Distance * Distance;
+	return Snapshot.Mass[BodyIndex] / DistanceSquared;
+}
+
+int32 UGravitySimulator::FindDominantBodyIndex(const FGravityBodySnapshot& Snapshot, const FVector& Position) const
+{
+	// Descend the SOI hierarchy instead of scoring every body
+	if (Snapshot.SOITree.IsValid() && Snapshot.SOITree->GetNumBodies() > 0)
+	{
+		return Snapshot.SOITree->FindDominantBody(Snapshot, Position);
+	}
+
+	int32 DominantIndex = INDEX_NONE;
+	double MaxInfluence = 0.0;
+
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+	{
+		const double Influence = CalculateInfluenceStrength(Snapshot, BodyIndex, Position);
+
+		if (Influence > MaxInfluence)
+		{
+			MaxInfluence = Influence;
+			DominantIndex = BodyIndex;
+		}
+	}
+
+	return DominantIndex;
+}
+
+void UGravitySimulator::FindInfluencingBodyIndices(const FGravityBodySnapshot& Snapshot, const FVector& Position, int32 MaxBodies,
+	TArray<int32, TInlineAllocator<8>>& OutIndices) const
+{
+	OutIndices.Reset();
+
+	if (MaxBodies <= 0)
+	{
+		return;
+	}
+
+	// Descend the SOI hierarchy instead of scoring every body
+	if (Snapshot.SOITree.IsValid())
+	{
+		Snapshot.SOITree->GetInfluenceChain(Snapshot, Position, MaxBodies, OutIndices);
+		return;
+	}
+
+	// Keep a small sorted top-N list instead of sorting every body
+	TArray<double, TInlineAllocator<8>> Influences;
+
+	for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+	{
+		const double Influence = CalculateInfluenceStrength(Snapshot, BodyIndex, Position);
+
+		if (Influence <= 0.0)
+		{
+			continue;
+		}
 
-	return BodyMass / DistanceSquared;
+		if (OutIndices.Num() == MaxBodies && Influence <= Influences.Last())
+		{
+			continue;
+		}
+
+		int32 InsertAt = Influences.Num();
+		while (InsertAt > 0 && Influences[InsertAt - 1] < Influence)
+		{
+			--InsertAt;
+		}
+
+		Influences.Insert(Influence, InsertAt);
+		OutIndices.Insert(BodyIndex, InsertAt);
+
+		if (OutIndices.Num() > MaxBodies)
+		{
+			Influences.Pop(EAllowShrinking::No);
+			OutIndices.Pop(EAllowShrinking::No);
+		}
+	}
 }
 
-FVector UGravitySimulator::ValidateForce(const FVector& Force, float TargetMass) const
+FVector UGravitySimulator::ValidateForce(const FVector& UnscaledForce, float TargetMass, const FGravitySimulationParams& Params, float GravityScale) const
 {
+	// Scale first so the limit below bounds the force the receiver actually gets
+	const FVector Force = UnscaledForce * static_cast<double>(GravityScale);
+
 	// Check for invalid values
 	if (!Force.ContainsNaN() && Force.IsZero())
 	{
@@ -580,6 +2356,12 @@ FVector UGravitySimulator::ValidateForce(const FVector& Force, float TargetMass)
 		return FVector::ZeroVector;
 	}
 
-	// Clamp to max G-force
-	return ClampGravitationalForce(Force, MaxGForce);
+	if (TargetMass <= 0.0f)
+	{
+		return FVector::ZeroVector;
+	}
+
+	// Limit the acceleration the force produces, not the force itself, so every mass meets the same limit
+	const double NewtonsPerAcceleration = static_cast<double>(TargetMass) / 100.0;
+	return Params.ClampAcceleration(Force / NewtonsPerAcceleration) * NewtonsPerAcceleration;
 }
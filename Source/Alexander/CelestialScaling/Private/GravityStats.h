@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * Stat group for the gravity subsystem ("stat Gravity")
+ * Kernel scopes are also emitted as Unreal Insights CPU events
+ */
+DECLARE_STATS_GROUP(TEXT("Gravity"), STATGROUP_Gravity, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Single-Body"), STAT_GravitySingleBody, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Multi-Body"), STAT_GravityMultiBody, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("N-Body"), STAT_GravityNBody, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("N-Body (Barnes-Hut)"), STAT_GravityBarnesHut, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Snapshot"), STAT_GravityBuildSnapshot, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gravity Step"), STAT_GravityStep, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Cached Gravity"), STAT_GravityApply, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Prediction Replay"), STAT_GravityReplay, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Orbit Integration"), STAT_GravityOrbits, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Trajectory Prediction"), STAT_GravityTrajectory, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Trajectory Ephemeris"), STAT_GravityEphemeris, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Body Events"), STAT_GravityBodyEvents, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Debug Draw"), STAT_GravityDebugDraw, STATGROUP_Gravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Body Scale Updates"), STAT_CelestialScaleUpdate, STATGROUP_Gravity, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Calculations"), STAT_GravityCalculations, STATGROUP_Gravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Gravity Targets"), STAT_GravityTargets, STATGROUP_Gravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Debug Lines"), STAT_GravityDebugLines, STATGROUP_Gravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bodies Scaled"), STAT_CelestialBodiesScaled, STATGROUP_Gravity, );
@@ -0,0 +1,490 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GravityTrajectoryPredictor.h"
+#include "GravityBodySnapshot.h"
+#include "GravitySOITree.h"
+#include "GravityStats.h"
+#include "CelestialBodyComponent.h"
+
+namespace
+{
+	/** Index of the first valid body whose surface contains Position, or INDEX_NONE */
+	int32 FindImpactBody(const FGravityBodySnapshot& Snapshot, const FVector& Position)
+	{
+		for (int32 BodyIndex = 0; BodyIndex < Snapshot.Num(); ++BodyIndex)
+		{
+			const double Radius = Snapshot.Radius[BodyIndex];
+			if (Snapshot.IsValidIndex(BodyIndex) && FVector::DistSquared(Snapshot.GetPosition(BodyIndex), Position) < Radius * Radius)
+			{
+				return BodyIndex;
+			}
+		}
+
+		return INDEX_NONE;
+	}
+}
+
+// ========== Ephemeris ==========
+
+void FGravityTrajectoryEphemeris::Build(const FGravityBodySnapshot& Snapshot, FGravityOrbitIntegrator* Orbits, TConstArrayView<int32> OrbitIndices,
+	EGravityOrbitIntegrator Method, const FGravityOrbitParams& OrbitParams)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityEphemeris);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityTrajectoryEphemeris::Build);
+
+	// Static bodies need a single sample however long the horizon is
+	if (!Orbits || Orbits->GetNumMovingBodies() == 0)
+	{
+		NumSamples = 1;
+	}
+
+	NumBodies = Snapshot.Num();
+	PositionX.SetNumUninitialized(NumSamples * NumBodies);
+	PositionY.SetNumUninitialized(NumSamples * NumBodies);
+	PositionZ.SetNumUninitialized(NumSamples * NumBodies);
+
+	for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+	{
+		const int32 Base = SampleIndex * NumBodies;
+
+		for (int32 BodyIndex = 0; BodyIndex < NumBodies; ++BodyIndex)
+		{
+			const int32 OrbitIndex = OrbitIndices.IsValidIndex(BodyIndex) ? OrbitIndices[BodyIndex] : INDEX_NONE;
+			const FVector Position = Orbits && OrbitIndex != INDEX_NONE ? Orbits->GetPositionAt(OrbitIndex) : Snapshot.GetPosition(BodyIndex);
+
+			PositionX[Base + BodyIndex] = Position.X;
+			PositionY[Base + BodyIndex] = Position.Y;
+			PositionZ[Base + BodyIndex] = Position.Z;
+		}
+
+		if (SampleIndex + 1 < NumSamples)
+		{
+			Orbits->Step(SampleInterval, Method, OrbitParams);
+		}
+	}
+}
+
+int32 FGravityTrajectoryEphemeris::GetSampleIndex(double Time, double& OutAlpha) const
+{
+	if (NumSamples <= 1)
+	{
+		OutAlpha = 0.0;
+		return 0;
+	}
+
+	const double Sample = FMath::Clamp((Time - StartTime) / SampleInterval, 0.0, static_cast<double>(NumSamples - 1));
+	const int32 Index = FMath::Min(FMath::FloorToInt32(Sample), NumSamples - 2);
+
+	OutAlpha = Sample - Index;
+	return Index;
+}
+
+void FGravityTrajectoryEphemeris::Sample(double Time, FGravityBodySnapshot& InOutSnapshot) const
+{
+	double Alpha;
+	const int32 Base = GetSampleIndex(Time, Alpha) * NumBodies;
+	const int32 Next = NumSamples > 1 ? Base + NumBodies : Base;
+
+	for (int32 BodyIndex = 0; BodyIndex < NumBodies; ++BodyIndex)
+	{
+		InOutSnapshot.PositionX[BodyIndex] = FMath::Lerp(PositionX[Base + BodyIndex], PositionX[Next + BodyIndex], Alpha);
+		InOutSnapshot.PositionY[BodyIndex] = FMath::Lerp(PositionY[Base + BodyIndex], PositionY[Next + BodyIndex], Alpha);
+		InOutSnapshot.PositionZ[BodyIndex] = FMath::Lerp(PositionZ[Base + BodyIndex], PositionZ[Next + BodyIndex], Alpha);
+	}
+}
+
+FVector FGravityTrajectoryEphemeris::GetBodyPosition(int32 BodyIndex, double Time) const
+{
+	double Alpha;
+	const int32 Current = GetSampleIndex(Time, Alpha) * NumBodies + BodyIndex;
+	const int32 Next = NumSamples > 1 ? Current + NumBodies : Current;
+
+	return FVector(
+		FMath::Lerp(PositionX[Current], PositionX[Next], Alpha),
+		FMath::Lerp(PositionY[Current], PositionY[Next], Alpha),
+		FMath::Lerp(PositionZ[Current], PositionZ[Next], Alpha));
+}
+
+// ========== Service ==========
+
+void FGravityTrajectoryService::Request(int32 PredictionID, const FGravityTrajectoryRequest& InRequest, const FGravityTrajectoryContext& Context)
+{
+	FJob& Job = Jobs.FindOrAdd(PredictionID);
+	Job.Pending = InRequest;
+	Job.bHasPending = true;
+
+	if (!Job.InFlight.IsValid())
+	{
+		Launch(Job, Context);
+	}
+}
+
+void FGravityTrajectoryService::Update(const FGravityTrajectoryContext& Context, TArray<int32>& OutCompleted)
+{
+	for (TPair<int32, FJob>& Pair : Jobs)
+	{
+		FJob& Job = Pair.Value;
+
+		if (Job.InFlight.IsValid() && Job.Task.IsCompleted())
+		{
+			FResult& Result = *Job.InFlight;
+
+			// Bodies can only be resolved on the game thread
+			for (FGravityTrajectoryEvent& Event : Result.Prediction.Events)
+			{
+				Event.Body = Result.Snapshot->Bodies.IsValidIndex(Event.BodyIndex) ? Result.Snapshot->Bodies[Event.BodyIndex].Get() : nullptr;
+			}
+
+			Job.LastPath = MakeShared<const FGravityTrajectoryPath, ESPMode::ThreadSafe>(MoveTemp(Result.Path));
+			Job.Prediction = MoveTemp(Result.Prediction);
+			Job.bHasPrediction = true;
+			Job.InFlight.Reset();
+			Job.Task = UE::Tasks::FTask();
+
+			OutCompleted.Add(Pair.Key);
+		}
+
+		if (!Job.InFlight.IsValid() && Job.bHasPending)
+		{
+			Launch(Job, Context);
+		}
+	}
+
+	// Drop the ephemeris once its frame is over so the bodies it copied are not kept alive
+	if (EphemerisFrame != Context.FrameNumber && EphemerisTask.IsValid() && EphemerisTask.IsCompleted())
+	{
+		EphemerisTask = FEphemerisTask();
+	}
+}
+
+const FGravityTrajectoryPrediction* FGravityTrajectoryService::Find(int32 PredictionID) const
+{
+	const FJob* Job = Jobs.Find(PredictionID);
+	return Job && Job->bHasPrediction ? &Job->Prediction : nullptr;
+}
+
+void FGravityTrajectoryService::Cancel(int32 PredictionID)
+{
+	Jobs.Remove(PredictionID);
+}
+
+void FGravityTrajectoryService::Reset()
+{
+	Jobs.Empty();
+	EphemerisTask = FEphemerisTask();
+	EphemerisFrame = 0;
+}
+
+int32 FGravityTrajectoryService::GetNumInFlight() const
+{
+	int32 NumInFlight = 0;
+	for (const TPair<int32, FJob>& Pair : Jobs)
+	{
+		NumInFlight += Pair.Value.InFlight.IsValid() ? 1 : 0;
+	}
+	return NumInFlight;
+}
+
+void FGravityTrajectoryService::Launch(FJob& Job, const FGravityTrajectoryContext& Context)
+{
+	check(IsInGameThread());
+
+	const FGravityTrajectoryRequest Request = Job.Pending;
+	Job.bHasPending = false;
+
+	FEphemerisTask Ephemeris = GetEphemerisTask(Request, Context);
+	TSharedRef<FResult, ESPMode::ThreadSafe> Result = MakeShared<FResult, ESPMode::ThreadSafe>();
+	Result->Snapshot = Context.Snapshot;
+
+	// Workers never see the game-thread orbit integrator
+	FGravityTrajectoryContext TaskContext = Context;
+	TaskContext.Orbits = nullptr;
+
+	TSharedPtr<const FGravityTrajectoryPath, ESPMode::ThreadSafe> Previous = Job.LastPath;
+
+	Job.InFlight = Result;
+	Job.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Request, Previous, Ephemeris, TaskContext, Result]() mutable
+	{
+		Predict(Request, Previous.Get(), *Result->Snapshot, *Ephemeris.GetResult(), TaskContext, *Result);
+	}, UE::Tasks::Prerequisites(Ephemeris));
+}
+
+FGravityTrajectoryService::FEphemerisTask FGravityTrajectoryService::GetEphemerisTask(const FGravityTrajectoryRequest& InRequest, const FGravityTrajectoryContext& Context)
+{
+	// One extra step of slack: an extended path may start up to a step before the request
+	const double Duration = (InRequest.NumSteps + 1) * InRequest.StepSize;
+
+	if (EphemerisTask.IsValid() && EphemerisFrame == Context.FrameNumber && EphemerisInterval == InRequest.StepSize
+		&& InRequest.StartTime + Duration <= EphemerisStartTime + EphemerisDuration)
+	{
+		return EphemerisTask;
+	}
+
+	// Copy the orbit state now; the worker steps its own copy forward
+	TSharedPtr<FGravityOrbitIntegrator> Orbits;
+	TArray<int32> OrbitIndices;
+
+	if (Context.Orbits && Context.Orbits->GetNumMovingBodies() > 0)
+	{
+		Orbits = MakeShared<FGravityOrbitIntegrator>(*Context.Orbits);
+		OrbitIndices.SetNumUninitialized(Context.Snapshot->Num());
+
+		for (int32 BodyIndex = 0; BodyIndex < Context.Snapshot->Num(); ++BodyIndex)
+		{
+			OrbitIndices[BodyIndex] = Orbits->FindBodyIndex(Context.Snapshot->Bodies[BodyIndex].Get());
+		}
+	}
+
+	const int32 NumSamples = FMath::CeilToInt32(Duration / InRequest.StepSize) + 1;
+
+	EphemerisFrame = Context.FrameNumber;
+	EphemerisStartTime = Context.CurrentTime;
+	EphemerisInterval = InRequest.StepSize;
+	EphemerisDuration = (NumSamples - 1) * InRequest.StepSize;
+
+	EphemerisTask = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[Snapshot = Context.Snapshot, Orbits, OrbitIndices = MoveTemp(OrbitIndices), Method = Context.OrbitMethod, OrbitParams = Context.OrbitParams,
+		StartTime = Context.CurrentTime, Interval = InRequest.StepSize, NumSamples]()
+	{
+		TSharedRef<FGravityTrajectoryEphemeris, ESPMode::ThreadSafe> Ephemeris = MakeShared<FGravityTrajectoryEphemeris, ESPMode::ThreadSafe>();
+		Ephemeris->StartTime = StartTime;
+		Ephemeris->SampleInterval = Interval;
+		Ephemeris->NumSamples = NumSamples;
+		Ephemeris->Build(*Snapshot, Orbits.Get(), OrbitIndices, Method, OrbitParams);
+
+		return TSharedPtr<const FGravityTrajectoryEphemeris, ESPMode::ThreadSafe>(Ephemeris);
+	});
+
+	return EphemerisTask;
+}
+
+void FGravityTrajectoryService::Predict(const FGravityTrajectoryRequest& InRequest, const FGravityTrajectoryPath* Previous, const FGravityBodySnapshot& Snapshot,
+	const FGravityTrajectoryEphemeris& Ephemeris, const FGravityTrajectoryContext& Context, FResult& OutResult)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityTrajectory);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FGravityTrajectoryService::Predict);
+
+	const double StepSize = InRequest.StepSize;
+	const int32 NumPoints = InRequest.NumSteps + 1;
+
+	FGravityTrajectoryPath& Path = OutResult.Path;
+	Path.StepSize = StepSize;
+	Path.RegistryGeneration = Snapshot.RegistryGeneration;
+	Path.Mode = Snapshot.Params.Mode;
+
+	// Extend the previous path when the ship is still on it
+	int32 NumReused = 0;
+	if (Previous && Previous->StepSize == StepSize && Previous->RegistryGeneration == Snapshot.RegistryGeneration
+		&& Previous->Mode == Snapshot.Params.Mode && Previous->Positions.Num() >= 2)
+	{
+		const double Offset = (InRequest.StartTime - Previous->StartTime) / StepSize;
+		const int32 Base = FMath::FloorToInt32(Offset);
+
+		if (Base >= 0 && Base + 1 < Previous->Positions.Num())
+		{
+			const double Alpha = Offset - Base;
+			const FVector ExpectedPosition = FMath::Lerp(Previous->Positions[Base], Previous->Positions[Base + 1], Alpha);
+			const FVector ExpectedVelocity = FMath::Lerp(Previous->Velocities[Base], Previous->Velocities[Base + 1], Alpha);
+
+			if (FVector::DistSquared(ExpectedPosition, InRequest.Position) <= FMath::Square(Context.ReusePositionTolerance)
+				&& FVector::DistSquared(ExpectedVelocity, InRequest.Velocity) <= FMath::Square(Context.ReuseVelocityTolerance))
+			{
+				NumReused = FMath::Min(Previous->Positions.Num() - Base, NumPoints);
+				Path.StartTime = Previous->StartTime + Base * StepSize;
+				Path.Positions.Append(Previous->Positions.GetData() + Base, NumReused);
+				Path.Velocities.Append(Previous->Velocities.GetData() + Base, NumReused);
+				Path.bEndedInImpact = Previous->bEndedInImpact && NumReused == Previous->Positions.Num() - Base;
+			}
+		}
+	}
+
+	if (NumReused == 0)
+	{
+		Path.StartTime = InRequest.StartTime;
+		Path.Positions.Add(InRequest.Position);
+		Path.Velocities.Add(InRequest.Velocity);
+	}
+
+	Path.Positions.Reserve(NumPoints);
+	Path.Velocities.Reserve(NumPoints);
+
+	// Private copy whose positions follow the ephemeris; the octree would describe the wrong positions
+	FGravityBodySnapshot Bodies = Snapshot;
+	Bodies.Octree.Reset();
+
+	const EGravitySimulationMode Mode = Snapshot.Params.Mode;
+	const bool bApplyGravity = Snapshot.Params.bGravityEnabled && Mode != EGravitySimulationMode::Disabled;
+	FGravityDominantBodyCache DominantBody;
+	int32 NumEvaluations = 0;
+
+	auto ComputeAcceleration = [&](double Time, const FVector& Position)
+	{
+		FVector Acceleration = FVector::ZeroVector;
+		if (bApplyGravity)
+		{
+			Ephemeris.Sample(Time, Bodies);
+			GravityKernels::ComputeAccelerations(Mode, Bodies, Context.KernelParams,
+				TArrayView<const FVector>(&Position, 1), TArrayView<FVector>(&Acceleration, 1),
+				TArrayView<FGravityDominantBodyCache>(&DominantBody, 1));
+			Acceleration = Context.Snapshot->Params.ToAppliedAcceleration(Acceleration);
+			++NumEvaluations;
+		}
+		return Acceleration;
+	};
+
+	// No point integrating through a planet
+	auto HitsBody = [&](double Time, const FVector& Position)
+	{
+		Ephemeris.Sample(Time, Bodies);
+		return FindImpactBody(Bodies, Position) != INDEX_NONE;
+	};
+
+	FVector Position = Path.Positions.Last();
+	FVector Velocity = Path.Velocities.Last();
+
+	if (Context.bAdaptive)
+	{
+		// Error-controlled steps; points are read off the step interpolant, so cruise needs few evaluations
+		FGravityDormandPrince Stepper;
+		auto Acceleration = [&](double Time, TConstArrayView<FVector> Positions, TConstArrayView<FVector> Velocities, TArrayView<FVector> OutAccelerations)
+		{
+			OutAccelerations[0] = ComputeAcceleration(Time, Positions[0]);
+		};
+
+		const double EndTime = Path.StartTime + (NumPoints - 1) * StepSize;
+		double AdaptiveStep = StepSize;
+
+		Stepper.Begin(Path.StartTime + (Path.Positions.Num() - 1) * StepSize, TConstArrayView<FVector>(&Position, 1), TConstArrayView<FVector>(&Velocity, 1), Acceleration);
+
+		while (!Path.bEndedInImpact && Path.Positions.Num() < NumPoints)
+		{
+			if (!Stepper.TryStep(AdaptiveStep, EndTime, Context.Adaptive, Acceleration))
+			{
+				continue;
+			}
+
+			while (!Path.bEndedInImpact && Path.Positions.Num() < NumPoints)
+			{
+				const double PointTime = Path.StartTime + Path.Positions.Num() * StepSize;
+				if (PointTime > Stepper.GetTime() + StepSize * 1.0e-6)
+				{
+					break;
+				}
+
+				Stepper.Interpolate(0, PointTime, Position, Velocity);
+				Path.Positions.Add(Position);
+				Path.Velocities.Add(Velocity);
+				Path.bEndedInImpact = HitsBody(PointTime, Position);
+			}
+		}
+	}
+	else
+	{
+		while (!Path.bEndedInImpact && Path.Positions.Num() < NumPoints)
+		{
+			const double Time = Path.StartTime + (Path.Positions.Num() - 1) * StepSize;
+			const FVector Acceleration = ComputeAcceleration(Time, Position);
+
+			// Semi-implicit Euler, matching the physics integrator and server replay
+			Velocity += Acceleration * StepSize;
+			Position += Velocity * StepSize;
+
+			Path.Positions.Add(Position);
+			Path.Velocities.Add(Velocity);
+			Path.bEndedInImpact = HitsBody(Time + StepSize, Position);
+		}
+	}
+
+	FGravityTrajectoryPrediction& Prediction = OutResult.Prediction;
+	FindEvents(Snapshot, Ephemeris, Path, Prediction);
+
+	Prediction.Points = Path.Positions;
+	Prediction.StartTime = Path.StartTime;
+	Prediction.StepSize = static_cast<float>(StepSize);
+	Prediction.NumReusedPoints = NumReused;
+	Prediction.NumForceEvaluations = NumEvaluations;
+}
+
+void FGravityTrajectoryService::FindEvents(const FGravityBodySnapshot& Snapshot, const FGravityTrajectoryEphemeris& Ephemeris, FGravityTrajectoryPath& Path,
+	FGravityTrajectoryPrediction& OutPrediction)
+{
+	const int32 NumBodies = Snapshot.Num();
+
+	TArray<double, TInlineAllocator<32>> ClosestDistanceSquared;
+	TArray<int32, TInlineAllocator<32>> ClosestPoint;
+	ClosestDistanceSquared.Init(TNumericLimits<double>::Max(), NumBodies);
+	ClosestPoint.Init(INDEX_NONE, NumBodies);
+
+	OutPrediction.Events.Reset();
+	OutPrediction.bImpact = false;
+	Path.bEndedInImpact = false;
+
+	for (int32 PointIndex = 0; PointIndex < Path.Positions.Num() && !Path.bEndedInImpact; ++PointIndex)
+	{
+		const double Time = Path.StartTime + PointIndex * Path.StepSize;
+		const FVector& Point = Path.Positions[PointIndex];
+
+		for (int32 BodyIndex = 0; BodyIndex < NumBodies; ++BodyIndex)
+		{
+			if (!Snapshot.IsValidIndex(BodyIndex))
+			{
+				continue;
+			}
+
+			const FVector BodyPosition = Ephemeris.GetBodyPosition(BodyIndex, Time);
+			const double DistanceSquared = FVector::DistSquared(BodyPosition, Point);
+
+			if (DistanceSquared < ClosestDistanceSquared[BodyIndex])
+			{
+				ClosestDistanceSquared[BodyIndex] = DistanceSquared;
+				ClosestPoint[BodyIndex] = PointIndex;
+			}
+
+			const double Radius = Snapshot.Radius[BodyIndex];
+			if (DistanceSquared < Radius * Radius)
+			{
+				FGravityTrajectoryEvent& Impact = OutPrediction.Events.AddDefaulted_GetRef();
+				Impact.Type = EGravityTrajectoryEventType::Impact;
+				Impact.Time = Time;
+				Impact.Position = Point;
+				Impact.Distance = FMath::Sqrt(DistanceSquared);
+				Impact.BodyIndex = BodyIndex;
+
+				// Nothing after the impact is real
+				Path.Positions.SetNum(PointIndex + 1);
+				Path.Velocities.SetNum(PointIndex + 1);
+				Path.bEndedInImpact = true;
+				OutPrediction.bImpact = true;
+				break;
+			}
+		}
+	}
+
+	// Report closest approaches to bodies whose sphere of influence the path enters
+	for (int32 BodyIndex = 0; BodyIndex < NumBodies; ++BodyIndex)
+	{
+		const int32 PointIndex = ClosestPoint[BodyIndex];
+		if (PointIndex == INDEX_NONE || PointIndex >= Path.Positions.Num())
+		{
+			continue;
+		}
+
+		const double SOIRadius = Snapshot.SOITree.IsValid() ? Snapshot.SOITree->GetSphereOfInfluence(BodyIndex) : TNumericLimits<double>::Max();
+		if (ClosestDistanceSquared[BodyIndex] >= SOIRadius * SOIRadius)
+		{
+			continue;
+		}
+
+		FGravityTrajectoryEvent& Approach = OutPrediction.Events.AddDefaulted_GetRef();
+		Approach.Type = EGravityTrajectoryEventType::ClosestApproach;
+		Approach.Time = Path.StartTime + PointIndex * Path.StepSize;
+		Approach.Position = Path.Positions[PointIndex];
+		Approach.Distance = FMath::Sqrt(ClosestDistanceSquared[BodyIndex]);
+		Approach.BodyIndex = BodyIndex;
+	}
+
+	OutPrediction.Events.Sort([](const FGravityTrajectoryEvent& A, const FGravityTrajectoryEvent& B)
+	{
+		return A.Time < B.Time;
+	});
+}
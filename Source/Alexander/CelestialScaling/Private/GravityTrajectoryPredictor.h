@@ -0,0 +1,196 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "GravityKernels.h"
+#include "GravityOrbitIntegrator.h"
+#include "GravitySimulator.h"
+
+struct FGravityBodySnapshot;
+
+/**
+ * Body positions sampled at a fixed interval over a prediction horizon
+ * Built once on a worker and shared read-only by every prediction launched against it
+ */
+struct FGravityTrajectoryEphemeris
+{
+	/** World time of the first sample (seconds) */
+	double StartTime = 0.0;
+
+	/** Seconds between samples */
+	double SampleInterval = 0.0;
+
+	/** Number of samples; 1 when no body moves */
+	int32 NumSamples = 0;
+
+	/** Number of bodies per sample, index-aligned with the snapshot the ephemeris was built from */
+	int32 NumBodies = 0;
+
+	/** Positions laid out [Sample * NumBodies + Body] */
+	TArray<double> PositionX;
+	TArray<double> PositionY;
+	TArray<double> PositionZ;
+
+	/**
+	 * Step a private copy of the orbit integrator and record every snapshot body at each sample
+	 * @param OrbitIndices - Integrator index per snapshot body, INDEX_NONE for bodies it does not track
+	 */
+	void Build(const FGravityBodySnapshot& Snapshot, FGravityOrbitIntegrator* Orbits, TConstArrayView<int32> OrbitIndices,
+		EGravityOrbitIntegrator Method, const FGravityOrbitParams& OrbitParams);
+
+	/** Write interpolated body positions at Time into a snapshot copy */
+	void Sample(double Time, FGravityBodySnapshot& InOutSnapshot) const;
+
+	/** Interpolated position of one body at Time (clamped to the sampled horizon) */
+	FVector GetBodyPosition(int32 BodyIndex, double Time) const;
+
+private:
+	/** First sample index and blend weight for Time */
+	int32 GetSampleIndex(double Time, double& OutAlpha) const;
+};
+
+/**
+ * Ship state to predict from
+ */
+struct FGravityTrajectoryRequest
+{
+	FVector Position = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+
+	/** World time of the state (seconds) */
+	double StartTime = 0.0;
+
+	double StepSize = 0.1;
+	int32 NumSteps = 0;
+};
+
+/**
+ * Full-resolution state of a completed prediction, kept to extend the next one incrementally
+ */
+struct FGravityTrajectoryPath
+{
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+
+	/** World time of Positions[0] */
+	double StartTime = 0.0;
+	double StepSize = 0.0;
+
+	/** Registry generation and mode the path was computed with; any change invalidates it */
+	uint32 RegistryGeneration = 0;
+	EGravitySimulationMode Mode{};
+
+	/** Whether the path was cut short by an impact */
+	bool bEndedInImpact = false;
+};
+
+/**
+ * Everything a trajectory launch needs from the simulator, captured on the game thread
+ */
+struct FGravityTrajectoryContext
+{
+	TSharedPtr<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot;
+	GravityKernels::FGravityKernelParams KernelParams;
+
+	/** Orbit integrator to copy when a new ephemeris is needed; null when bodies are static */
+	const FGravityOrbitIntegrator* Orbits = nullptr;
+	EGravityOrbitIntegrator OrbitMethod{};
+	FGravityOrbitParams OrbitParams;
+
+	/** Current world time and engine frame */
+	double CurrentTime = 0.0;
+	uint64 FrameNumber = 0;
+
+	/** Maximum start-state error for extending the previous prediction */
+	double ReusePositionTolerance = 100.0;
+	double ReuseVelocityTolerance = 10.0;
+
+	/** Integrate with error-controlled Dormand-Prince steps and interpolate the points, instead of one Euler step per point */
+	bool bAdaptive = false;
+	FGravityAdaptiveStepParams Adaptive;
+};
+
+/**
+ * Runs trajectory predictions on the task graph
+ * One prediction is in flight per prediction ID; newer requests wait as a pending request (latest wins)
+ * and are launched when the previous one completes, so the game thread only ever polls.
+ * Predictions launched in the same frame with the same step size share one ephemeris build task.
+ */
+class FGravityTrajectoryService
+{
+public:
+	/** Queue a prediction; launches immediately if none is in flight for the ID */
+	void Request(int32 PredictionID, const FGravityTrajectoryRequest& InRequest, const FGravityTrajectoryContext& Context);
+
+	/**
+	 * Collect finished predictions and launch pending ones (game thread, never blocks)
+	 * @param OutCompleted - IDs whose prediction was updated this call
+	 */
+	void Update(const FGravityTrajectoryContext& Context, TArray<int32>& OutCompleted);
+
+	/** Latest completed prediction for an ID, or nullptr */
+	const FGravityTrajectoryPrediction* Find(int32 PredictionID) const;
+
+	/** Forget an ID; an in-flight task finishes into memory nobody reads */
+	void Cancel(int32 PredictionID);
+
+	/** Forget every ID and the cached ephemeris */
+	void Reset();
+
+	/** Number of IDs with a prediction in flight */
+	int32 GetNumInFlight() const;
+
+private:
+	/** Output of one task, owned by the task until it completes */
+	struct FResult
+	{
+		FGravityTrajectoryPath Path;
+		FGravityTrajectoryPrediction Prediction;
+		TSharedPtr<const FGravityBodySnapshot, ESPMode::ThreadSafe> Snapshot;
+	};
+
+	struct FJob
+	{
+		/** Request waiting for the in-flight task */
+		FGravityTrajectoryRequest Pending;
+		bool bHasPending = false;
+
+		UE::Tasks::FTask Task;
+		TSharedPtr<FResult, ESPMode::ThreadSafe> InFlight;
+
+		/** Latest completed path, shared with the next task for incremental reuse */
+		TSharedPtr<const FGravityTrajectoryPath, ESPMode::ThreadSafe> LastPath;
+		FGravityTrajectoryPrediction Prediction;
+		bool bHasPrediction = false;
+	};
+
+	using FEphemerisTask = UE::Tasks::TTask<TSharedPtr<const FGravityTrajectoryEphemeris, ESPMode::ThreadSafe>>;
+
+	/** Launch the pending request of a job */
+	void Launch(FJob& Job, const FGravityTrajectoryContext& Context);
+
+	/** Ephemeris task covering a request, reusing this frame's build when it is long enough */
+	FEphemerisTask GetEphemerisTask(const FGravityTrajectoryRequest& InRequest, const FGravityTrajectoryContext& Context);
+
+	/**
+	 * Integrate a request against an ephemeris (worker thread)
+	 * Extends Previous from the request time when the request lies on it within tolerance
+	 */
+	static void Predict(const FGravityTrajectoryRequest& InRequest, const FGravityTrajectoryPath* Previous, const FGravityBodySnapshot& Snapshot,
+		const FGravityTrajectoryEphemeris& Ephemeris, const FGravityTrajectoryContext& Context, FResult& OutResult);
+
+	/** Closest approach per body and the first impact; truncates the path at the impact (worker thread) */
+	static void FindEvents(const FGravityBodySnapshot& Snapshot, const FGravityTrajectoryEphemeris& Ephemeris, FGravityTrajectoryPath& Path,
+		FGravityTrajectoryPrediction& OutPrediction);
+
+	TMap<int32, FJob> Jobs;
+
+	/** Ephemeris build launched this frame */
+	FEphemerisTask EphemerisTask;
+	uint64 EphemerisFrame = 0;
+	double EphemerisStartTime = 0.0;
+	double EphemerisInterval = 0.0;
+	double EphemerisDuration = 0.0;
+};
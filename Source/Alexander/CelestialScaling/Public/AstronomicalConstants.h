@@ -6,6 +6,7 @@
 #include "Engine/NetSerialization.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "PlayerOriginManager.h" // For FVirtualPosition definition
+#include "CelestialScalingTypes.h"
 #include "AstronomicalConstants.generated.h" // MUST be last include
 
 // Forward declarations
@@ -104,6 +105,14 @@ namespace CelestialScalingConstants
 	static constexpr float MaxScaleFactor = 10000.0f;
 	static constexpr float DefaultScaleFactor = 1.0f;
 	static constexpr double MaxOriginOffset = 1000000.0;
+
+	/**
+	 * Edge length of one FVirtualPosition sector (Unreal units)
+	 * FVirtualPosition is defined by PlayerOriginManager.h, which is not part of this source tree; the origin
+	 * manager recenters once the player is MaxOriginOffset from the origin, so sectors are taken to be that wide.
+	 * Gravity resolves virtual positions against this value only, so change it here if the origin manager's differs
+	 */
+	static constexpr double VirtualSectorSize = MaxOriginOffset;
 	static constexpr double RecenterThreshold = 500000.0;
 	static constexpr float MinPositionUpdateThreshold = 0.1f;
 	static constexpr float SphereOfInfluenceMultiplier = 1.2f;
@@ -181,6 +190,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Celestial Scaling|Calculations")
 	static float CalculateEscapeVelocity(double Mass, double Radius);
 
+	/** Circular on-rails orbit at the body's OrbitalRadius (km, converted to Unreal units) */
+	UFUNCTION(BlueprintCallable, Category = "Celestial Scaling|Calculations")
+	static FKeplerOrbitElements MakeCircularOrbitElements(const FCelestialBodyData& BodyData, double InitialMeanAnomaly = 0.0);
+
 	UFUNCTION(BlueprintCallable, Category = "Celestial Scaling|Validation")
 	static bool IsValidScaleFactor(float ScaleFactor);
 
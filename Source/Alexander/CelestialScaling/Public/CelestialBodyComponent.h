@@ -6,6 +6,7 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "CelestialScalingTypes.h"
 #include "CelestialBodyComponent.generated.h"
 
 // Forward declarations
@@ -25,12 +26,17 @@ public:
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	/** Mass in kg (double: planetary masses overflow float precision once multiplied by G) */
 	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite, Category = "Celestial Body")
-	float Mass;
+	double Mass;
 
 	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite, Category = "Celestial Body")
 	float Radius;
 
+	/** Thickness of the atmosphere above the surface in km (0 for airless bodies) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Celestial Body", meta = (ClampMin = "0.0"))
+	float AtmosphereHeight;
+
 	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Celestial Body")
 	float CurrentScaleFactor;
 
@@ -64,6 +70,26 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gravity")
 	float GravityMultiplier;
 
+	/** Move this body under the other bodies' gravity with the gravity simulator's orbit integrator */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit")
+	bool bSimulateOrbit;
+
+	/** Velocity the orbit integrator starts from (Unreal units per second) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit", meta = (EditCondition = "bSimulateOrbit"))
+	FVector InitialVelocity;
+
+	/** Follow OrbitElements around the parent in closed form until perturbed (InitialVelocity is ignored) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit", meta = (EditCondition = "bSimulateOrbit"))
+	bool bOnRails;
+
+	/** BodyID of the body this one orbits when on rails */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit", meta = (EditCondition = "bSimulateOrbit && bOnRails"))
+	FName OrbitParentID;
+
+	/** Orbit around OrbitParentID at the start of the simulation */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit", meta = (EditCondition = "bSimulateOrbit && bOnRails"))
+	FKeplerOrbitElements OrbitElements;
+
 	UPROPERTY(BlueprintReadOnly, Category = "LOD")
 	int32 CurrentLODLevel;
 
@@ -92,11 +118,23 @@ public:
 	FName GetBodyName() const { return BodyID; }
 
 	UFUNCTION(BlueprintCallable, Category = "Celestial")
-	float GetMass() const { return Mass; }
+	double GetMass() const { return Mass; }
 
 	UFUNCTION(BlueprintCallable, Category = "Celestial")
 	float GetRadius() const { return Radius; }
 
+	/** Surface radius in Unreal units (Radius is km, at 100 units per km); independent of the visual scale, for gameplay tests */
+	UFUNCTION(BlueprintCallable, Category = "Celestial")
+	float GetPhysicalRadius() const { return Radius * 100.0f; }
+
+	/** Outer atmosphere radius in Unreal units; equals GetPhysicalRadius for airless bodies */
+	UFUNCTION(BlueprintCallable, Category = "Celestial")
+	float GetPhysicalAtmosphereRadius() const { return (Radius + AtmosphereHeight) * 100.0f; }
+
+	/** Radius as currently drawn, scaled by CurrentScaleFactor; changes with camera distance, so use it for visuals only */
+	UFUNCTION(BlueprintCallable, Category = "Celestial")
+	float GetWorldRadius() const { return GetPhysicalRadius() * CurrentScaleFactor; }
+
 	void ApplyPositionOffset(const FVector& Offset);
 	void UpdateScaleForDistance(float Distance);
 
@@ -5,18 +5,50 @@
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "HAL/CriticalSection.h"
+#include "CelestialScalingTypes.h"
+#include <atomic>
 #include "CelestialBodyRegistry.generated.h"
 
 // Forward declarations
 class UCelestialBodyComponent;
+class FCelestialBodyOctree;
+
+/** Registry slot holding one body; freed slots are reused with a new generation */
+struct FCelestialBodySlot
+{
+	UCelestialBodyComponent* Body = nullptr;
+
+	/** Bumped whenever the slot is freed so handles to its previous body stop resolving */
+	uint32 Generation = 0;
+
+	/** Index of the body in RegisteredBodies, INDEX_NONE while the slot is free */
+	int32 DenseIndex = INDEX_NONE;
+};
+
+/** Scale update scheduling state for one registered body */
+struct FCelestialScaleUpdateEntry
+{
+	UCelestialBodyComponent* Body = nullptr;
+	FCelestialBodyHandle Handle;
+
+	/** World time of the body's last scale update */
+	double LastUpdateTime = 0.0;
+
+	ECelestialUpdatePriority Priority = ECelestialUpdatePriority::Critical;
+
+	/** Slot in its priority's bin */
+	int32 Slot = INDEX_NONE;
+};
 
 /**
  * World subsystem for managing celestial body registration and tracking
  * Provides centralized registry for all celestial bodies in the game world
+ * Bodies live in reusable slots addressed by generational handles; registration and removal are
+ * O(1) and RegisteredBodies stays densely packed for iteration
  * Thread-safe for access from multiple components
  */
 UCLASS()
-class ALEXANDER_API UCelestialBodyRegistry : public UWorldSubsystem
+class ALEXANDER_API UCelestialBodyRegistry : public UTickableWorldSubsystem
 {
 	GENERATED_BODY()
 
@@ -26,6 +58,8 @@ public:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
 
 	// ========== Body Registration (Thread-Safe) ==========
 
@@ -39,21 +73,46 @@ public:
 
 	/**
 	 * Unregister a celestial body from the registry
-	 * Thread-safe for cleanup during destruction
+	 * Thread-safe for cleanup during destruction. The last body is moved into the freed position,
+	 * so unregistering changes the order of the remaining bodies
 	 * @param Body - The celestial body component to unregister
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Registry")
 	void UnregisterCelestialBody(UCelestialBodyComponent* Body);
 
+	// ========== Body Handles ==========
+
+	/**
+	 * Get the handle of a registered body
+	 * @return The body's handle, or an unset handle if the body is not registered
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Registry")
+	FCelestialBodyHandle GetBodyHandle(UCelestialBodyComponent* Body) const;
+
+	/**
+	 * Resolve a handle to its body
+	 * @return The body, or nullptr if the handle is unset or its body has been unregistered
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Registry")
+	UCelestialBodyComponent* ResolveBodyHandle(const FCelestialBodyHandle& Handle) const;
+
 	// ========== Body Lookup ==========
 
 	/**
 	 * Get all registered celestial bodies
+	 * Copies the published list; C++ callers should use GetBodyList instead
 	 * @return Array of all celestial bodies in the world
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Registry")
 	TArray<UCelestialBodyComponent*> GetAllCelestialBodies() const;
 
+	/**
+	 * Get the published list of registered bodies without copying it
+	 * On the game thread a list made stale by registration changes is republished first;
+	 * other threads copy the reference to the latest list under a brief lock
+	 */
+	TSharedRef<const FCelestialBodyList, ESPMode::ThreadSafe> GetBodyList() const;
+
 	/**
 	 * Find a celestial body by name
 	 * @param BodyName - Name of the body to find
@@ -64,6 +123,7 @@ public:
 
 	/**
 	 * Get bodies within a specific distance from a reference point
+	 * Answered from the spatial index; cost grows with the bodies near the sphere, not the registry size
 	 * @param ReferencePoint - Center point for distance calculation
 	 * @param MaxDistance - Maximum distance in Unreal units
 	 * @return Array of bodies within range
@@ -73,6 +133,7 @@ public:
 
 	/**
 	 * Get the N nearest bodies to a reference point
+	 * Best-first search of the spatial index that stops once no closer body can remain
 	 * @param ReferencePoint - Point to measure distance from
 	 * @param Count - Number of nearest bodies to return
 	 * @return Array of nearest bodies, sorted by distance
@@ -98,6 +159,31 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Registry")
 	void UpdateAllBodyScales(const FVector& PlayerPosition);
 
+	/**
+	 * Update a budgeted slice of body scales
+	 * Bodies are binned by update priority from their apparent size. Bins are visited nearest priority first and
+	 * walked round-robin, updating each body once its priority's interval has passed, until MaxBodiesPerFrame
+	 * bodies or ScaleUpdateBudgetMs is spent. Called every tick while automatic updates are enabled
+	 * @param PlayerPosition - Current player position for distance calculations
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Registry")
+	void UpdateBodyScales(const FVector& PlayerPosition);
+
+	/**
+	 * Get the time between scale updates for a priority
+	 * Critical bodies update every frame, High every AutoUpdateFrequency, and each lower priority
+	 * ScaleUpdateIntervalGrowth times less often than the one above
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Registry")
+	float GetScaleUpdateInterval(ECelestialUpdatePriority Priority) const;
+
+	/**
+	 * Get the update priority for a body from its apparent size
+	 * @param RadiusKm - Body radius in km
+	 * @param DistanceKm - Distance from the player in km
+	 */
+	ECelestialUpdatePriority GetScaleUpdatePriority(double RadiusKm, double DistanceKm) const;
+
 	// ========== Optimization ==========
 
 	/**
@@ -130,6 +216,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Registry")
 	int32 GetRegisteredBodyCount() const { return RegisteredBodies.Num(); }
 
+	/**
+	 * Get the registry generation
+	 * Incremented whenever bodies are added, removed or reordered, so caches of body indices can detect staleness
+	 */
+	uint32 GetRegistryGeneration() const { return RegistryGeneration.load(std::memory_order_acquire); }
+
+	/**
+	 * Make the next range or nearest query re-read body positions
+	 * The index refits itself at most once per frame; call this after moving bodies mid-frame
+	 */
+	void InvalidateSpatialIndex() { SpatialIndexFrame.store(0, std::memory_order_relaxed); }
+
 	/**
 	 * Clear all registered bodies
 	 * WARNING: Only use during world cleanup
@@ -153,6 +251,16 @@ protected:
 	UPROPERTY()
 	TArray<UCelestialBodyComponent*> RegisteredBodies;
 
+	/** Registry slot of each body in RegisteredBodies, index-aligned with it */
+	TArray<int32> RegisteredBodySlots;
+
+	/** Slots addressed by handles, reused through FreeBodySlots */
+	TArray<FCelestialBodySlot> BodySlots;
+	TArray<int32> FreeBodySlots;
+
+	/** Body to slot lookup for O(1) registration checks and removal */
+	TMap<const UCelestialBodyComponent*, int32> BodySlotLookup;
+
 	/** Name-based lookup map for fast queries */
 	UPROPERTY()
 	TMap<FName, UCelestialBodyComponent*> BodyLookup;
@@ -160,32 +268,95 @@ protected:
 	/** Thread-safety lock for registration operations */
 	mutable FCriticalSection RegistryLock;
 
+	/** Bumped on every change to the set or order of RegisteredBodies */
+	std::atomic<uint32> RegistryGeneration;
+
+	/** Loose octree over body positions for range and nearest queries (guarded by RegistryLock) */
+	TSharedPtr<FCelestialBodyOctree> SpatialIndex;
+
+	/** Frame the spatial index last re-read body positions on, 0 to force a refit */
+	mutable std::atomic<uint64> SpatialIndexFrame;
+
+	/**
+	 * Most recently published body list
+	 * Written only by the game thread; other threads copy it under BodyListLock, which is held
+	 * just for the pointer copy or swap
+	 */
+	mutable TSharedPtr<const FCelestialBodyList, ESPMode::ThreadSafe> PublishedBodyList;
+
+	/** Guards PublishedBodyList between the game thread's swap and other threads' copies */
+	mutable FCriticalSection BodyListLock;
+
 	/** Whether automatic updates are enabled */
 	UPROPERTY()
 	bool bAutoUpdateEnabled;
 
-	/** Update frequency for automatic scaling (seconds) */
+	/** Update frequency for automatic scaling of High priority bodies (seconds) */
 	UPROPERTY(EditDefaultsOnly, Category = "Celestial|Registry")
 	float AutoUpdateFrequency;
 
-	/** Time since last automatic update */
-	float TimeSinceLastUpdate;
-
 	// ========== Configuration ==========
 
 	/** Maximum number of bodies to process per frame for updates */
 	UPROPERTY(EditDefaultsOnly, Category = "Celestial|Registry|Performance")
 	int32 MaxBodiesPerFrame;
 
+	/** Time budget for scheduled scale updates per frame (milliseconds) */
+	UPROPERTY(EditDefaultsOnly, Category = "Celestial|Registry|Performance", meta = (ClampMin = "0.0"))
+	float ScaleUpdateBudgetMs;
+
+	/** Factor each priority below High waits longer between scale updates than the one above it */
+	UPROPERTY(EditDefaultsOnly, Category = "Celestial|Registry|Performance", meta = (ClampMin = "1.0"))
+	float ScaleUpdateIntervalGrowth;
+
+	/** Apparent size (radius over distance) from which a body is Critical; each lower priority starts at a tenth of the one above */
+	UPROPERTY(EditDefaultsOnly, Category = "Celestial|Registry|Performance", meta = (ClampMin = "0.0"))
+	float CriticalApparentSize;
+
 	/** Enable debug logging for registration operations */
 	UPROPERTY(EditDefaultsOnly, Category = "Celestial|Registry|Debug")
 	bool bEnableDebugLogging;
 
+	// ========== Scale Scheduling (game thread only) ==========
+
+	static constexpr int32 NumUpdatePriorities = 5;
+
+	/** Scheduling state for every body in ScheduledBodyList */
+	TArray<FCelestialScaleUpdateEntry> ScaleUpdateEntries;
+
+	/** Entry indices per priority, walked round-robin from the cursor */
+	TArray<int32> ScaleUpdateBins[NumUpdatePriorities];
+	int32 ScaleUpdateCursors[NumUpdatePriorities];
+
+	/** Body list the schedule was built from; a new published list means registration changed */
+	TSharedPtr<const FCelestialBodyList, ESPMode::ThreadSafe> ScheduledBodyList;
+
 	// ========== Internal Methods ==========
 
 	/** Validate a body component before registration */
 	bool IsValidBodyComponent(UCelestialBodyComponent* Body) const;
 
+	/** Free every slot so outstanding handles stop resolving (caller holds RegistryLock) */
+	void ReleaseAllBodySlots();
+
+	/** Re-read body positions into the spatial index unless already done this frame (caller holds RegistryLock) */
+	void RefitSpatialIndex() const;
+
+	/** Capture RegisteredBodies into a new body list and publish it (game thread, caller holds RegistryLock) */
+	void PublishBodyList() const;
+
+	/** Rebuild the scale schedule for a new body list, keeping the state of bodies still registered */
+	void SyncScaleSchedule(const FCelestialBodyList& BodyList);
+
+	/** Put a scale update entry at the end of a priority's bin */
+	void LinkScaleUpdateEntry(int32 EntryIndex, ECelestialUpdatePriority Priority);
+
+	/** Take a scale update entry out of its bin */
+	void UnlinkScaleUpdateEntry(int32 EntryIndex);
+
+	/** Update one body's scale and return the priority it should be scheduled at next */
+	ECelestialUpdatePriority UpdateScheduledBodyScale(FCelestialScaleUpdateEntry& Entry, const FVector& PlayerPosition, double Now) const;
+
 	/** Log registry statistics (for debugging) */
 	void LogRegistryStatistics() const;
 };
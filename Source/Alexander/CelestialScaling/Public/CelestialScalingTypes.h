@@ -5,6 +5,9 @@
 #include "CoreMinimal.h"
 #include "CelestialScalingTypes.generated.h"
 
+// Forward declarations
+class UCelestialBodyComponent;
+
 /**
  * Scaling mode for celestial bodies
  * Determines how bodies are rendered and positioned
@@ -192,3 +195,109 @@ struct ALEXANDER_API FCelestialLODConfig
 		, UpdateFrequency(30.0f)
 	{}
 };
+
+/**
+ * Keplerian orbital elements of a body relative to its parent
+ * Angles are in degrees; the reference plane is the world XY plane with +X as the reference direction
+ */
+USTRUCT(BlueprintType)
+struct ALEXANDER_API FKeplerOrbitElements
+{
+	GENERATED_BODY()
+
+	// Semi-major axis (Unreal units)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit", meta = (ClampMin = "0.0"))
+	double SemiMajorAxis = 0.0;
+
+	// Eccentricity (0 = circular; on-rails orbits must be elliptic)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit", meta = (ClampMin = "0.0", ClampMax = "0.99"))
+	double Eccentricity = 0.0;
+
+	// Inclination to the reference plane
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit", meta = (ClampMin = "0.0", ClampMax = "180.0"))
+	double Inclination = 0.0;
+
+	// Longitude of the ascending node
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit")
+	double LongitudeOfAscendingNode = 0.0;
+
+	// Argument of periapsis
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit")
+	double ArgumentOfPeriapsis = 0.0;
+
+	// Mean anomaly when the simulation starts
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orbit")
+	double MeanAnomalyAtEpoch = 0.0;
+
+	// Default constructor
+	FKeplerOrbitElements()
+		: SemiMajorAxis(0.0)
+		, Eccentricity(0.0)
+		, Inclination(0.0)
+		, LongitudeOfAscendingNode(0.0)
+		, ArgumentOfPeriapsis(0.0)
+		, MeanAnomalyAtEpoch(0.0)
+	{}
+};
+
+/**
+ * Stable reference to a body registered with the celestial body registry
+ * Index selects a registry slot and Generation must match the slot's, so a handle kept past
+ * unregistration never resolves to a body that later reuses the slot
+ */
+USTRUCT(BlueprintType)
+struct ALEXANDER_API FCelestialBodyHandle
+{
+	GENERATED_BODY()
+
+	// Registry slot (INDEX_NONE for the null handle)
+	UPROPERTY()
+	int32 Index = INDEX_NONE;
+
+	// Slot generation the handle was issued at
+	UPROPERTY()
+	uint32 Generation = 0;
+
+	FCelestialBodyHandle() = default;
+
+	FCelestialBodyHandle(int32 InIndex, uint32 InGeneration)
+		: Index(InIndex)
+		, Generation(InGeneration)
+	{}
+
+	/** Whether this handle was issued by the registry (it may still be stale) */
+	bool IsSet() const { return Index != INDEX_NONE; }
+
+	bool operator==(const FCelestialBodyHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+	bool operator!=(const FCelestialBodyHandle& Other) const { return !(*this == Other); }
+
+	friend uint32 GetTypeHash(const FCelestialBodyHandle& Handle)
+	{
+		return HashCombine(::GetTypeHash(Handle.Index), ::GetTypeHash(Handle.Generation));
+	}
+};
+
+/**
+ * Immutable list of registered bodies
+ * Captured when registration changes and shared by every reader until the next change
+ */
+struct FCelestialBodyList
+{
+	TArray<UCelestialBodyComponent*> Bodies;
+
+	/** Handle of each body, index-aligned with Bodies */
+	TArray<FCelestialBodyHandle> Handles;
+
+	/** Index into Bodies for each registry slot, INDEX_NONE for slots that were free */
+	TArray<int32> SlotIndices;
+
+	/** Registry generation the list was captured at; body indices are stable within it */
+	uint32 Generation = 0;
+
+	/** Index of a handle's body in this list, or INDEX_NONE if it was not registered when the list was captured */
+	int32 IndexOf(const FCelestialBodyHandle& Handle) const
+	{
+		const int32 Index = SlotIndices.IsValidIndex(Handle.Index) ? SlotIndices[Handle.Index] : INDEX_NONE;
+		return Index != INDEX_NONE && Handles[Index] == Handle ? Index : INDEX_NONE;
+	}
+};
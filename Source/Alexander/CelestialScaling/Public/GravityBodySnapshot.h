@@ -0,0 +1,202 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "CelestialScalingTypes.h"
+
+// Forward declarations
+class UCelestialBodyComponent;
+class FGravityOctree;
+class FGravitySOITree;
+enum class EGravitySimulationMode : uint8;
+
+/**
+ * Simulation settings captured together with the bodies
+ * Readers on any thread see one consistent set of settings for the whole query
+ */
+struct FGravitySimulationParams
+{
+	EGravitySimulationMode Mode{};
+	bool bGravityEnabled = true;
+	double MinGravityDistance = 100.0;
+	double PhysicsScaleFactor = 1.0;
+	float MaxGForce = 50.0f;
+	double BarnesHutOpeningAngle = 0.5;
+	double DominantBodyHysteresis = 0.05;
+
+	/** Evaluate forces with the order-independent fixed-point path (see GravityDeterministic) */
+	bool bDeterministic = false;
+
+	/** Sector the world origin sat in when the snapshot was published */
+	FIntVector OriginSector = FIntVector::ZeroValue;
+
+	/** Edge length of one virtual position sector (Unreal units); CelestialScalingConstants::VirtualSectorSize */
+	double SectorSize = 1000000.0;
+
+	/** Standard gravity (cm/s²), the unit of MaxGForce */
+	static constexpr double StandardGravity = 980.665;
+
+	/**
+	 * Limit an applied acceleration (cm/s²) to MaxGForce
+	 * The one gravity limit: live forces, server replay and trajectory prediction all clamp through it,
+	 * so they agree for receivers of any mass
+	 */
+	FVector ClampAcceleration(const FVector& Acceleration) const
+	{
+		return Acceleration.GetClampedToMaxSize(MaxGForce * StandardGravity);
+	}
+
+	/**
+	 * Kernel acceleration (Newtons per kg) to the applied acceleration in cm/s², scaled and limited as applied gravity is
+	 * @param GravityScale - Per-receiver multiplier, applied before the limit so no scale exceeds MaxGForce
+	 */
+	FVector ToAppliedAcceleration(const FVector& KernelAcceleration, double GravityScale = 1.0) const
+	{
+		return ClampAcceleration(KernelAcceleration * (PhysicsScaleFactor * 100.0 * GravityScale));
+	}
+
+	/**
+	 * Resolve a sector+offset position relative to the origin sector
+	 * Sector deltas are formed in integers and scaled in double, so precision depends only on
+	 * the distance from the origin sector, not on absolute sector coordinates
+	 */
+	FVector ResolveSectorPosition(const FIntVector& Sector, const FVector& LocalPosition) const
+	{
+		const FIntVector SectorDelta = Sector - OriginSector;
+		return FVector(
+			static_cast<double>(SectorDelta.X) * SectorSize + LocalPosition.X,
+			static_cast<double>(SectorDelta.Y) * SectorSize + LocalPosition.Y,
+			static_cast<double>(SectorDelta.Z) * SectorSize + LocalPosition.Z);
+	}
+};
+
+/**
+ * Last dominant body of one gravity receiver
+ * Revalidated against the SOI hierarchy each query instead of rescanning every body;
+ * the dominant body's SOI ancestors form its influence set
+ */
+struct FGravityDominantBodyCache
+{
+	/** Snapshot index of the cached dominant body, INDEX_NONE when unknown */
+	int32 BodyIndex = INDEX_NONE;
+
+	/** Registry generation the index refers to; after a registry change the index is found again from Body */
+	uint32 RegistryGeneration = 0;
+
+	/** Handle of the cached dominant body */
+	FCelestialBodyHandle Body;
+};
+
+/**
+ * Immutable per-frame view of all celestial bodies used by the gravity simulator
+ * Stored as structure-of-arrays so force queries read contiguous doubles
+ * instead of chasing component and actor pointers per body per target
+ * Published atomically by the game thread; never modified after publication
+ */
+struct ALEXANDER_API FGravityBodySnapshot
+{
+	/** Body positions in Unreal units, one array per axis */
+	TArray<double> PositionX;
+	TArray<double> PositionY;
+	TArray<double> PositionZ;
+
+	/** Body masses in kg */
+	TArray<double> Mass;
+
+	/** Precomputed gravitational parameter (G * Mass) */
+	TArray<double> GM;
+
+	/** Body surface radii in Unreal units, unaffected by visual scaling (UCelestialBodyComponent::GetPhysicalRadius) */
+	TArray<double> Radius;
+
+	/** Outer radius of each body's atmosphere in Unreal units; equal to Radius for airless bodies */
+	TArray<double> AtmosphereRadius;
+
+	/** 1 if the body was valid and massive when captured, 0 otherwise */
+	TArray<uint8> ValidMask;
+
+	/** Source components, index-aligned with the arrays above */
+	TArray<TWeakObjectPtr<UCelestialBodyComponent>> Bodies;
+
+	/** Settings in effect when the snapshot was published */
+	FGravitySimulationParams Params;
+
+	/** Barnes-Hut tree over the valid bodies, built only for large NBody scenes */
+	TSharedPtr<const FGravityOctree, ESPMode::ThreadSafe> Octree;
+
+	/** Sphere-of-influence hierarchy, shared between snapshots until bodies move significantly */
+	TSharedPtr<const FGravitySOITree, ESPMode::ThreadSafe> SOITree;
+
+	/** Engine frame this snapshot was captured on */
+	uint64 FrameNumber = 0;
+
+	/** Registry generation the body list was captured from; body indices are stable within one generation */
+	uint32 RegistryGeneration = 0;
+
+	/** Registry body list the snapshot was captured from; its indices match the snapshot's */
+	TSharedPtr<const FCelestialBodyList, ESPMode::ThreadSafe> BodyList;
+
+	/** Number of captured bodies (valid or not) */
+	int32 Num() const { return Bodies.Num(); }
+
+	/** Whether the body at Index contributes gravity */
+	bool IsValidIndex(int32 Index) const { return ValidMask.IsValidIndex(Index) && ValidMask[Index] != 0; }
+
+	/** Position of the body at Index */
+	FVector GetPosition(int32 Index) const { return FVector(PositionX[Index], PositionY[Index], PositionZ[Index]); }
+
+	/** Snapshot index of a body, or INDEX_NONE if it was not captured */
+	int32 IndexOf(const UCelestialBodyComponent* Body) const
+	{
+		return Bodies.IndexOfByPredicate([Body](const TWeakObjectPtr<UCelestialBodyComponent>& Captured)
+		{
+			return Captured.Get() == Body;
+		});
+	}
+
+	/** Snapshot index of a handle's body, or INDEX_NONE if it was not captured */
+	int32 IndexOf(const FCelestialBodyHandle& Handle) const
+	{
+		return BodyList.IsValid() ? BodyList->IndexOf(Handle) : INDEX_NONE;
+	}
+
+	/** Registry handle of the body at Index, unset if unknown */
+	FCelestialBodyHandle GetHandle(int32 Index) const
+	{
+		return BodyList.IsValid() && BodyList->Handles.IsValidIndex(Index) ? BodyList->Handles[Index] : FCelestialBodyHandle();
+	}
+
+	/** Clear all arrays and reserve room for the expected body count */
+	void Reset(int32 ExpectedNum)
+	{
+		PositionX.Reset(ExpectedNum);
+		PositionY.Reset(ExpectedNum);
+		PositionZ.Reset(ExpectedNum);
+		Mass.Reset(ExpectedNum);
+		GM.Reset(ExpectedNum);
+		Radius.Reset(ExpectedNum);
+		AtmosphereRadius.Reset(ExpectedNum);
+		ValidMask.Reset(ExpectedNum);
+		Bodies.Reset(ExpectedNum);
+		Octree.Reset();
+		SOITree.Reset();
+		BodyList.Reset();
+	}
+
+	/** Append one body; invalid bodies keep their slot with zero mass so indices stay stable */
+	void Add(UCelestialBodyComponent* Body, const FVector& Position, double BodyMass, double BodyRadius, double GravitationalConstant, bool bValid,
+		double BodyAtmosphereRadius = 0.0)
+	{
+		PositionX.Add(Position.X);
+		PositionY.Add(Position.Y);
+		PositionZ.Add(Position.Z);
+		Mass.Add(bValid ? BodyMass : 0.0);
+		GM.Add(bValid ? GravitationalConstant * BodyMass : 0.0);
+		Radius.Add(BodyRadius);
+		AtmosphereRadius.Add(FMath::Max(BodyRadius, BodyAtmosphereRadius));
+		ValidMask.Add(bValid ? 1 : 0);
+		Bodies.Add(Body);
+	}
+};
@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/EngineTypes.h"
+#include "GravityReceiverComponent.generated.h"
+
+// Forward declarations
+class UPrimitiveComponent;
+class UGravitySimulator;
+
+/**
+ * How the gravity simulator evaluates a receiver
+ */
+UENUM(BlueprintType)
+enum class EGravityReceiverMode : uint8
+{
+	/** Read the gravity field when lighter than the simulator's field mass threshold, otherwise evaluate exactly */
+	Automatic UMETA(DisplayName = "Automatic"),
+
+	/** Always evaluate the bodies exactly (important or precision-sensitive actors) */
+	Exact UMETA(DisplayName = "Exact"),
+
+	/** Read the gravity field whenever it covers the receiver, regardless of mass (debris, particles) */
+	Field UMETA(DisplayName = "Field")
+};
+
+/**
+ * Marks an actor as receiving gravity from the gravity simulator
+ * Registers the owner's physics primitive as a gravity target and caches what the simulator would
+ * otherwise look up per query: the primitive, its mass and the per-receiver settings. The mass is
+ * re-read only when the primitive's physics state changes, or when RefreshMass is called.
+ */
+UCLASS(ClassGroup=(CelestialScaling), meta=(BlueprintSpawnableComponent))
+class ALEXANDER_API UGravityReceiverComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGravityReceiverComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Mass used for gravity in kg; zero uses the physics body's mass */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity", meta = (ClampMin = "0.0"))
+	float MassOverride;
+
+	/** Multiplier on the gravitational force this receiver feels */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gravity", meta = (ClampMin = "0.0"))
+	float GravityScale;
+
+	/** How the simulator evaluates this receiver */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gravity")
+	EGravityReceiverMode ReceiverMode;
+
+	/**
+	 * Primitive gravity is applied to
+	 * Set before BeginPlay to pick a specific component; defaults to the root primitive or the first primitive found
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity")
+	TObjectPtr<UPrimitiveComponent> Primitive;
+
+	/**
+	 * Mass the simulator uses for this receiver (kg)
+	 * MassOverride if set, else the cached physics mass, else 1000 kg when nothing simulates physics
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Gravity")
+	float GetGravityMass() const { return MassOverride > 0.0f ? MassOverride : CachedMass; }
+
+	/** Set MassOverride (zero returns to the physics body's mass) */
+	UFUNCTION(BlueprintCallable, Category = "Gravity")
+	void SetMassOverride(float NewMassOverride);
+
+	/** Re-read the physics body's mass, e.g. after changing its mass scale or override directly */
+	UFUNCTION(BlueprintCallable, Category = "Gravity")
+	void RefreshMass();
+
+private:
+	/** Re-caches the mass whenever the physics body is created or destroyed */
+	UFUNCTION()
+	void OnPrimitivePhysicsStateChanged(UPrimitiveComponent* ChangedComponent, EComponentPhysicsStateChange StateChange);
+
+	/** Pick the primitive to receive gravity if none was assigned */
+	void ResolvePrimitive();
+
+	/** Physics mass as of the last refresh (kg) */
+	float CachedMass;
+
+	/** Simulator this receiver registered with */
+	TWeakObjectPtr<UGravitySimulator> Simulator;
+};
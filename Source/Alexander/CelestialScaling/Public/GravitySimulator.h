@@ -4,12 +4,26 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 #include "HAL/CriticalSection.h"
+#include "GravityBodySnapshot.h"
+#include <atomic>
 #include "GravitySimulator.generated.h"
 
 // Forward declarations
 class UCelestialBodyComponent;
+struct FCelestialBodyList;
+struct FVirtualPosition;
+class FGravityFieldClipmap;
+class FGravityOrbitIntegrator;
+struct FGravityOrbitParams;
+struct FGravityAdaptiveStepParams;
+class FGravityChebyshevEphemeris;
+class FGravityTrajectoryService;
+class FGravityDebugRenderer;
+struct FGravityTrajectoryContext;
 class UPrimitiveComponent;
+class UGravityReceiverComponent;
 class AActor;
 
 /**
@@ -31,13 +45,283 @@ enum class EGravitySimulationMode : uint8
 	Disabled UMETA(DisplayName = "Disabled")
 };
 
+/**
+ * Integrator used to advance celestial body orbits
+ */
+UENUM(BlueprintType)
+enum class EGravityOrbitIntegrator : uint8
+{
+	/** Kick-drift-kick leapfrog (second order, one force evaluation per step) */
+	Leapfrog UMETA(DisplayName = "Leapfrog"),
+
+	/** Yoshida composition of leapfrog (fourth order, three force evaluations per step) */
+	Yoshida4 UMETA(DisplayName = "Yoshida 4th Order"),
+
+	/** Embedded Runge-Kutta 4(5) with error-controlled substeps (accurate through close encounters, not symplectic) */
+	DormandPrince45 UMETA(DisplayName = "Dormand-Prince 4(5)")
+};
+
+/**
+ * Kind of event found along a predicted trajectory
+ */
+UENUM(BlueprintType)
+enum class EGravityTrajectoryEventType : uint8
+{
+	/** Closest point to a body whose sphere of influence the trajectory enters */
+	ClosestApproach UMETA(DisplayName = "Closest Approach"),
+
+	/** Trajectory meets a body's surface; the prediction ends here */
+	Impact UMETA(DisplayName = "Impact")
+};
+
+/**
+ * Kind of event detected for a gravity target during the fixed-rate gravity step
+ */
+UENUM(BlueprintType)
+enum class EGravityBodyEventType : uint8
+{
+	/** Target crossed a body's surface */
+	Impact UMETA(DisplayName = "Impact"),
+
+	/** Target crossed the top of a body's atmosphere inbound */
+	AtmosphereEntry UMETA(DisplayName = "Atmosphere Entry"),
+
+	/** Target's dominant body changed (sphere of influence boundary crossed) */
+	SOIChange UMETA(DisplayName = "SOI Change")
+};
+
+/**
+ * Event found along a predicted trajectory
+ */
+USTRUCT(BlueprintType)
+struct FGravityTrajectoryEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	EGravityTrajectoryEventType Type = EGravityTrajectoryEventType::ClosestApproach;
+
+	/** World time of the event (seconds) */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	double Time = 0.0;
+
+	/** Ship position at the event */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	FVector Position = FVector::ZeroVector;
+
+	/** Distance from the body centre (Unreal units) */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	double Distance = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	UCelestialBodyComponent* Body = nullptr;
+
+	/** Snapshot index of Body, resolved to the component on the game thread */
+	int32 BodyIndex = INDEX_NONE;
+};
+
+/**
+ * Completed trajectory prediction
+ */
+USTRUCT(BlueprintType)
+struct FGravityTrajectoryPrediction
+{
+	GENERATED_BODY()
+
+	/** Predicted positions, one per step starting at StartTime */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	TArray<FVector> Points;
+
+	/** Closest approaches and impact, ordered by time */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	TArray<FGravityTrajectoryEvent> Events;
+
+	/** World time of Points[0] (seconds) */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	double StartTime = 0.0;
+
+	/** Seconds between points */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	float StepSize = 0.0f;
+
+	/** Whether the trajectory ends on a body's surface */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	bool bImpact = false;
+
+	/** Points carried over from the previous prediction instead of integrated again */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	int32 NumReusedPoints = 0;
+
+	/** Gravity evaluations spent integrating the new points */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Trajectory")
+	int32 NumForceEvaluations = 0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGravityTrajectoryPredicted, int32, PredictionID, const FGravityTrajectoryPrediction&, Prediction);
+
+/**
+ * Impact, atmosphere entry or SOI change of one gravity target
+ */
+USTRUCT(BlueprintType)
+struct FGravityBodyEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Events")
+	EGravityBodyEventType Type = EGravityBodyEventType::Impact;
+
+	/** World time of the crossing, interpolated within the step (seconds) */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Events")
+	double Time = 0.0;
+
+	/** Target position at the crossing */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Events")
+	FVector Position = FVector::ZeroVector;
+
+	/** Target velocity over the step (Unreal units per second) */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Events")
+	FVector Velocity = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Events")
+	UPrimitiveComponent* Target = nullptr;
+
+	/** Body hit or entered; the new dominant body for SOI changes */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Events")
+	UCelestialBodyComponent* Body = nullptr;
+
+	/** Dominant body before an SOI change */
+	UPROPERTY(BlueprintReadOnly, Category = "Gravity|Events")
+	UCelestialBodyComponent* PreviousBody = nullptr;
+
+	/** Target and snapshot body indices, resolved to objects on the game thread */
+	int32 TargetIndex = INDEX_NONE;
+	int32 BodyIndex = INDEX_NONE;
+	int32 PreviousBodyIndex = INDEX_NONE;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGravityBodyEvents, const TArray<FGravityBodyEvent>&, Events);
+
+/**
+ * Fixed-rate gravity cache for one registered target
+ */
+struct FGravityReceiverState
+{
+	/** Force from the step before the latest one (Newtons) */
+	FVector PreviousForce = FVector::ZeroVector;
+
+	/** Force from the latest step (Newtons) */
+	FVector CurrentForce = FVector::ZeroVector;
+
+	/** Sum of step forces evaluated during the current frame */
+	FVector StepForceSum = FVector::ZeroVector;
+
+	/** Number of steps evaluated during the current frame */
+	int32 StepsThisFrame = 0;
+
+	/** Whether any step has been evaluated yet */
+	bool bHasForce = false;
+
+	/** Position and world time at the latest step, the start of the next event sweep */
+	FVector LastPosition = FVector::ZeroVector;
+	double LastTime = 0.0;
+	bool bHasPosition = false;
+
+	/** Registry generation the contact indices below refer to */
+	uint32 ContactGeneration = 0;
+
+	/** Snapshot indices of the bodies whose surface, atmosphere and SOI the target is in */
+	int32 SurfaceBody = INDEX_NONE;
+	int32 AtmosphereBody = INDEX_NONE;
+	int32 SOIBody = INDEX_NONE;
+
+	/** Dominant body revalidation for SOI change events */
+	FGravityDominantBodyCache SOICache;
+};
+
+/**
+ * Server-simulated kinematic state of one actor at one point in time
+ */
+struct FGravityStateSample
+{
+	/** Server time of the sample (seconds) */
+	double Timestamp = 0.0;
+
+	/** Position in Unreal units */
+	FVector Position = FVector::ZeroVector;
+
+	/** Velocity in Unreal units per second */
+	FVector Velocity = FVector::ZeroVector;
+};
+
+/**
+ * Fixed-size rewind history for one networked actor
+ * Samples are stored inline in a ring so recording and lookup never allocate
+ */
+struct FGravityStateHistory
+{
+	/** Samples kept per actor (about one second at a 30 Hz net rate) */
+	static constexpr int32 Capacity = 32;
+
+	/** Actor the history belongs to, INDEX_NONE for a free slot */
+	int32 ActorID = INDEX_NONE;
+
+	/** Slot the next sample is written to */
+	int32 Head = 0;
+
+	/** Number of valid samples */
+	int32 Count = 0;
+
+	FGravityStateSample Samples[Capacity];
+
+	/** Most recent sample; only valid when Count > 0 */
+	const FGravityStateSample& GetLatest() const { return Samples[(Head + Capacity - 1) % Capacity]; }
+
+	/** Append a sample, overwriting the oldest once full */
+	void Add(const FGravityStateSample& Sample)
+	{
+		Samples[Head] = Sample;
+		Head = (Head + 1) % Capacity;
+		Count = FMath::Min(Count + 1, Capacity);
+	}
+
+	/** Sample closest in time to Timestamp, or nullptr if empty */
+	const FGravityStateSample* FindNearest(double Timestamp) const
+	{
+		const FGravityStateSample* Nearest = nullptr;
+		double NearestDelta = TNumericLimits<double>::Max();
+
+		for (int32 Offset = 0; Offset < Count; ++Offset)
+		{
+			const FGravityStateSample& Sample = Samples[(Head + Capacity - 1 - Offset) % Capacity];
+			const double Delta = FMath::Abs(Sample.Timestamp - Timestamp);
+
+			if (Delta < NearestDelta)
+			{
+				NearestDelta = Delta;
+				Nearest = &Sample;
+			}
+		}
+
+		return Nearest;
+	}
+
+	/** Forget all samples and release the slot */
+	void Reset()
+	{
+		ActorID = INDEX_NONE;
+		Head = 0;
+		Count = 0;
+	}
+};
+
 /**
  * World subsystem for simulating gravitational forces
  * Handles multi-body gravitational calculations and physics integration
  * Network prediction with server validation
+ * Ticks once per frame to apply gravity to all registered targets in parallel
  */
 UCLASS()
-class ALEXANDER_API UGravitySimulator : public UWorldSubsystem
+class ALEXANDER_API UGravitySimulator : public UTickableWorldSubsystem
 {
 	GENERATED_BODY()
 
@@ -46,6 +330,8 @@ public:
 
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
 
 	// ========== Gravitational Force Calculation ==========
 
@@ -58,6 +344,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
 	FVector CalculateTotalGravitationalForce(AActor* Target, const FVector& TargetPosition) const;
 
+	/**
+	 * Calculate total gravitational forces on many targets in one call
+	 * Shares one body snapshot and one mode dispatch across the batch and evaluates
+	 * targets in SIMD lanes, for scenes with thousands of receivers
+	 * @param TargetPositions - Positions of the targets
+	 * @param TargetMasses - Masses of the targets in kg (same length as TargetPositions)
+	 * @param OutForces - Total gravitational force per target in Newtons
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	void CalculateGravitationalForcesBatch(const TArray<FVector>& TargetPositions, const TArray<float>& TargetMasses, TArray<FVector>& OutForces) const;
+
+	/**
+	 * Allocation-free variant of CalculateGravitationalForcesBatch for C++ callers owning their buffers
+	 * All three views must have the same length
+	 */
+	void CalculateGravitationalForces(TArrayView<const FVector> TargetPositions, TArrayView<const float> TargetMasses, TArrayView<FVector> OutForces) const;
+
 	/**
 	 * Calculate gravitational force from a specific celestial body
 	 * Uses F = G * (m1 * m2) / r²
@@ -80,13 +383,46 @@ public:
 
 	/**
 	 * Get the dominant gravitational body at a position
-	 * Returns the body with the strongest gravitational influence
+	 * Returns the deepest body in the SOI hierarchy whose sphere of influence contains the position
 	 * @param Position - Position to query
 	 * @return Dominant celestial body, or nullptr if none found
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
 	UCelestialBodyComponent* GetDominantGravitationalBody(const FVector& Position) const;
 
+	// ========== Large-World Positions ==========
+
+	/**
+	 * Calculate total gravitational force at a sector+offset position
+	 * The position is resolved against the origin sector in double precision, so targets
+	 * in distant sectors get stable forces without relying on float world coordinates
+	 * @param Position - Virtual position (sector coordinates plus local offset)
+	 * @param TargetMass - Mass of the target in kg
+	 * @return Total gravitational force vector in Newtons
+	 */
+	FVector CalculateGravitationalForceAtVirtualPosition(const FVirtualPosition& Position, float TargetMass) const;
+
+	/**
+	 * Convert a sector+offset position into the simulator's origin-relative frame (double precision)
+	 * @param Position - Virtual position (sector coordinates plus local offset)
+	 * @return Position relative to the current origin sector in Unreal units
+	 */
+	FVector VirtualToSimulationPosition(const FVirtualPosition& Position) const;
+
+	/**
+	 * Set the sector the world origin currently sits in
+	 * Call whenever the player origin manager recenters into a new sector
+	 * @param Sector - Sector coordinates of the world origin
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	void SetOriginSector(const FIntVector& Sector);
+
+	/**
+	 * Get the sector the world origin currently sits in
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	FIntVector GetOriginSector() const { return OriginSector; }
+
 	// ========== Physics Integration ==========
 
 	/**
@@ -106,6 +442,79 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
 	void ApplyGravityToComponent(UPrimitiveComponent* Component, float DeltaTime);
 
+	/**
+	 * Register a primitive to receive gravity every tick
+	 * Forces are evaluated at GravityUpdateFrequency on worker threads, cached per target,
+	 * and applied every frame in one pass (interpolated or held between steps)
+	 * @param Component - Physics-simulating primitive to affect
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	void RegisterGravityTarget(UPrimitiveComponent* Component);
+
+	/**
+	 * Stop applying gravity to a primitive each tick
+	 * @param Component - Previously registered primitive
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	void UnregisterGravityTarget(UPrimitiveComponent* Component);
+
+	/**
+	 * Get the number of primitives registered for automatic gravity
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	int32 GetGravityTargetCount() const { return GravityTargets.Num(); }
+
+	/**
+	 * Register a receiver component and its primitive as a gravity target
+	 * Called by UGravityReceiverComponent on BeginPlay; the receiver's cached mass, gravity scale and mode
+	 * then replace per-query component lookups for its owner
+	 * @param Receiver - Receiver to add
+	 */
+	void RegisterGravityReceiver(UGravityReceiverComponent* Receiver);
+
+	/**
+	 * Remove a receiver and stop applying gravity to its primitive
+	 * @param Receiver - Previously registered receiver
+	 */
+	void UnregisterGravityReceiver(UGravityReceiverComponent* Receiver);
+
+	/**
+	 * Get the registered receiver of an actor (game thread only; the registry is not synchronized)
+	 * @param Actor - Actor to look up
+	 * @return Receiver, or nullptr if the actor has none registered
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	UGravityReceiverComponent* FindGravityReceiver(const AActor* Actor) const;
+
+	/** Every registered receiver, for batch processing (entries may be stale during teardown) */
+	const TArray<TWeakObjectPtr<UGravityReceiverComponent>>& GetGravityReceivers() const { return GravityReceivers; }
+
+	/**
+	 * Get the cached fixed-rate force for a registered target without recomputing it
+	 * @param Component - Registered primitive
+	 * @return Force in Newtons as it would be applied this frame, or zero if not registered
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	FVector GetCachedGravitationalForce(UPrimitiveComponent* Component) const;
+
+	/**
+	 * Get the cached dominant body of a registered target from its latest gravity step
+	 * @param Component - Registered primitive
+	 * @return Dominant body, or nullptr if not registered, not yet evaluated, or invalidated by a registry change
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	UCelestialBodyComponent* GetCachedDominantBody(UPrimitiveComponent* Component) const;
+
+	/**
+	 * Sample the precomputed gravity field around the local player
+	 * Registered targets lighter than GravityFieldMassThreshold use this instead of an exact evaluation
+	 * @param Position - Position to sample
+	 * @param OutAcceleration - Interpolated acceleration (same units as CalculateGravitationalAcceleration)
+	 * @return False if the field is disabled or does not cover the position
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
+	bool SampleGravityField(const FVector& Position, FVector& OutAcceleration) const;
+
 	/**
 	 * Convert force in Newtons to Unreal force units
 	 * Unreal uses different force scaling
@@ -118,12 +527,14 @@ public:
 
 	/**
 	 * Clamp gravitational force to prevent extreme values
-	 * @param Force - Force vector to clamp
+	 * Limits the acceleration the force gives the target, the same limit applied to simulated gravity
+	 * @param Force - Force vector to clamp (Unreal force units)
+	 * @param TargetMass - Mass of the target in kg
 	 * @param MaxGForce - Maximum G-force allowed
 	 * @return Clamped force vector
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
-	FVector ClampGravitationalForce(const FVector& Force, float MaxGForce) const;
+	FVector ClampGravitationalForce(const FVector& Force, float TargetMass, float MaxGForce) const;
 
 	// ========== Sphere of Influence ==========
 
@@ -139,7 +550,7 @@ public:
 
 	/**
 	 * Calculate sphere of influence radius for a body
-	 * Uses Laplace sphere formula
+	 * Uses the Laplace sphere relative to the body's parent in the cached SOI hierarchy
 	 * @param Body - Celestial body
 	 * @return Sphere of influence radius in Unreal units
 	 */
@@ -150,11 +561,135 @@ public:
 	 * Get all bodies influencing a specific position
 	 * @param Position - Position to check
 	 * @param MaxBodies - Maximum number of bodies to return
-	 * @return Array of influencing bodies, sorted by influence strength
+	 * @return Dominant body followed by its SOI parents (influence order when no hierarchy is available)
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
 	TArray<UCelestialBodyComponent*> GetInfluencingBodies(const FVector& Position, int32 MaxBodies = 3) const;
 
+	// ========== Orbit Integration ==========
+
+	/**
+	 * Get the integrated velocity of a celestial body
+	 * @param Body - Celestial body
+	 * @return Velocity in Unreal units per second, zero if the body is not integrated
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	FVector GetBodyOrbitalVelocity(UCelestialBodyComponent* Body) const;
+
+	/**
+	 * Overwrite the integrated velocity of an orbiting body (e.g. after a scripted impulse)
+	 * @param Body - Celestial body with bSimulateOrbit set
+	 * @param Velocity - New velocity in Unreal units per second
+	 * @return False if the body is not moved by the integrator
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	bool SetBodyOrbitalVelocity(UCelestialBodyComponent* Body, const FVector& Velocity);
+
+	/**
+	 * Get the relative change in total orbital energy since the body set last changed
+	 * A healthy symplectic run stays bounded; steady growth means the step is too coarse
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	float GetOrbitEnergyDrift() const { return static_cast<float>(OrbitEnergyDrift); }
+
+	/**
+	 * Check whether a body is currently propagated analytically along its Kepler orbit
+	 * @param Body - Celestial body with bOnRails set
+	 * @return False if the body is integrated numerically (perturbed) or does not orbit
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	bool IsBodyOnRails(UCelestialBodyComponent* Body) const;
+
+	/**
+	 * Set the orbit time warp factor
+	 * Above 1, every on-rails body stays on rails and remaining numerical bodies take proportionally longer steps
+	 * @param TimeWarp - Simulated seconds per real second
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	void SetOrbitTimeWarp(float TimeWarp) { OrbitTimeWarp = FMath::Max(TimeWarp, 0.0f); }
+
+	/**
+	 * Get the orbit time warp factor
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	float GetOrbitTimeWarp() const { return OrbitTimeWarp; }
+
+	/**
+	 * Jump the orbit clock, e.g. to the persistent universe time after a server restart
+	 * Bodies read from the ephemeris or on rails move straight to their positions at that time;
+	 * numerically integrated bodies keep their current state
+	 * @param Time - Orbit simulation time in seconds
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	void SetOrbitSimulationTime(double Time);
+
+	/**
+	 * Get the orbit clock (seconds of simulated orbital motion, including time warp)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	double GetOrbitSimulationTime() const;
+
+	/**
+	 * Read bodies listed in a cooked Chebyshev ephemeris from it instead of integrating them
+	 * @param Filename - Table written by CookOrbitEphemeris; relative paths resolve against the project directory
+	 * @return False if the file could not be loaded
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	bool LoadOrbitEphemeris(const FString& Filename);
+
+	/**
+	 * Cook the orbits of bodies with a BodyID into a Chebyshev ephemeris, starting at the current orbit time
+	 * Integrates a copy of the current state forward; the live simulation is not affected
+	 * @param Filename - Output file; relative paths resolve against the project directory
+	 * @param Duration - Seconds of orbit time to cover
+	 * @param SegmentDuration - Seconds per Chebyshev segment
+	 * @param NumCoefficients - Series length per axis and segment
+	 * @return False if there is nothing to cook or the file could not be written
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Orbits")
+	bool CookOrbitEphemeris(const FString& Filename, double Duration, double SegmentDuration = 3600.0, int32 NumCoefficients = 12);
+
+	// ========== Trajectory Prediction ==========
+
+	/**
+	 * Request a trajectory prediction for a ship state
+	 * Runs on worker threads and never blocks; the result arrives through OnTrajectoryPredicted
+	 * or GetTrajectoryPrediction a frame or more later. A new request for an ID that is still
+	 * in flight replaces any older pending one. When the ship is still on its previous prediction,
+	 * the remaining points are reused and only the tail is integrated.
+	 * @param PredictionID - Caller-chosen key (e.g. ship actor ID)
+	 * @param Position - Current position in Unreal units
+	 * @param Velocity - Current velocity in Unreal units per second
+	 * @param NumSteps - Steps to predict, clamped to MaxTrajectorySteps
+	 * @param StepSize - Seconds per step
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Trajectory")
+	void RequestTrajectoryPrediction(int32 PredictionID, const FVector& Position, const FVector& Velocity, int32 NumSteps = 256, float StepSize = 0.1f);
+
+	/**
+	 * Get the latest completed prediction for an ID
+	 * @return False if no prediction has completed yet
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Trajectory")
+	bool GetTrajectoryPrediction(int32 PredictionID, FGravityTrajectoryPrediction& OutPrediction) const;
+
+	/**
+	 * Stop predicting for an ID and drop its last result
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Trajectory")
+	void CancelTrajectoryPrediction(int32 PredictionID);
+
+	/** Broadcast on the game thread when a prediction completes */
+	UPROPERTY(BlueprintAssignable, Category = "Celestial|Gravity|Trajectory")
+	FOnGravityTrajectoryPredicted OnTrajectoryPredicted;
+
+	/**
+	 * Broadcast once per frame on the game thread with every impact, atmosphere entry and SOI change
+	 * detected by this frame's gravity steps, in step order and grouped by target within a step
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Celestial|Gravity|Events")
+	FOnGravityBodyEvents OnGravityBodyEvents;
+
 	// ========== Configuration ==========
 
 	/**
@@ -176,14 +711,14 @@ public:
 	 * @param MaxG - Maximum G-force allowed
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
-	void SetMaxGForce(float MaxG) { MaxGForce = MaxG; }
+	void SetMaxGForce(float MaxG) { MaxGForce = MaxG; bSimulationStateDirty = true; }
 
 	/**
 	 * Enable or disable gravity simulation globally
 	 * @param bEnabled - Whether to enable gravity
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
-	void SetGravityEnabled(bool bEnabled) { bGravityEnabled = bEnabled; }
+	void SetGravityEnabled(bool bEnabled) { bGravityEnabled = bEnabled; bSimulationStateDirty = true; }
 
 	/**
 	 * Get whether gravity is enabled
@@ -192,21 +727,69 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity")
 	bool IsGravityEnabled() const { return bGravityEnabled; }
 
+	/**
+	 * Enable or disable deterministic gravity
+	 * Forces become a direct sum over all bodies with fixed-point accumulation, independent of body order
+	 * and thread count, and replays step on fixed-point grids; the gravity field cache is bypassed
+	 * @param bEnabled - Whether client and server must produce bit-identical gravity
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Network")
+	void SetDeterministicGravity(bool bEnabled) { bDeterministicGravity = bEnabled; bSimulationStateDirty = true; }
+
+	/**
+	 * Get whether deterministic gravity is enabled
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Network")
+	bool IsDeterministicGravity() const { return bDeterministicGravity; }
+
 	// ========== Network Prediction ==========
 
+	/**
+	 * Record the server-simulated state of an actor for later client validation
+	 * Call on the server at the net update rate; samples older than the latest one are ignored
+	 * @param ActorID - ID of the actor being simulated
+	 * @param Timestamp - Server time of the state (seconds)
+	 * @param Position - Server position
+	 * @param Velocity - Server velocity
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Network")
+	void RecordServerState(int32 ActorID, double Timestamp, const FVector& Position, const FVector& Velocity);
+
+	/**
+	 * Drop the rewind history of an actor (e.g. when its client disconnects)
+	 * @param ActorID - ID of the actor
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Network")
+	void ClearServerState(int32 ActorID);
+
 	/**
 	 * Server-side gravity calculation and validation
 	 * Clients predict locally, server validates and corrects
+	 * Replays gravity from the recorded server sample nearest the client timestamp and
+	 * corrects only when the client has drifted further than PredictionCorrectionThreshold
 	 * @param ActorID - ID of the actor being simulated
 	 * @param ClientPosition - Client's predicted position
 	 * @param ClientVelocity - Client's predicted velocity
 	 * @param OutCorrectedPosition - Server-corrected position
 	 * @param OutCorrectedVelocity - Server-corrected velocity
+	 * @param ClientTimestamp - Server time the client state refers to (negative = latest recorded sample)
 	 * @return True if correction was needed
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Network")
 	bool ValidateClientPrediction(int32 ActorID, const FVector& ClientPosition, const FVector& ClientVelocity,
-		FVector& OutCorrectedPosition, FVector& OutCorrectedVelocity);
+		FVector& OutCorrectedPosition, FVector& OutCorrectedVelocity, double ClientTimestamp = -1.0);
+
+	/**
+	 * Integrate a ship state under gravity exactly as server validation does
+	 * With deterministic gravity, a client calling this with the server's inputs gets the server's result bit for bit
+	 * @param Position - Start position
+	 * @param Velocity - Start velocity
+	 * @param Duration - Seconds to integrate
+	 * @param OutPosition - Position after Duration
+	 * @param OutVelocity - Velocity after Duration
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Network")
+	void ReplayGravityState(const FVector& Position, const FVector& Velocity, double Duration, FVector& OutPosition, FVector& OutVelocity) const;
 
 	// ========== Debug ==========
 
@@ -225,14 +808,36 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Debug")
 	void DrawGravityDebug(AActor* Target, float Duration = 0.0f) const;
 
+	/**
+	 * Frame queue shared by all gravity and celestial body debug drawing
+	 * Flushed once per tick within DebugMaxLinesPerFrame and DebugMaxLabels, nearest the view first
+	 */
+	FGravityDebugRenderer* GetDebugRenderer() const { return DebugRenderer.Get(); }
+
 	/**
 	 * Get simulation statistics
-	 * @param OutCalculationsPerFrame - Number of gravity calculations per frame
-	 * @param OutAverageCalculationTime - Average time per calculation in ms
+	 * @param OutCalculationsPerFrame - Average number of gravity calculations per frame
+	 * @param OutAverageCalculationTime - Average gravity calculation time per frame in ms
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Debug")
 	void GetSimulationStatistics(int32& OutCalculationsPerFrame, float& OutAverageCalculationTime) const;
 
+	/**
+	 * Get percentiles over the recent frame history (last StatisticsHistoryLength frames)
+	 * @param OutP50Time - Median calculation time per frame in ms
+	 * @param OutP99Time - 99th percentile calculation time per frame in ms
+	 * @param OutP50Calculations - Median calculations per frame
+	 * @param OutP99Calculations - 99th percentile calculations per frame
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Debug")
+	void GetSimulationPercentiles(float& OutP50Time, float& OutP99Time, int32& OutP50Calculations, int32& OutP99Calculations) const;
+
+	/**
+	 * Log averages, percentiles and current settings (console: Gravity.DumpStats)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Celestial|Gravity|Debug")
+	void DumpSimulationStatistics() const;
+
 protected:
 	// ========== Configuration Properties ==========
 
@@ -264,14 +869,156 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance")
 	bool bAutoDiscoverBodies;
 
-	/** Maximum distance for gravity influence (optimization) */
-	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance")
-	float MaxInfluenceDistance;
+	/** Sector the world origin currently sits in */
+	FIntVector OriginSector;
 
-	/** Update frequency for gravity calculations (Hz) */
+	/** Use a Barnes-Hut octree for N-body mode instead of summing every body exactly */
 	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance")
+	bool bUseBarnesHut;
+
+	/** Barnes-Hut opening angle (theta); smaller is more accurate, 0 is exact */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance", meta = (ClampMin = "0.0", ClampMax = "1.5"))
+	float BarnesHutOpeningAngle;
+
+	/** Minimum number of valid bodies before the octree is built */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance", meta = (ClampMin = "1"))
+	int32 BarnesHutMinBodies;
+
+	/** Fixed rate at which gravity is evaluated for registered targets (Hz) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance", meta = (ClampMin = "1.0"))
 	float GravityUpdateFrequency;
 
+	/** Maximum gravity steps evaluated in one frame when frame time spikes */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance", meta = (ClampMin = "1"))
+	int32 MaxGravitySubSteps;
+
+	/** Interpolate cached forces between steps (otherwise hold the latest step) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance")
+	bool bInterpolateGravity;
+
+	/** Apply gravity to registered targets from the subsystem tick */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance")
+	bool bAutoApplyGravity;
+
+	/** Fraction of an SOI radius a target must cross past the boundary before its cached dominant body changes */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance", meta = (ClampMin = "0.0", ClampMax = "0.5"))
+	float DominantBodyHysteresis;
+
+	/** Maintain a clipmap of acceleration grids around the local player for light targets */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Field")
+	bool bUseGravityField;
+
+	/** Registered targets below this mass (kg) sample the field; heavier ones are evaluated exactly (receivers may override per actor) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Field", meta = (ClampMin = "0.0"))
+	float GravityFieldMassThreshold;
+
+	/** Number of nested field levels; each doubles the cell size of the one inside it */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Field", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 GravityFieldLevels;
+
+	/** Nodes per axis per field level */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Field", meta = (ClampMin = "4", ClampMax = "64"))
+	int32 GravityFieldResolution;
+
+	/** Node spacing of the innermost field level (Unreal units) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Field", meta = (ClampMin = "1.0"))
+	float GravityFieldCellSize;
+
+	/** Field nodes refreshed per gravity step to follow body motion, on top of nodes scrolled in */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Field", meta = (ClampMin = "0"))
+	int32 GravityFieldRefreshBudget;
+
+	/** Move celestial bodies that opt in (bSimulateOrbit) under their mutual gravity */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Orbits")
+	bool bSimulateOrbits;
+
+	/** Integrator used for body orbits */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Orbits")
+	EGravityOrbitIntegrator OrbitIntegrationMethod;
+
+	/** Fixed rate at which body orbits are stepped (Hz) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Orbits", meta = (ClampMin = "1.0"))
+	float OrbitStepFrequency;
+
+	/** Maximum orbit steps in one frame when frame time spikes */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Orbits", meta = (ClampMin = "1"))
+	int32 MaxOrbitSubSteps;
+
+	/** Integrated positions are written to actors only once they differ by more than this (Unreal units) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Orbits", meta = (ClampMin = "0.0"))
+	float OrbitWriteBackTolerance;
+
+	/** Relative energy drift that triggers a warning */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Orbits", meta = (ClampMin = "0.0"))
+	float OrbitEnergyDriftWarning;
+
+	/** Cooked Chebyshev ephemeris loaded when orbits start; relative to the project directory, empty to integrate every body */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Orbits")
+	FString OrbitEphemerisFile;
+
+	/** On-rails bodies switch to numerical integration while a player or foreign body is inside this multiple of their SOI */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Orbits", meta = (ClampMin = "0.0"))
+	float OnRailsPerturbationScale;
+
+	/** Upper limit on steps per trajectory prediction */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Trajectory", meta = (ClampMin = "1"))
+	int32 MaxTrajectorySteps;
+
+	/** Ship position error tolerated when extending the previous prediction (Unreal units) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Trajectory", meta = (ClampMin = "0.0"))
+	float TrajectoryReusePositionTolerance;
+
+	/** Ship velocity error tolerated when extending the previous prediction (Unreal units per second) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Trajectory", meta = (ClampMin = "0.0"))
+	float TrajectoryReuseVelocityTolerance;
+
+	/**
+	 * Integrate trajectory predictions with adaptive Dormand-Prince steps instead of one Euler step per point
+	 * Points are interpolated from the adaptive steps, which grow far past the point spacing in cruise
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Trajectory")
+	bool bAdaptiveTrajectories;
+
+	/** Error allowed per adaptive step relative to each position and velocity component */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Adaptive Integration", meta = (ClampMin = "0.0"))
+	double AdaptiveRelativeTolerance;
+
+	/** Absolute error allowed per adaptive step (Unreal units, Unreal units per second for velocities) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Adaptive Integration", meta = (ClampMin = "0.0"))
+	double AdaptiveAbsoluteTolerance;
+
+	/** Longest adaptive step (seconds) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Adaptive Integration", meta = (ClampMin = "0.001"))
+	double AdaptiveMaxStepSize;
+
+	/**
+	 * Sweep every simulating target against body surfaces, atmospheres and SOIs each gravity step
+	 * Replaces overlap checks against planet-sized colliders; bodies are treated as stationary within a step
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Events")
+	bool bDetectBodyEvents;
+
+	/** Targets per worker task when computing forces in parallel */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Performance", meta = (ClampMin = "16"))
+	int32 ParallelBatchSize;
+
+	// ========== Network Prediction ==========
+
+	/** Compute gravity and replays with order-independent fixed-point arithmetic so client and server agree bit for bit */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Network")
+	bool bDeterministicGravity;
+
+	/** Client position error tolerated before a correction is sent (Unreal units) */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Network", meta = (ClampMin = "0.0"))
+	float PredictionCorrectionThreshold;
+
+	/** Maximum integration steps when replaying from a recorded sample */
+	UPROPERTY(EditDefaultsOnly, Category = "Gravity|Network", meta = (ClampMin = "1"))
+	int32 MaxPredictionReplaySteps;
+
+	/** Actors with rewind history; histories are preallocated and the stalest is reused when full */
+	static constexpr int32 MaxRewindActors = 64;
+
 	// ========== Debug ==========
 
 	/** Enable debug visualization */
@@ -286,39 +1033,267 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Debug")
 	FColor DebugForceColor;
 
+	/** Debug lines submitted per frame; the farthest shapes are dropped beyond this */
+	UPROPERTY(EditDefaultsOnly, Category = "Debug", meta = (ClampMin = "0"))
+	int32 DebugMaxLinesPerFrame;
+
+	/** Debug text labels drawn per frame, nearest first */
+	UPROPERTY(EditDefaultsOnly, Category = "Debug", meta = (ClampMin = "0"))
+	int32 DebugMaxLabels;
+
+	/** Debug primitives queued this frame */
+	TSharedPtr<FGravityDebugRenderer> DebugRenderer;
+
 	// ========== Statistics ==========
 
-	/** Number of gravity calculations this frame */
-	mutable int32 CalculationsThisFrame;
+	/** Number of gravity calculations this frame (incremented from any thread) */
+	mutable std::atomic<int32> CalculationsThisFrame;
+
+	/** Wall time spent in gravity calculations this frame (cycles, added from any thread) */
+	mutable std::atomic<uint64> CalculationCyclesThisFrame;
 
-	/** Total calculation time this frame (ms) */
-	mutable float TotalCalculationTime;
+	/** Total calculations over all completed frames */
+	std::atomic<int64> TotalCalculations;
+
+	/** Total calculation time over all completed frames (ms) */
+	std::atomic<float> TotalCalculationTime;
 
 	/** Frame counter for statistics */
-	mutable int32 FrameCounter;
+	std::atomic<int32> FrameCounter;
+
+	/** Frames kept for percentile statistics */
+	static constexpr int32 StatisticsHistoryLength = 256;
+
+	/** Per-frame calculation time ring (ms), game thread only */
+	TArray<float> FrameTimeHistory;
+
+	/** Per-frame calculation count ring, index-aligned with FrameTimeHistory */
+	TArray<int32> FrameCalculationHistory;
+
+	/** Next slot written in the history rings */
+	int32 StatisticsHistoryHead;
+
+	// ========== Gravity Targets ==========
+
+	/** Primitives receiving gravity every tick */
+	UPROPERTY()
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> GravityTargets;
+
+	/** Fixed-rate cache, index-aligned with GravityTargets */
+	TArray<FGravityReceiverState> GravityTargetStates;
+
+	/** Last dominant body per target, index-aligned with GravityTargets (contiguous so batches can hand out views) */
+	TArray<FGravityDominantBodyCache> GravityTargetDominantBodies;
+
+	/** Lookup key of each target, index-aligned with GravityTargets; still removable after the component is collected */
+	TArray<TObjectKey<UPrimitiveComponent>> GravityTargetKeys;
+
+	/** Component to index lookup for GravityTargets (object keys, so a new component at a collected one's address never matches) */
+	TMap<TObjectKey<UPrimitiveComponent>, int32> GravityTargetIndices;
+
+	/** Receiver that registered each target, index-aligned with GravityTargets (null for plain targets) */
+	TArray<TWeakObjectPtr<UGravityReceiverComponent>> GravityTargetReceivers;
+
+	/** Every registered receiver component */
+	TArray<TWeakObjectPtr<UGravityReceiverComponent>> GravityReceivers;
+
+	/** Owner to index lookup for GravityReceivers */
+	TMap<const AActor*, int32> GravityReceiverIndices;
+
+	/** Unsimulated time carried over to the next gravity step (seconds) */
+	double GravityTimeAccumulator;
+
+	/** Fraction of a step elapsed since the latest step, used for interpolation */
+	float GravityStepAlpha;
+
+	/** Per-tick scratch buffers, reused to avoid allocation */
+	TArray<FVector> TickPositions;
+	TArray<float> TickMasses;
+	TArray<FVector> TickForces;
+	TArray<float> TickGravityScales;
+
+	/** 1 where the step force came from the gravity field, 0 where it needs an exact evaluation */
+	TArray<uint8> TickFieldSampled;
+
+	/** Events found by each parallel batch, merged in batch order so the result is deterministic */
+	TArray<TArray<FGravityBodyEvent>> TickBatchEvents;
+
+	/** Events detected since the last broadcast */
+	TArray<FGravityBodyEvent> PendingBodyEvents;
+
+	// ========== Gravity Field ==========
+
+	/** Acceleration clipmap around the local player (game thread writes, workers never touch it) */
+	TSharedPtr<FGravityFieldClipmap> GravityField;
+
+	/** Whether the field was updated around a local player and may be sampled */
+	bool bGravityFieldReady;
+
+	// ========== Orbit Integration ==========
+
+	/** Dense body states advanced at OrbitStepFrequency (game thread only) */
+	TSharedPtr<FGravityOrbitIntegrator> OrbitIntegrator;
+
+	/** Unsimulated orbit time carried over to the next step (seconds) */
+	double OrbitTimeAccumulator;
+
+	/** Latest relative energy drift */
+	double OrbitEnergyDrift;
+
+	/** Loaded ephemeris table, shared with the integrator and trajectory workers */
+	TSharedPtr<const FGravityChebyshevEphemeris, ESPMode::ThreadSafe> OrbitEphemeris;
+
+	/** Simulated orbit seconds per real second */
+	float OrbitTimeWarp;
+
+	/** Player pawn positions gathered for rails perturbation checks, reused between frames */
+	TArray<FVector> OrbitProbePositions;
 
-	// ========== Thread Safety ==========
+	/** Whether the current drift excursion has already been reported */
+	bool bOrbitDriftWarned;
 
-	/** Lock for thread-safe calculations */
-	mutable FCriticalSection SimulationLock;
+	// ========== Trajectory Prediction ==========
+
+	/** In-flight and completed predictions (game thread only; tasks own their results until completion) */
+	TSharedPtr<FGravityTrajectoryService> TrajectoryService;
+
+	// ========== Rewind History ==========
+
+	/** Preallocated per-actor histories (MaxRewindActors slots) */
+	TArray<FGravityStateHistory> StateHistories;
+
+	/** ActorID to StateHistories index */
+	TMap<int32, int32> StateHistoryIndices;
+
+	// ========== Published Simulation State ==========
+
+	/**
+	 * Most recently published snapshot
+	 * Written only by the game thread; other threads copy it under SnapshotLock, which is held
+	 * just for the pointer copy or swap, never while a snapshot is built or released
+	 */
+	mutable TSharedPtr<const FGravityBodySnapshot, ESPMode::ThreadSafe> PublishedSnapshot;
+
+	/** Guards PublishedSnapshot between the game thread's swap and other threads' copies */
+	mutable FCriticalSection SnapshotLock;
+
+	/** Settings changed since the last publish (game thread only) */
+	mutable bool bSimulationStateDirty;
 
 	// ========== Internal Methods ==========
 
+	/** Calculate, scale, validate and count the force at one position in the snapshot's mode */
+	FVector CalculateForceAtPosition(const FGravityBodySnapshot& Snapshot, const FVector& TargetPosition, float TargetMass, float GravityScale = 1.0f) const;
+
 	/** Calculate force using single-body mode */
-	FVector CalculateSingleBodyGravity(const FVector& TargetPosition, float TargetMass) const;
+	FVector CalculateSingleBodyGravity(const FGravityBodySnapshot& Snapshot, const FVector& TargetPosition, float TargetMass) const;
 
 	/** Calculate force using multi-body mode */
-	FVector CalculateMultiBodyGravity(const FVector& TargetPosition, float TargetMass) const;
+	FVector CalculateMultiBodyGravity(const FGravityBodySnapshot& Snapshot, const FVector& TargetPosition, float TargetMass) const;
 
 	/** Calculate force using N-body mode */
-	FVector CalculateNBodyGravity(const FVector& TargetPosition, float TargetMass) const;
+	FVector CalculateNBodyGravity(const FGravityBodySnapshot& Snapshot, const FVector& TargetPosition, float TargetMass) const;
+
+	/** Close the statistics frame: fold per-frame counters into totals and the history rings */
+	void EndStatisticsFrame();
+
+	/** Advance orbiting bodies at the fixed orbit rate and write them back to their actors */
+	void StepOrbits(float DeltaTime);
+
+	/** Orbit force model matching the current settings */
+	FGravityOrbitParams GetOrbitParams() const;
+
+	/** Dormand-Prince error control matching the current settings */
+	FGravityAdaptiveStepParams GetAdaptiveStepParams() const;
+
+	/** Capture the snapshot, force model and orbit state a trajectory launch needs */
+	void FillTrajectoryContext(FGravityTrajectoryContext& OutContext) const;
+
+	/** Collect finished predictions, launch pending ones and broadcast results */
+	void UpdateTrajectoryPredictions();
+
+	/** Recentre and incrementally refresh the gravity field on the local player */
+	void UpdateGravityField();
+
+	/** Advance the fixed-rate scheduler, evaluating zero or more gravity steps */
+	void StepGravity(float DeltaTime);
+
+	/**
+	 * Evaluate forces for every registered target (parallel compute) and shift the cache
+	 * @param TimeOffset - Seconds relative to now at which the step falls due (targets are extrapolated)
+	 * @param bMissingOnly - Only evaluate targets without a force yet; the others keep their cache and event state untouched
+	 */
+	void EvaluateGravityStep(double TimeOffset, bool bMissingOnly = false);
+
+	/** Apply the cached force of every registered target in one game-thread pass */
+	void ApplyCachedGravity();
+
+	/**
+	 * Sweep each target from its previous step position to TickPositions (parallel) and queue crossings
+	 * @param StepTime - World time of the step being evaluated
+	 */
+	void DetectBodyEvents(const FGravityBodySnapshot& Snapshot, double StepTime);
+
+	/** Broadcast and clear the events queued by this frame's steps */
+	void BroadcastBodyEvents();
+
+	/** Submit queued debug primitives relative to the local player's view */
+	void FlushDebugDrawing();
+
+	/** Force to apply this frame for a cached receiver */
+	FVector SampleCachedForce(const FGravityReceiverState& State) const;
+
+	/** Remove a registered target, keeping the aligned arrays and lookup consistent */
+	void RemoveGravityTargetAt(int32 Index);
+
+	/** History slot for an actor, claiming a free or the stalest slot if it has none */
+	FGravityStateHistory& FindOrAddStateHistory(int32 ActorID);
+
+	/**
+	 * Integrate gravity forward (or backward for negative durations) from a recorded sample
+	 * @param Sample - Recorded server state to start from
+	 * @param Duration - Seconds to replay
+	 */
+	void ReplayServerState(const FGravityStateSample& Sample, double Duration, FVector& OutPosition, FVector& OutVelocity) const;
+
+	/**
+	 * Compute forces for a batch against an explicit snapshot
+	 * Safe to call from worker threads; does not touch statistics
+	 * @param DominantBodies - Optional per-target dominant-body caches, updated in place
+	 * @param GravityScales - Optional per-target receiver scales, applied before the g-limit
+	 */
+	void CalculateForcesFromSnapshot(const FGravityBodySnapshot& Snapshot, TArrayView<const FVector> TargetPositions,
+		TArrayView<const float> TargetMasses, TArrayView<FVector> OutForces,
+		TArrayView<FGravityDominantBodyCache> DominantBodies = TArrayView<FGravityDominantBodyCache>(),
+		TArrayView<const float> GravityScales = TArrayView<const float>()) const;
+
+	/** Get the registry's published body list for simulation (empty when auto-discovery is off) */
+	TSharedRef<const FCelestialBodyList, ESPMode::ThreadSafe> GetCelestialBodies() const;
+
+	/**
+	 * Get the most recently published body snapshot
+	 * On the game thread a stale snapshot is republished first; other threads copy the latest one under a brief lock
+	 */
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> GetBodySnapshot() const;
+
+	/** Build and atomically publish a new snapshot (game thread only) */
+	void PublishBodySnapshot() const;
+
+	/** Capture positions, masses and GM of all registered bodies */
+	TSharedRef<const FGravityBodySnapshot, ESPMode::ThreadSafe> BuildBodySnapshot() const;
+
+	/** Calculate force from a snapshot body (same model as CalculateGravityFromBody) */
+	FVector CalculateGravityFromSnapshotBody(const FGravityBodySnapshot& Snapshot, int32 BodyIndex, const FVector& TargetPosition, float TargetMass) const;
+
+	/** Calculate influence strength of a snapshot body at a position */
+	double CalculateInfluenceStrength(const FGravityBodySnapshot& Snapshot, int32 BodyIndex, const FVector& Position) const;
 
-	/** Get all celestial bodies for simulation */
-	TArray<UCelestialBodyComponent*> GetCelestialBodies() const;
+	/** Index of the dominant snapshot body at a position (SOI descent, else strongest influence), or INDEX_NONE */
+	int32 FindDominantBodyIndex(const FGravityBodySnapshot& Snapshot, const FVector& Position) const;
 
-	/** Calculate influence strength of a body at a position */
-	float CalculateInfluenceStrength(UCelestialBodyComponent* Body, const FVector& Position) const;
+	/** Indices of the dominant snapshot body and its SOI ancestors, falling back to strongest-first scoring */
+	void FindInfluencingBodyIndices(const FGravityBodySnapshot& Snapshot, const FVector& Position, int32 MaxBodies, TArray<int32, TInlineAllocator<8>>& OutIndices) const;
 
-	/** Validate and clamp force values */
-	FVector ValidateForce(const FVector& Force, float TargetMass) const;
+	/** Validate a force in Newtons, apply the receiver's GravityScale, and limit the acceleration it gives TargetMass to Params.MaxGForce */
+	FVector ValidateForce(const FVector& UnscaledForce, float TargetMass, const FGravitySimulationParams& Params, float GravityScale = 1.0f) const;
 };